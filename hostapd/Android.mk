@@ -144,6 +144,12 @@ ifdef CONFIG_ELOOP_EPOLL
 L_CFLAGS += -DCONFIG_ELOOP_EPOLL
 endif
 
+ifdef CONFIG_OS_POOL
+L_CFLAGS += -DCONFIG_OS_POOL
+OBJS += src/utils/os_pool.c
+HOBJS += src/utils/os_pool.c
+endif
+
 OBJS += src/utils/common.c
 OBJS += src/utils/wpa_debug.c
 OBJS += src/utils/wpabuf.c
@@ -1113,6 +1119,16 @@ ifdef CONFIG_DEBUG_FILE
 L_CFLAGS += -DCONFIG_DEBUG_FILE
 endif
 
+ifdef CONFIG_DEBUG_MIN_LEVEL
+L_CFLAGS += -DCONFIG_DEBUG_MIN_LEVEL=MSG_$(CONFIG_DEBUG_MIN_LEVEL)
+endif
+
+ifdef CONFIG_DEBUG_RINGBUF
+ifndef CONFIG_NO_STDOUT_DEBUG
+L_CFLAGS += -DCONFIG_DEBUG_RINGBUF
+endif
+endif
+
 ifdef CONFIG_ANDROID_LOG
 L_CFLAGS += -DCONFIG_ANDROID_LOG
 endif
@@ -1122,6 +1138,9 @@ OBJS_c += src/common/wpa_ctrl.c
 OBJS_c += src/utils/os_$(CONFIG_OS).c
 OBJS_c += src/common/cli.c
 OBJS_c += src/utils/eloop.c
+ifdef CONFIG_OS_POOL
+OBJS_c += src/utils/os_pool.c
+endif
 OBJS_c += src/utils/common.c
 ifdef CONFIG_WPA_TRACE
 OBJS_c += src/utils/trace.c
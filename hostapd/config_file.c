@@ -16,6 +16,7 @@
 #include "utils/crc32.h"
 #include "common/ieee802_11_defs.h"
 #include "common/sae.h"
+#include "crypto/crypto.h"
 #include "crypto/sha256.h"
 #include "crypto/tls.h"
 #include "drivers/driver.h"
@@ -115,6 +116,56 @@ static int hostapd_config_read_vlan_file(struct hostapd_bss_config *bss,
 
 	return 0;
 }
+
+
+static int hostapd_config_vlan_prewarm(struct hostapd_bss_config *bss,
+				       const char *val)
+{
+	int *list = NULL, *tmp, start, end, id;
+	size_t num = 0;
+	const char *pos = val;
+	char *end_pos;
+
+	/* Space separated list of VLAN IDs and ranges, e.g., "10-20 30" */
+	while (*pos) {
+		if (*pos == ' ') {
+			pos++;
+			continue;
+		}
+		start = end = strtol(pos, &end_pos, 10);
+		if (end_pos == pos)
+			goto fail;
+		pos = end_pos;
+		if (*pos == '-') {
+			pos++;
+			end = strtol(pos, &end_pos, 10);
+			if (end_pos == pos)
+				goto fail;
+			pos = end_pos;
+		}
+		if ((*pos && *pos != ' ') ||
+		    start < 1 || end > MAX_VLAN_ID || start > end)
+			goto fail;
+
+		tmp = os_realloc_array(list, num + end - start + 2,
+				       sizeof(int));
+		if (!tmp)
+			goto fail;
+		list = tmp;
+		for (id = start; id <= end; id++)
+			list[num++] = id;
+	}
+
+	if (list)
+		list[num] = 0;
+	os_free(bss->ssid.vlan_prewarm);
+	bss->ssid.vlan_prewarm = list;
+	return 0;
+
+fail:
+	os_free(list);
+	return -1;
+}
 #endif /* CONFIG_NO_VLAN */
 
 
@@ -2633,6 +2684,9 @@ static int hostapd_config_fill(struct hostapd_config *conf,
 		bss->crl_reload_interval = atoi(pos);
 	} else if (os_strcmp(buf, "tls_session_lifetime") == 0) {
 		bss->tls_session_lifetime = atoi(pos);
+	} else if (os_strcmp(buf, "tls_session_cache") == 0) {
+		os_free(bss->tls_session_cache);
+		bss->tls_session_cache = os_strdup(pos);
 	} else if (os_strcmp(buf, "tls_flags") == 0) {
 		bss->tls_flags = parse_tls_flags(pos);
 	} else if (os_strcmp(buf, "max_auth_rounds") == 0) {
@@ -3066,6 +3120,14 @@ static int hostapd_config_fill(struct hostapd_config *conf,
 				   line);
 			return 1;
 		}
+	} else if (os_strcmp(buf, "wpa_psk_cache") == 0) {
+		os_free(bss->ssid.wpa_psk_cache);
+		bss->ssid.wpa_psk_cache = os_strdup(pos);
+		if (!bss->ssid.wpa_psk_cache) {
+			wpa_printf(MSG_ERROR, "Line %d: allocation failed",
+				   line);
+			return 1;
+		}
 	} else if (os_strcmp(buf, "wpa_key_mgmt") == 0) {
 		bss->wpa_key_mgmt = hostapd_config_parse_key_mgmt(line, pos);
 		if (bss->wpa_key_mgmt == -1)
@@ -3512,6 +3574,22 @@ static int hostapd_config_fill(struct hostapd_config *conf,
 				   line, bss->ssid.vlan_naming);
 			return 1;
 		}
+	} else if (os_strcmp(buf, "vlan_prewarm") == 0) {
+		if (hostapd_config_vlan_prewarm(bss, pos)) {
+			wpa_printf(MSG_ERROR, "Line %d: invalid vlan_prewarm '%s'",
+				   line, pos);
+			return 1;
+		}
+	} else if (os_strcmp(buf, "vlan_remove_grace") == 0) {
+		int val = atoi(pos);
+
+		if (val < 0) {
+			wpa_printf(MSG_ERROR,
+				   "Line %d: invalid vlan_remove_grace %d",
+				   line, val);
+			return 1;
+		}
+		bss->ssid.vlan_remove_grace = val;
 #ifdef CONFIG_FULL_DYNAMIC_VLAN
 	} else if (os_strcmp(buf, "vlan_tagged_interface") == 0) {
 		os_free(bss->ssid.vlan_tagged_interface);
@@ -4983,6 +5061,68 @@ static int hostapd_config_fill(struct hostapd_config *conf,
 }
 
 
+/* Parameters that can be changed on configuration reload without having to
+ * disconnect the associated stations. The side files referenced here are read
+ * again as part of the reload and stations that they no longer allow are
+ * disconnected separately. */
+static const char * const hostapd_config_hot_params[] = {
+	"logger_syslog", "logger_syslog_level",
+	"logger_stdout", "logger_stdout_level",
+	"ap_max_inactivity", "skip_inactivity_poll", "max_num_sta",
+	"max_listen_interval", "bss_load_update_period",
+	"chan_util_avg_period", "config_id",
+	"accept_mac_file", "deny_mac_file", "wpa_psk_file", "wpa_psk_cache",
+	NULL
+};
+
+
+static int hostapd_config_hot_param(const char *name)
+{
+	int i;
+
+	for (i = 0; hostapd_config_hot_params[i]; i++) {
+		if (os_strcmp(name, hostapd_config_hot_params[i]) == 0)
+			return 1;
+	}
+
+	return 0;
+}
+
+
+static void hostapd_config_digest_add(struct wpabuf **buf, const char *name,
+				      const char *value)
+{
+	size_t len;
+
+	if (!*buf || hostapd_config_hot_param(name))
+		return;
+
+	len = os_strlen(name) + 1 + os_strlen(value) + 2;
+	if (wpabuf_resize(buf, len) < 0) {
+		wpabuf_free(*buf);
+		*buf = NULL;
+		return;
+	}
+	wpabuf_printf(*buf, "%s=%s\n", name, value);
+}
+
+
+static void hostapd_config_digest_set(struct hostapd_bss_config *bss,
+				      struct wpabuf *buf)
+{
+	const u8 *addr[1];
+	size_t len[1];
+
+	bss->config_digest_set = false;
+	if (!buf)
+		return;
+	addr[0] = (const u8 *) (wpabuf_len(buf) ? wpabuf_head(buf) : "");
+	len[0] = wpabuf_len(buf);
+	if (sha256_vector(1, addr, len, bss->config_digest) == 0)
+		bss->config_digest_set = true;
+}
+
+
 /**
  * hostapd_config_read - Read and parse a configuration file
  * @fname: Configuration file name (including path, if needed)
@@ -4996,6 +5136,7 @@ struct hostapd_config * hostapd_config_read(const char *fname)
 	int line = 0;
 	int errors = 0;
 	size_t i;
+	struct wpabuf *digest, *radio_digest = NULL;
 
 	f = fopen(fname, "r");
 	if (f == NULL) {
@@ -5020,6 +5161,7 @@ struct hostapd_config * hostapd_config_read(const char *fname)
 	}
 
 	conf->last_bss = conf->bss[0];
+	digest = wpabuf_alloc(1000);
 
 	while (fgets(buf, sizeof(buf), f)) {
 		struct hostapd_bss_config *bss;
@@ -5049,10 +5191,25 @@ struct hostapd_config * hostapd_config_read(const char *fname)
 		}
 		*pos = '\0';
 		pos++;
+		if (os_strcmp(buf, "bss") != 0)
+			hostapd_config_digest_add(&digest, buf, pos);
 		errors += hostapd_config_fill(conf, bss, buf, pos, line);
+		if (conf->last_bss != bss) {
+			/* New BSS started. The radio parameters are in the first
+			 * section and are included in the digest of every BSS. */
+			hostapd_config_digest_set(bss, digest);
+			if (bss == conf->bss[0])
+				radio_digest = digest;
+			else
+				wpabuf_free(digest);
+			digest = radio_digest ? wpabuf_dup(radio_digest) : NULL;
+		}
 	}
 
 	fclose(f);
+	hostapd_config_digest_set(conf->last_bss, digest);
+	wpabuf_free(digest);
+	wpabuf_free(radio_digest);
 
 	for (i = 0; i < conf->num_bss; i++)
 		hostapd_set_security_params(conf->bss[i], 1);
@@ -5080,6 +5237,10 @@ int hostapd_set_iface(struct hostapd_config *conf,
 	int errors;
 	size_t i;
 
+	/* Runtime changes are not reflected in the configuration file, so do
+	 * not allow a reload to skip disconnecting stations of this BSS */
+	bss->config_digest_set = false;
+
 	errors = hostapd_config_fill(conf, bss, field, value, 0);
 	if (errors) {
 		wpa_printf(MSG_INFO, "Failed to set configuration field '%s' "
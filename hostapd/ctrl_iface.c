@@ -62,7 +62,9 @@
 #include "ap/neighbor_db.h"
 #include "ap/rrm.h"
 #include "ap/dpp_hostapd.h"
+#include "ap/gas_serv.h"
 #include "ap/dfs.h"
+#include "ap/acs.h"
 #include "wps/wps_defs.h"
 #include "wps/wps.h"
 #include "fst/fst_ctrl_iface.h"
@@ -1303,6 +1305,13 @@ static int hostapd_ctrl_iface_set(struct hostapd_data *hapd, char *cmd)
 		if (ret)
 			return ret;
 
+		/* Probe Response frames are built from the configuration
+		 * without an explicit Beacon frame update */
+		hostapd_probe_resp_tmpl_invalidate();
+#ifdef CONFIG_INTERWORKING
+		gas_serv_anqp_cache_invalidate();
+#endif /* CONFIG_INTERWORKING */
+
 		if (os_strcasecmp(cmd, "deny_mac_file") == 0) {
 			hostapd_disassoc_deny_mac(hapd);
 		} else if (os_strcasecmp(cmd, "accept_mac_file") == 0) {
@@ -2892,6 +2901,24 @@ static int hostapd_ctrl_iface_mib(struct hostapd_data *hapd, char *reply,
 					     reply_size);
 	}
 #endif /* RADIUS_SERVER */
+#ifdef EAP_TLS_FUNCS
+	if (os_strcmp(param, "tls_session_cache") == 0 && hapd->ssl_ctx)
+		return tls_get_session_cache_stats(hapd->ssl_ctx, reply,
+						   reply_size);
+	if (os_strcmp(param, "tls_ocsp_stapling") == 0 && hapd->ssl_ctx)
+		return tls_get_ocsp_stapling_status(hapd->ssl_ctx, reply,
+						    reply_size);
+#endif /* EAP_TLS_FUNCS */
+#ifdef NEED_AP_MLME
+	if (os_strcmp(param, "probe_req_filter") == 0)
+		return hostapd_probe_req_filter_stats(hapd->iface, reply,
+						      reply_size);
+	if (os_strcmp(param, "radio_elems") == 0)
+		return hostapd_radio_elems_stats(hapd->iface, reply,
+						 reply_size);
+#endif /* NEED_AP_MLME */
+	if (os_strcmp(param, "acs") == 0)
+		return acs_scores(hapd->iface, reply, reply_size);
 	return -1;
 }
 
@@ -3531,6 +3558,17 @@ static int hostapd_ctrl_iface_receive_process(struct hostapd_data *hapd,
 			reply_len = -1;
 	} else if (os_strcmp(buf, "CLOSE_LOG") == 0) {
 		wpa_debug_stop_log();
+#ifdef CONFIG_DEBUG_RINGBUF
+	} else if (os_strcmp(buf, "DEBUG_RING_DUMP") == 0) {
+		if (wpa_debug_ring_dump() < 0)
+			reply_len = -1;
+	} else if (os_strcmp(buf, "DEBUG_RING_STATUS") == 0) {
+		reply_len = wpa_debug_ring_status(reply, reply_size);
+#endif /* CONFIG_DEBUG_RINGBUF */
+#ifdef CONFIG_OS_POOL
+	} else if (os_strcmp(buf, "MEMPOOL_STATS") == 0) {
+		reply_len = os_pool_stats(reply, reply_size);
+#endif /* CONFIG_OS_POOL */
 	} else if (os_strncmp(buf, "NOTE ", 5) == 0) {
 		wpa_printf(MSG_INFO, "NOTE: %s", buf + 5);
 	} else if (os_strcmp(buf, "STATUS") == 0) {
@@ -3955,6 +3993,16 @@ static int hostapd_ctrl_iface_receive_process(struct hostapd_data *hapd,
 			if (os_snprintf_error(reply_size, reply_len))
 				reply_len = -1;
 		}
+	} else if (os_strncmp(buf, "DPP_BOOTSTRAP_IMPORT ", 21) == 0) {
+		res = dpp_bootstrap_import(hapd->iface->interfaces->dpp,
+					   buf + 21);
+		if (res < 0) {
+			reply_len = -1;
+		} else {
+			reply_len = os_snprintf(reply, reply_size, "%d", res);
+			if (os_snprintf_error(reply_size, reply_len))
+				reply_len = -1;
+		}
 	} else if (os_strncmp(buf, "DPP_BOOTSTRAP_REMOVE ", 21) == 0) {
 		if (dpp_bootstrap_remove(hapd->iface->interfaces->dpp,
 					 buf + 21) < 0)
@@ -4936,6 +4984,17 @@ static void hostapd_global_ctrl_iface_receive(int sock, void *eloop_ctx,
 	} else if (os_strncmp(buf, "RELOG", 5) == 0) {
 		if (wpa_debug_reopen_file() < 0)
 			reply_len = -1;
+#ifdef CONFIG_DEBUG_RINGBUF
+	} else if (os_strcmp(buf, "DEBUG_RING_DUMP") == 0) {
+		if (wpa_debug_ring_dump() < 0)
+			reply_len = -1;
+	} else if (os_strcmp(buf, "DEBUG_RING_STATUS") == 0) {
+		reply_len = wpa_debug_ring_status(reply, reply_size);
+#endif /* CONFIG_DEBUG_RINGBUF */
+#ifdef CONFIG_OS_POOL
+	} else if (os_strcmp(buf, "MEMPOOL_STATS") == 0) {
+		reply_len = os_pool_stats(reply, reply_size);
+#endif /* CONFIG_OS_POOL */
 	} else if (os_strcmp(buf, "FLUSH") == 0) {
 		hostapd_ctrl_iface_flush(interfaces);
 	} else if (os_strncmp(buf, "ADD ", 4) == 0) {
@@ -259,6 +259,27 @@ static int hostapd_cli_cmd_close_log(struct wpa_ctrl *ctrl, int argc,
 }
 
 
+static int hostapd_cli_cmd_debug_ring_dump(struct wpa_ctrl *ctrl, int argc,
+					   char *argv[])
+{
+	return wpa_ctrl_command(ctrl, "DEBUG_RING_DUMP");
+}
+
+
+static int hostapd_cli_cmd_debug_ring_status(struct wpa_ctrl *ctrl, int argc,
+					     char *argv[])
+{
+	return wpa_ctrl_command(ctrl, "DEBUG_RING_STATUS");
+}
+
+
+static int hostapd_cli_cmd_mempool_stats(struct wpa_ctrl *ctrl, int argc,
+					 char *argv[])
+{
+	return wpa_ctrl_command(ctrl, "MEMPOOL_STATS");
+}
+
+
 static int hostapd_cli_cmd_status(struct wpa_ctrl *ctrl, int argc, char *argv[])
 {
 	if (argc > 0 && os_strcmp(argv[0], "driver") == 0)
@@ -1423,6 +1444,13 @@ static int hostapd_cli_cmd_dpp_bootstrap_gen(struct wpa_ctrl *ctrl, int argc,
 }
 
 
+static int hostapd_cli_cmd_dpp_bootstrap_import(struct wpa_ctrl *ctrl, int argc,
+						char *argv[])
+{
+	return hostapd_cli_cmd(ctrl, "DPP_BOOTSTRAP_IMPORT", 1, argc, argv);
+}
+
+
 static int hostapd_cli_cmd_dpp_bootstrap_remove(struct wpa_ctrl *ctrl, int argc,
 						char *argv[])
 {
@@ -1646,6 +1674,12 @@ static const struct hostapd_cli_cmd hostapd_cli_commands[] = {
 	  "= reload/truncate debug log output file" },
 	{ "close_log", hostapd_cli_cmd_close_log, NULL,
 	  "= disable debug log output file" },
+	{ "debug_ring_dump", hostapd_cli_cmd_debug_ring_dump, NULL,
+	  "= write debug ring buffer contents to the log output" },
+	{ "debug_ring_status", hostapd_cli_cmd_debug_ring_status, NULL,
+	  "= show debug ring buffer status" },
+	{ "mempool_stats", hostapd_cli_cmd_mempool_stats, NULL,
+	  "= show memory pool statistics" },
 	{ "status", hostapd_cli_cmd_status, NULL,
 	  "= show interface status info" },
 	{ "sta", hostapd_cli_cmd_sta, hostapd_complete_stations,
@@ -1782,6 +1816,8 @@ static const struct hostapd_cli_cmd hostapd_cli_commands[] = {
 	  "report a scanned DPP URI from a QR Code" },
 	{ "dpp_bootstrap_gen", hostapd_cli_cmd_dpp_bootstrap_gen, NULL,
 	  "type=<qrcode> [chan=..] [mac=..] [info=..] [curve=..] [key=..] = generate DPP bootstrap information" },
+	{ "dpp_bootstrap_import", hostapd_cli_cmd_dpp_bootstrap_import, NULL,
+	  "<file> = import DPP URIs (one per line) as peer bootstrap information" },
 	{ "dpp_bootstrap_remove", hostapd_cli_cmd_dpp_bootstrap_remove, NULL,
 	  "*|<id> = remove DPP bootstrap information" },
 	{ "dpp_bootstrap_get_uri", hostapd_cli_cmd_dpp_bootstrap_get_uri, NULL,
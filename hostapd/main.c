@@ -582,6 +582,9 @@ static void usage(void)
 		"usage: hostapd [-hdBKtvq] [-P <PID file>] [-e <entropy file>] "
 		"\\\n"
 		"         [-g <global ctrl_iface>] [-G <group>]\\\n"
+#ifdef CONFIG_DEBUG_RINGBUF
+		"         [-R <ring buffer size in kB> [-F]]\\\n"
+#endif /* CONFIG_DEBUG_RINGBUF */
 		"         [-i <comma-separated list of interface names>]\\\n"
 		"         <configuration file(s)>\n"
 		"\n"
@@ -601,6 +604,12 @@ static void usage(void)
 		"   -T   record to Linux tracing in addition to logging\n"
 		"        (records all messages regardless of debug verbosity)\n"
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RINGBUF
+		"   -R   buffer debug messages in an in-memory ring buffer of the\n"
+		"        given size (kB) and write them out from the event loop\n"
+		"   -F   keep ring buffer messages of all debug levels until\n"
+		"        DEBUG_RING_DUMP (flight recorder mode)\n"
+#endif /* CONFIG_DEBUG_RINGBUF */
 		"   -i   list of interface names to use\n"
 #ifdef CONFIG_DEBUG_SYSLOG
 		"   -s   log output to syslog instead of stdout\n"
@@ -749,6 +758,22 @@ static void hostapd_periodic(void *eloop_ctx, void *timeout_ctx)
 }
 
 
+#ifdef CONFIG_DEBUG_RINGBUF
+
+#ifndef HOSTAPD_DEBUG_RING_FLUSH_INTERVAL_MS
+#define HOSTAPD_DEBUG_RING_FLUSH_INTERVAL_MS 1000
+#endif /* HOSTAPD_DEBUG_RING_FLUSH_INTERVAL_MS */
+
+static void hostapd_debug_ring_flush(void *eloop_ctx, void *timeout_ctx)
+{
+	eloop_register_timeout(0, HOSTAPD_DEBUG_RING_FLUSH_INTERVAL_MS * 1000,
+			       hostapd_debug_ring_flush, NULL, NULL);
+	wpa_debug_ring_flush();
+}
+
+#endif /* CONFIG_DEBUG_RINGBUF */
+
+
 int main(int argc, char *argv[])
 {
 	struct hapd_interfaces interfaces;
@@ -763,6 +788,9 @@ int main(int argc, char *argv[])
 #ifdef CONFIG_DEBUG_LINUX_TRACING
 	int enable_trace_dbg = 0;
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RINGBUF
+	int debug_ring_size = 0, debug_ring_flight = 0;
+#endif /* CONFIG_DEBUG_RINGBUF */
 	int start_ifaces_in_sync = 0;
 	char **if_names = NULL;
 	size_t if_names_size = 0;
@@ -799,7 +827,7 @@ int main(int argc, char *argv[])
 #endif /* CONFIG_DPP */
 
 	for (;;) {
-		c = getopt(argc, argv, "b:Bde:f:hi:KP:sSTtu:vg:G:q");
+		c = getopt(argc, argv, "b:Bde:f:Fhi:KP:R:sSTtu:vg:G:q");
 		if (c < 0)
 			break;
 		switch (c) {
@@ -835,6 +863,16 @@ int main(int argc, char *argv[])
 			enable_trace_dbg = 1;
 			break;
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RINGBUF
+		case 'R':
+			debug_ring_size = atoi(optarg);
+			if (debug_ring_size <= 0)
+				usage();
+			break;
+		case 'F':
+			debug_ring_flight = 1;
+			break;
+#endif /* CONFIG_DEBUG_RINGBUF */
 		case 'v':
 			show_version();
 			exit(1);
@@ -904,6 +942,13 @@ int main(int argc, char *argv[])
 		}
 	}
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (debug_ring_size &&
+	    wpa_debug_ring_init(debug_ring_size * 1024, debug_ring_flight)) {
+		wpa_printf(MSG_ERROR, "Failed to enable debug ring buffer");
+		return -1;
+	}
+#endif /* CONFIG_DEBUG_RINGBUF */
 
 	interfaces.count = argc - optind;
 	if (interfaces.count || num_bss_configs) {
@@ -922,6 +967,13 @@ int main(int argc, char *argv[])
 
 	eloop_register_timeout(HOSTAPD_CLEANUP_INTERVAL, 0,
 			       hostapd_periodic, &interfaces, NULL);
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (debug_ring_size && !debug_ring_flight)
+		eloop_register_timeout(0,
+				       HOSTAPD_DEBUG_RING_FLUSH_INTERVAL_MS *
+				       1000,
+				       hostapd_debug_ring_flush, NULL, NULL);
+#endif /* CONFIG_DEBUG_RINGBUF */
 
 	if (fst_global_init()) {
 		wpa_printf(MSG_ERROR,
@@ -1033,11 +1085,18 @@ int main(int argc, char *argv[])
 	dpp_global_deinit(interfaces.dpp);
 #endif /* CONFIG_DPP */
 
-	if (interfaces.eloop_initialized)
+	if (interfaces.eloop_initialized) {
 		eloop_cancel_timeout(hostapd_periodic, &interfaces, NULL);
+#ifdef CONFIG_DEBUG_RINGBUF
+		eloop_cancel_timeout(hostapd_debug_ring_flush, NULL, NULL);
+#endif /* CONFIG_DEBUG_RINGBUF */
+	}
 	hostapd_global_deinit(pid_file, interfaces.eloop_initialized);
 	os_free(pid_file);
 
+#ifdef CONFIG_DEBUG_RINGBUF
+	wpa_debug_ring_deinit();
+#endif /* CONFIG_DEBUG_RINGBUF */
 	wpa_debug_close_syslog();
 	if (log_file)
 		wpa_debug_close_file();
@@ -1052,6 +1111,8 @@ int main(int argc, char *argv[])
 	fst_global_deinit();
 
 	crypto_unload();
+	wpabuf_arena_deinit();
+	os_pool_flush();
 	os_program_deinit();
 
 	return ret;
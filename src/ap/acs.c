@@ -39,7 +39,8 @@
  * ----------------
  * 1. passive scans are used to collect survey data
  *    (it is assumed that scan trigger collection of survey data in driver)
- * 2. interference factor is calculated for each channel
+ * 2. interference factor is calculated for each channel (the surveys from
+ *    each scan are processed as they arrive)
  * 3. ideal channel is picked depending on channel width by using adjacent
  *    channel interference factors
  *
@@ -339,6 +340,9 @@ static void acs_cleanup_mode(struct hostapd_hw_modes *mode)
 		chan->flag |= HOSTAPD_CHAN_SURVEY_LIST_INITIALIZED;
 		chan->min_nf = 0;
 		chan->punct_bitmap = 0;
+		chan->acs_factor_sum = 0;
+		chan->acs_num_factors = 0;
+		chan->acs_num_surveys = 0;
 	}
 }
 
@@ -352,6 +356,8 @@ void acs_cleanup(struct hostapd_iface *iface)
 
 	iface->chans_surveyed = 0;
 	iface->acs_num_completed_scans = 0;
+	os_free(iface->acs_chan_idx);
+	iface->acs_chan_idx = NULL;
 }
 
 
@@ -394,43 +400,86 @@ acs_survey_interference_factor(struct freq_survey *survey, s8 min_nf)
 }
 
 
-static void
-acs_survey_chan_interference_factor(struct hostapd_iface *iface,
-				    struct hostapd_channel_data *chan)
+/*
+ * Add the interference factors of the survey entries received since the
+ * previous call to the running sum of the channel. The factors depend on the
+ * lowest noise floor of the interface, so the sum is rebuilt from the full
+ * survey list if that has changed since the earlier entries were processed.
+ */
+static void acs_survey_chan_update(struct hostapd_iface *iface,
+				   struct hostapd_channel_data *chan)
 {
 	struct freq_survey *survey;
 	unsigned int i = 0;
-	long double int_factor = 0;
-	unsigned count = 0;
-
-	if (dl_list_empty(&chan->survey_list) ||
-	    (chan->flag & HOSTAPD_CHAN_DISABLED))
-		return;
+	long double int_factor;
 
-	chan->interference_factor = 0;
+	if (chan->acs_num_surveys && chan->acs_factor_nf != iface->lowest_nf) {
+		chan->acs_factor_sum = 0;
+		chan->acs_num_factors = 0;
+		chan->acs_num_surveys = 0;
+	}
+	chan->acs_factor_nf = iface->lowest_nf;
 
 	dl_list_for_each(survey, &chan->survey_list, struct freq_survey, list)
 	{
-		i++;
+		if (++i <= chan->acs_num_surveys)
+			continue;
 
 		if (!acs_survey_is_sufficient(survey)) {
 			wpa_printf(MSG_DEBUG, "ACS: %d: insufficient data", i);
 			continue;
 		}
 
-		count++;
+		chan->acs_num_factors++;
 		int_factor = acs_survey_interference_factor(survey,
 							    iface->lowest_nf);
-		chan->interference_factor += int_factor;
-		wpa_printf(MSG_DEBUG, "ACS: %d: min_nf=%d interference_factor=%Lg nf=%d time=%lu busy=%lu rx=%lu",
-			   i, chan->min_nf, int_factor,
+		chan->acs_factor_sum += int_factor;
+		wpa_printf(MSG_DEBUG, "ACS: %d (%d MHz): min_nf=%d interference_factor=%Lg nf=%d time=%lu busy=%lu rx=%lu",
+			   i, chan->freq, chan->min_nf, int_factor,
 			   survey->nf, (unsigned long) survey->channel_time,
 			   (unsigned long) survey->channel_time_busy,
 			   (unsigned long) survey->channel_time_rx);
 	}
 
-	if (count)
-		chan->interference_factor /= count;
+	chan->acs_num_surveys = i;
+}
+
+
+static void acs_survey_all_chans_update(struct hostapd_iface *iface)
+{
+	int i, j;
+	struct hostapd_hw_modes *mode;
+	struct hostapd_channel_data *chan;
+
+	for (i = 0; i < iface->num_hw_features; i++) {
+		mode = &iface->hw_features[i];
+		if (hostapd_hw_skip_mode(iface, mode))
+			continue;
+
+		for (j = 0; j < mode->num_channels; j++) {
+			chan = &mode->channels[j];
+			if (!dl_list_empty(&chan->survey_list) &&
+			    !(chan->flag & HOSTAPD_CHAN_DISABLED))
+				acs_survey_chan_update(iface, chan);
+		}
+	}
+}
+
+
+static void
+acs_survey_chan_interference_factor(struct hostapd_iface *iface,
+				    struct hostapd_channel_data *chan)
+{
+	if (dl_list_empty(&chan->survey_list) ||
+	    (chan->flag & HOSTAPD_CHAN_DISABLED))
+		return;
+
+	acs_survey_chan_update(iface, chan);
+
+	chan->interference_factor = chan->acs_factor_sum;
+	if (chan->acs_num_factors)
+		chan->interference_factor /= chan->acs_num_factors;
+	chan->acs_scored = true;
 }
 
 
@@ -492,30 +541,16 @@ static int acs_survey_is_sufficient(struct freq_survey *survey)
 }
 
 
+/* acs_survey_all_chans_update() must have been called for the current survey
+ * data before this */
 static int acs_survey_list_is_sufficient(struct hostapd_channel_data *chan)
 {
-	struct freq_survey *survey;
-	int ret = -1;
-
-	dl_list_for_each(survey, &chan->survey_list, struct freq_survey, list)
-	{
-		if (acs_survey_is_sufficient(survey)) {
-			ret = 1;
-			break;
-		}
-		ret = 0;
-	}
-
-	if (ret == -1)
-		ret = 1; /* no survey list entries */
-
-	if (!ret) {
-		wpa_printf(MSG_INFO,
-			   "ACS: Channel %d has insufficient survey data",
-			   chan->chan);
-	}
+	if (dl_list_empty(&chan->survey_list) || chan->acs_num_factors)
+		return 1;
 
-	return ret;
+	wpa_printf(MSG_INFO, "ACS: Channel %d has insufficient survey data",
+		   chan->chan);
+	return 0;
 }
 
 
@@ -588,6 +623,7 @@ static void acs_survey_mode_interference_factor(
 
 	for (i = 0; i < mode->num_channels; i++) {
 		chan = &mode->channels[i];
+		chan->acs_scored = false;
 
 		if (!acs_usable_chan(chan))
 			continue;
@@ -674,6 +710,64 @@ acs_find_mode(struct hostapd_iface *iface, int freq)
 }
 
 
+/* Frequency range covered by the ACS channel lookup table; other frequencies
+ * are searched from the channel lists of the modes. */
+#define ACS_CHAN_IDX_MIN_FREQ 2400
+#define ACS_CHAN_IDX_MAX_FREQ 7200
+#define ACS_CHAN_IDX_LEN \
+	((ACS_CHAN_IDX_MAX_FREQ - ACS_CHAN_IDX_MIN_FREQ) / 5 + 1)
+
+static bool acs_chan_idx_freq(int freq)
+{
+	return freq >= ACS_CHAN_IDX_MIN_FREQ &&
+		freq <= ACS_CHAN_IDX_MAX_FREQ && freq % 5 == 0;
+}
+
+
+/*
+ * Build a frequency indexed table of the enabled channels so that the
+ * adjacent channel lookups done for each candidate primary channel and
+ * bandwidth do not need to search through all the modes.
+ */
+static void acs_chan_idx_build(struct hostapd_iface *iface)
+{
+	struct hostapd_channel_data **idx, *chan;
+	struct hostapd_hw_modes *mode;
+	int i, j, pos;
+
+	os_free(iface->acs_chan_idx);
+	idx = os_calloc(ACS_CHAN_IDX_LEN, sizeof(*idx));
+	iface->acs_chan_idx = idx;
+	if (!idx)
+		return;
+
+	for (i = 0; i < iface->num_hw_features; i++) {
+		mode = &iface->hw_features[i];
+		if (hostapd_hw_skip_mode(iface, mode))
+			continue;
+
+		for (j = 0; j < mode->num_channels; j++) {
+			chan = &mode->channels[j];
+			if ((chan->flag & HOSTAPD_CHAN_DISABLED) ||
+			    !acs_chan_idx_freq(chan->freq))
+				continue;
+
+			/* Same priority order as the search over the modes */
+			pos = (chan->freq - ACS_CHAN_IDX_MIN_FREQ) / 5;
+			if (!idx[pos])
+				idx[pos] = chan;
+		}
+	}
+}
+
+
+static void acs_chan_idx_free(struct hostapd_iface *iface)
+{
+	os_free(iface->acs_chan_idx);
+	iface->acs_chan_idx = NULL;
+}
+
+
 static struct hostapd_channel_data *
 acs_find_chan(struct hostapd_iface *iface, int freq)
 {
@@ -681,6 +775,9 @@ acs_find_chan(struct hostapd_iface *iface, int freq)
 	struct hostapd_hw_modes *mode;
 	struct hostapd_channel_data *chan;
 
+	if (iface->acs_chan_idx && acs_chan_idx_freq(freq))
+		return iface->acs_chan_idx[(freq - ACS_CHAN_IDX_MIN_FREQ) / 5];
+
 	for (i = 0; i < iface->num_hw_features; i++) {
 		mode = &iface->hw_features[i];
 		if (!hostapd_hw_skip_mode(iface, mode)) {
@@ -1124,6 +1221,7 @@ bw_selected:
 	wpa_printf(MSG_DEBUG,
 		   "ACS: Survey analysis for selected bandwidth %d MHz", bw);
 
+	acs_chan_idx_build(iface);
 	for (i = 0; i < iface->num_hw_features; i++) {
 		mode = &iface->hw_features[i];
 		if (!hostapd_hw_skip_mode(iface, mode))
@@ -1131,6 +1229,7 @@ bw_selected:
 						 &rand_chan, &ideal_chan,
 						 &ideal_factor);
 	}
+	acs_chan_idx_free(iface);
 
 	if (ideal_chan) {
 		wpa_printf(MSG_DEBUG, "ACS: Ideal channel is %d (%d MHz) with total interference factor of %Lg",
@@ -1233,6 +1332,7 @@ static int acs_study_survey_based(struct hostapd_iface *iface)
 		return -1;
 	}
 
+	acs_survey_all_chans_update(iface);
 	if (!acs_surveys_are_sufficient(iface)) {
 		wpa_printf(MSG_ERROR, "ACS: Surveys have insufficient data");
 		return -1;
@@ -1327,6 +1427,10 @@ static void acs_scan_complete(struct hostapd_iface *iface)
 		goto fail;
 	}
 
+	/* Process the new survey data while waiting for the next scan to keep
+	 * the final study short */
+	acs_survey_all_chans_update(iface);
+
 	if (++iface->acs_num_completed_scans < iface->conf->acs_num_scans) {
 		err = acs_request_scan(iface);
 		if (err) {
@@ -1433,6 +1537,34 @@ static int acs_request_scan(struct hostapd_iface *iface)
 }
 
 
+int acs_scores(struct hostapd_iface *iface, char *buf, size_t buflen)
+{
+	struct hostapd_hw_modes *mode;
+	struct hostapd_channel_data *chan;
+	char *pos = buf, *end = buf + buflen;
+	int i, j, ret;
+
+	for (i = 0; i < iface->num_hw_features; i++) {
+		mode = &iface->hw_features[i];
+		for (j = 0; j < mode->num_channels; j++) {
+			chan = &mode->channels[j];
+			if (!chan->acs_scored)
+				continue;
+
+			ret = os_snprintf(pos, end - pos,
+					  "freq=%d chan=%d interference_factor=%Lg\n",
+					  chan->freq, chan->chan,
+					  chan->interference_factor);
+			if (os_snprintf_error(end - pos, ret))
+				return pos - buf;
+			pos += ret;
+		}
+	}
+
+	return pos - buf;
+}
+
+
 enum hostapd_chan_status acs_init(struct hostapd_iface *iface)
 {
 	int err;
@@ -14,6 +14,7 @@
 
 enum hostapd_chan_status acs_init(struct hostapd_iface *iface);
 void acs_cleanup(struct hostapd_iface *iface);
+int acs_scores(struct hostapd_iface *iface, char *buf, size_t buflen);
 
 #else /* CONFIG_ACS */
 
@@ -27,6 +28,12 @@ static inline void acs_cleanup(struct hostapd_iface *iface)
 {
 }
 
+static inline int acs_scores(struct hostapd_iface *iface, char *buf,
+			     size_t buflen)
+{
+	return 0;
+}
+
 #endif /* CONFIG_ACS */
 
 #endif /* ACS_H */
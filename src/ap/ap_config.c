@@ -7,8 +7,13 @@
  */
 
 #include "utils/includes.h"
+#ifndef CONFIG_NATIVE_WINDOWS
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif /* CONFIG_NATIVE_WINDOWS */
 
 #include "utils/common.h"
+#include "crypto/crypto.h"
 #include "crypto/sha1.h"
 #include "crypto/tls.h"
 #include "radius/radius_client.h"
@@ -312,8 +317,296 @@ int hostapd_mac_comp(const void *a, const void *b)
 }
 
 
+struct hostapd_psk_cache_entry {
+	u8 id[SHA256_MAC_LEN]; /* SHA256(SSID length | SSID | passphrase) */
+	u8 psk[PMK_LEN];
+	bool used; /* needed for the current configuration */
+};
+
+struct hostapd_psk_cache {
+	const char *fname;
+	struct hostapd_psk_cache_entry *entries;
+	size_t num;
+	bool added;
+};
+
+
+static void hostapd_psk_cache_init(struct hostapd_psk_cache *cache,
+				   const char *fname)
+{
+#ifndef CONFIG_NATIVE_WINDOWS
+	FILE *f;
+	int fd;
+	struct stat st;
+	char buf[2 * SHA256_MAC_LEN + 1 + 2 * PMK_LEN + 2];
+	struct hostapd_psk_cache_entry *e, *n;
+	int line = 0;
+#endif /* CONFIG_NATIVE_WINDOWS */
+
+	os_memset(cache, 0, sizeof(*cache));
+	if (!fname)
+		return;
+
+#ifdef CONFIG_NATIVE_WINDOWS
+	wpa_printf(MSG_INFO, "PSK cache not supported on this platform");
+#else /* CONFIG_NATIVE_WINDOWS */
+	cache->fname = fname;
+	fd = open(fname, O_RDONLY | O_NOFOLLOW);
+	if (fd < 0) {
+		if (errno == ENOENT)
+			return; /* Created when the first PSK is added */
+		wpa_printf(MSG_ERROR, "Could not open PSK cache '%s': %s",
+			   fname, strerror(errno));
+		cache->fname = NULL;
+		return;
+	}
+	if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) ||
+	    (st.st_mode & (S_IRWXG | S_IRWXO))) {
+		wpa_printf(MSG_ERROR,
+			   "PSK cache '%s' is not a regular file accessible only by its owner - ignore it",
+			   fname);
+		close(fd);
+		cache->fname = NULL;
+		return;
+	}
+	f = fdopen(fd, "r");
+	if (!f) {
+		close(fd);
+		cache->fname = NULL;
+		return;
+	}
+
+	while (fgets(buf, sizeof(buf), f)) {
+		line++;
+		if (buf[0] == '#' || buf[0] == '\n')
+			continue;
+		n = os_realloc_array(cache->entries, cache->num + 1,
+				     sizeof(*e));
+		if (!n)
+			break;
+		cache->entries = n;
+		e = &cache->entries[cache->num];
+		e->used = false;
+		if (os_strlen(buf) < sizeof(buf) - 2 ||
+		    hexstr2bin(buf, e->id, SHA256_MAC_LEN) < 0 ||
+		    buf[2 * SHA256_MAC_LEN] != ' ' ||
+		    hexstr2bin(&buf[2 * SHA256_MAC_LEN + 1], e->psk,
+			       PMK_LEN) < 0) {
+			wpa_printf(MSG_INFO,
+				   "Invalid entry on line %d in PSK cache '%s'",
+				   line, fname);
+			continue;
+		}
+		cache->num++;
+	}
+	forced_memzero(buf, sizeof(buf));
+	fclose(f);
+
+	wpa_printf(MSG_DEBUG, "Loaded %zu entries from PSK cache '%s'",
+		   cache->num, fname);
+#endif /* CONFIG_NATIVE_WINDOWS */
+}
+
+
+static void hostapd_psk_cache_deinit(struct hostapd_psk_cache *cache)
+{
+	bin_clear_free(cache->entries, cache->num * sizeof(*cache->entries));
+	cache->entries = NULL;
+	cache->num = 0;
+}
+
+
+static void hostapd_psk_cache_add(struct hostapd_psk_cache *cache,
+				  const u8 *id, const u8 *psk)
+{
+	struct hostapd_psk_cache_entry *n;
+
+	n = os_realloc_array(cache->entries, cache->num + 1, sizeof(*n));
+	if (!n)
+		return;
+	cache->entries = n;
+	os_memcpy(n[cache->num].id, id, SHA256_MAC_LEN);
+	os_memcpy(n[cache->num].psk, psk, PMK_LEN);
+	n[cache->num].used = true;
+	cache->num++;
+	cache->added = true;
+}
+
+
+/* Replace the PSK cache file with the entries that were used for the current
+ * configuration so that PSKs of removed passphrases do not accumulate. */
+static void hostapd_psk_cache_write(struct hostapd_psk_cache *cache)
+{
+#ifndef CONFIG_NATIVE_WINDOWS
+	char buf[2 * SHA256_MAC_LEN + 1 + 2 * PMK_LEN + 2];
+	char *tmp;
+	size_t i, len, tmp_len;
+	int fd;
+	bool ok = true;
+
+	if (!cache->fname)
+		return;
+	if (!cache->added) {
+		for (i = 0; i < cache->num; i++) {
+			if (!cache->entries[i].used)
+				break;
+		}
+		if (i == cache->num)
+			return; /* No changes */
+	}
+
+	tmp_len = os_strlen(cache->fname) + 5;
+	tmp = os_malloc(tmp_len);
+	if (!tmp)
+		return;
+	os_snprintf(tmp, tmp_len, "%s.tmp", cache->fname);
+
+	/* Do not follow or reuse an existing file in place of the temporary
+	 * file to avoid writing the PSKs to a location set up by someone
+	 * else. */
+	unlink(tmp);
+	fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW,
+		  S_IRUSR | S_IWUSR);
+	if (fd < 0) {
+		wpa_printf(MSG_INFO, "Could not create PSK cache '%s': %s",
+			   tmp, strerror(errno));
+		os_free(tmp);
+		return;
+	}
+
+	for (i = 0; ok && i < cache->num; i++) {
+		struct hostapd_psk_cache_entry *e = &cache->entries[i];
+
+		if (!e->used)
+			continue;
+		wpa_snprintf_hex(buf, sizeof(buf), e->id, SHA256_MAC_LEN);
+		buf[2 * SHA256_MAC_LEN] = ' ';
+		wpa_snprintf_hex(&buf[2 * SHA256_MAC_LEN + 1],
+				 sizeof(buf) - 2 * SHA256_MAC_LEN - 1, e->psk,
+				 PMK_LEN);
+		len = os_strlen(buf);
+		buf[len++] = '\n';
+		if (write(fd, buf, len) != (ssize_t) len)
+			ok = false;
+	}
+	forced_memzero(buf, sizeof(buf));
+	if (close(fd) < 0)
+		ok = false;
+
+	/* rename() replaces the old file atomically so that a failure or
+	 * a concurrent reader never sees a partially written cache. */
+	if (!ok || rename(tmp, cache->fname) < 0) {
+		wpa_printf(MSG_INFO, "Could not write PSK cache '%s'",
+			   cache->fname);
+		unlink(tmp);
+	} else {
+		wpa_printf(MSG_DEBUG, "Wrote PSK cache '%s'", cache->fname);
+	}
+	os_free(tmp);
+#endif /* CONFIG_NATIVE_WINDOWS */
+}
+
+
+/* Maximum number of passphrases derived with a single pbkdf2_sha1_mb() call */
+#define HOSTAPD_PSK_BATCH 16
+
+/* Derive PSKs from passphrases. The PSK cache, if enabled, is used to avoid
+ * running PBKDF2 again for the same SSID and passphrase. The remaining
+ * passphrases are derived together to allow them to be processed in parallel.
+ */
+static int hostapd_psk_from_passphrases(struct hostapd_psk_cache *cache,
+					size_t num, const char *passphrase[],
+					const u8 *ssid, size_t ssid_len,
+					u8 *psk[])
+{
+	u8 id[HOSTAPD_PSK_BATCH][SHA256_MAC_LEN];
+	const char *derive[HOSTAPD_PSK_BATCH];
+	u8 *derive_psk[HOSTAPD_PSK_BATCH];
+	size_t derive_idx[HOSTAPD_PSK_BATCH];
+	u8 ssid_len_u8 = ssid_len;
+	const u8 *addr[3];
+	size_t len[3];
+	size_t i, j, num_derive = 0;
+	bool use_cache = cache && cache->fname;
+
+	if (num > HOSTAPD_PSK_BATCH)
+		return -1;
+
+	for (i = 0; i < num; i++) {
+		if (use_cache) {
+			addr[0] = &ssid_len_u8;
+			len[0] = 1;
+			addr[1] = ssid;
+			len[1] = ssid_len;
+			addr[2] = (const u8 *) passphrase[i];
+			len[2] = os_strlen(passphrase[i]);
+			if (sha256_vector(3, addr, len, id[i]) < 0)
+				return -1;
+
+			for (j = 0; j < cache->num; j++) {
+				if (os_memcmp(cache->entries[j].id, id[i],
+					      SHA256_MAC_LEN) == 0)
+					break;
+			}
+			if (j < cache->num) {
+				os_memcpy(psk[i], cache->entries[j].psk,
+					  PMK_LEN);
+				cache->entries[j].used = true;
+				continue;
+			}
+		}
+
+		derive[num_derive] = passphrase[i];
+		derive_psk[num_derive] = psk[i];
+		derive_idx[num_derive] = i;
+		num_derive++;
+	}
+
+	if (!num_derive)
+		return 0;
+	if (pbkdf2_sha1_mb(num_derive, derive, ssid, ssid_len, 4096,
+			   derive_psk, PMK_LEN) < 0)
+		return -1;
+	for (i = 0; use_cache && i < num_derive; i++)
+		hostapd_psk_cache_add(cache, id[derive_idx[i]], derive_psk[i]);
+	return 0;
+}
+
+
+/*
+ * Derive the PSKs of the pending passphrase entries and move all pending
+ * entries to the PSK list of the SSID. The entries are kept out of the list
+ * until then so that an error cannot leave entries with an all-zero PSK in
+ * use.
+ */
+static int hostapd_wpa_psk_add_pending(struct hostapd_ssid *ssid,
+				       struct hostapd_psk_cache *cache,
+				       struct hostapd_wpa_psk **pending,
+				       size_t num_batch, const char **batch,
+				       u8 **batch_psk)
+{
+	struct hostapd_wpa_psk *psk;
+
+	if (!*pending)
+		return 0;
+
+	if (num_batch &&
+	    hostapd_psk_from_passphrases(cache, num_batch, batch, ssid->ssid,
+					 ssid->ssid_len, batch_psk) < 0)
+		return -1;
+
+	for (psk = *pending; psk->next; psk = psk->next)
+		;
+	psk->next = ssid->wpa_psk;
+	ssid->wpa_psk = *pending;
+	*pending = NULL;
+	return 0;
+}
+
+
 static int hostapd_config_read_wpa_psk(const char *fname,
-				       struct hostapd_ssid *ssid)
+				       struct hostapd_ssid *ssid,
+				       struct hostapd_psk_cache *cache)
 {
 	FILE *f;
 	char buf[128], *pos;
@@ -324,8 +617,13 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 	char *name;
 	char *value;
 	int line = 0, ret = 0, len, ok;
+	bool passphrase;
 	u8 addr[ETH_ALEN];
-	struct hostapd_wpa_psk *psk;
+	struct hostapd_wpa_psk *psk, *pending = NULL;
+	char batch_passphrase[HOSTAPD_PSK_BATCH][64];
+	const char *batch[HOSTAPD_PSK_BATCH];
+	u8 *batch_psk[HOSTAPD_PSK_BATCH];
+	size_t i, num_batch = 0;
 
 	if (!fname)
 		return 0;
@@ -336,6 +634,9 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 		return -1;
 	}
 
+	for (i = 0; i < HOSTAPD_PSK_BATCH; i++)
+		batch[i] = batch_passphrase[i];
+
 	while (fgets(buf, sizeof(buf), f)) {
 		int vlan_id = 0;
 		int wps = 0;
@@ -417,14 +718,17 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 		}
 
 		ok = 0;
+		passphrase = false;
 		len = os_strlen(pos);
 		if (len == 2 * PMK_LEN &&
-		    hexstr2bin(pos, psk->psk, PMK_LEN) == 0)
+		    hexstr2bin(pos, psk->psk, PMK_LEN) == 0) {
 			ok = 1;
-		else if (len >= 8 && len < 64 &&
-			 pbkdf2_sha1(pos, ssid->ssid, ssid->ssid_len,
-				     4096, psk->psk, PMK_LEN) == 0)
+		} else if (len >= 8 && len < 64) {
+			/* PSKs are derived from passphrases in batches */
+			os_memcpy(batch_passphrase[num_batch], pos, len + 1);
+			passphrase = true;
 			ok = 1;
+		}
 		if (!ok) {
 			wpa_printf(MSG_ERROR,
 				   "Invalid PSK '%s' on line %d in '%s'",
@@ -448,9 +752,36 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 
 		psk->wps = wps;
 
-		psk->next = ssid->wpa_psk;
-		ssid->wpa_psk = psk;
+		psk->next = pending;
+		pending = psk;
+
+		if (passphrase) {
+			batch_psk[num_batch++] = psk->psk;
+			if (num_batch == HOSTAPD_PSK_BATCH) {
+				if (hostapd_wpa_psk_add_pending(
+					    ssid, cache, &pending, num_batch,
+					    batch, batch_psk) < 0) {
+					wpa_printf(MSG_ERROR,
+						   "Failed to derive PSKs from passphrases in '%s'",
+						   fname);
+					ret = -1;
+					break;
+				}
+				num_batch = 0;
+			}
+		}
+	}
+
+	if (ret == 0 &&
+	    hostapd_wpa_psk_add_pending(ssid, cache, &pending, num_batch,
+					batch, batch_psk) < 0) {
+		wpa_printf(MSG_ERROR,
+			   "Failed to derive PSKs from passphrases in '%s'",
+			   fname);
+		ret = -1;
 	}
+	hostapd_config_clear_wpa_psk(&pending);
+	forced_memzero(batch_passphrase, sizeof(batch_passphrase));
 
 	fclose(f);
 
@@ -458,8 +789,12 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 }
 
 
-static int hostapd_derive_psk(struct hostapd_ssid *ssid)
+static int hostapd_derive_psk(struct hostapd_ssid *ssid,
+			      struct hostapd_psk_cache *cache)
 {
+	const char *passphrase = ssid->wpa_passphrase;
+	u8 *psk;
+
 	ssid->wpa_psk = os_zalloc(sizeof(struct hostapd_wpa_psk));
 	if (ssid->wpa_psk == NULL) {
 		wpa_printf(MSG_ERROR, "Unable to alloc space for PSK");
@@ -470,9 +805,9 @@ static int hostapd_derive_psk(struct hostapd_ssid *ssid)
 	wpa_hexdump_ascii_key(MSG_DEBUG, "PSK (ASCII passphrase)",
 			      (u8 *) ssid->wpa_passphrase,
 			      os_strlen(ssid->wpa_passphrase));
-	if (pbkdf2_sha1(ssid->wpa_passphrase,
-			ssid->ssid, ssid->ssid_len,
-			4096, ssid->wpa_psk->psk, PMK_LEN) != 0) {
+	psk = ssid->wpa_psk->psk;
+	if (hostapd_psk_from_passphrases(cache, 1, &passphrase, ssid->ssid,
+					 ssid->ssid_len, &psk) != 0) {
 		wpa_printf(MSG_ERROR, "Error in pbkdf2_sha1()");
 		return -1;
 	}
@@ -527,10 +862,14 @@ int hostapd_setup_sae_pt(struct hostapd_bss_config *conf)
 int hostapd_setup_wpa_psk(struct hostapd_bss_config *conf)
 {
 	struct hostapd_ssid *ssid = &conf->ssid;
+	struct hostapd_psk_cache cache;
+	int ret;
 
 	if (hostapd_setup_sae_pt(conf) < 0)
 		return -1;
 
+	hostapd_psk_cache_init(&cache, ssid->wpa_psk_cache);
+
 	if (ssid->wpa_passphrase != NULL) {
 		if (ssid->wpa_psk != NULL) {
 			wpa_printf(MSG_DEBUG, "Using pre-configured WPA PSK "
@@ -538,13 +877,20 @@ int hostapd_setup_wpa_psk(struct hostapd_bss_config *conf)
 		} else {
 			wpa_printf(MSG_DEBUG, "Deriving WPA PSK based on "
 				   "passphrase");
-			if (hostapd_derive_psk(ssid) < 0)
+			if (hostapd_derive_psk(ssid, &cache) < 0) {
+				hostapd_psk_cache_deinit(&cache);
 				return -1;
+			}
 		}
 		ssid->wpa_psk->group = 1;
 	}
 
-	return hostapd_config_read_wpa_psk(ssid->wpa_psk_file, &conf->ssid);
+	ret = hostapd_config_read_wpa_psk(ssid->wpa_psk_file, &conf->ssid,
+					  &cache);
+	if (ret == 0)
+		hostapd_psk_cache_write(&cache);
+	hostapd_psk_cache_deinit(&cache);
+	return ret;
 }
 
 
@@ -803,9 +1149,11 @@ void hostapd_config_free_bss(struct hostapd_bss_config *conf)
 
 	str_clear_free(conf->ssid.wpa_passphrase);
 	os_free(conf->ssid.wpa_psk_file);
+	os_free(conf->ssid.wpa_psk_cache);
 #ifdef CONFIG_WEP
 	hostapd_config_free_wep(&conf->ssid.wep);
 #endif /* CONFIG_WEP */
+	os_free(conf->ssid.vlan_prewarm);
 #ifdef CONFIG_FULL_DYNAMIC_VLAN
 	os_free(conf->ssid.vlan_tagged_interface);
 #endif /* CONFIG_FULL_DYNAMIC_VLAN */
@@ -842,6 +1190,7 @@ void hostapd_config_free_bss(struct hostapd_bss_config *conf)
 	os_free(conf->private_key_passwd);
 	os_free(conf->private_key_passwd2);
 	os_free(conf->check_cert_subject);
+	os_free(conf->tls_session_cache);
 	os_free(conf->ocsp_stapling_response);
 	os_free(conf->ocsp_stapling_response_multi);
 	os_free(conf->dh_file);
@@ -111,6 +111,7 @@ struct hostapd_ssid {
 	struct hostapd_wpa_psk *wpa_psk;
 	char *wpa_passphrase;
 	char *wpa_psk_file;
+	char *wpa_psk_cache;
 	struct sae_pt *pt;
 
 #ifdef CONFIG_WEP
@@ -126,6 +127,8 @@ struct hostapd_ssid {
 #define DYNAMIC_VLAN_NAMING_END 2
 	int vlan_naming;
 	int per_sta_vif;
+	int *vlan_prewarm; /* zero terminated list of VLAN IDs */
+	unsigned int vlan_remove_grace;
 #ifdef CONFIG_FULL_DYNAMIC_VLAN
 	char *vlan_tagged_interface;
 #endif /* CONFIG_FULL_DYNAMIC_VLAN */
@@ -142,6 +145,9 @@ struct hostapd_vlan {
 	char bridge[IFNAMSIZ + 1];
 	int configured;
 	int dynamic_vlan;
+	/* Extra reference held until linger_expire for delayed removal */
+	int linger;
+	struct os_reltime linger_expire;
 #ifdef CONFIG_FULL_DYNAMIC_VLAN
 
 #define DVLAN_CLEAN_WLAN_PORT	0x8
@@ -426,6 +432,7 @@ struct hostapd_bss_config {
 	int check_crl_strict;
 	unsigned int crl_reload_interval;
 	unsigned int tls_session_lifetime;
+	char *tls_session_cache;
 	unsigned int tls_flags;
 	unsigned int max_auth_rounds;
 	unsigned int max_auth_rounds_short;
@@ -946,6 +953,11 @@ struct hostapd_bss_config {
 
 	u8 rnr;
 	char *config_id;
+	/* Digest of the parameters of this BSS in the configuration file that
+	 * cannot be changed without disconnecting stations; used to detect
+	 * whether stations need to be flushed on configuration reload */
+	u8 config_digest[SHA256_MAC_LEN];
+	bool config_digest_set;
 	bool xrates_supported;
 
 #ifdef CONFIG_IEEE80211BE
@@ -272,6 +272,7 @@ int authsrv_init(struct hostapd_data *hapd)
 
 		os_memset(&conf, 0, sizeof(conf));
 		conf.tls_session_lifetime = hapd->conf->tls_session_lifetime;
+		conf.tls_session_cache = hapd->conf->tls_session_cache;
 		if (hapd->conf->crl_reload_interval > 0 &&
 		    hapd->conf->check_crl <= 0) {
 			wpa_printf(MSG_INFO,
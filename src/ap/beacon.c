@@ -13,6 +13,7 @@
 #ifndef CONFIG_NATIVE_WINDOWS
 
 #include "utils/common.h"
+#include "utils/crc32.h"
 #include "common/ieee802_11_defs.h"
 #include "common/ieee802_11_common.h"
 #include "common/hw_features_common.h"
@@ -686,6 +687,200 @@ static size_t hostapd_probe_resp_elems_len(struct hostapd_data *hapd,
 }
 
 
+/* Incremented on configuration changes to invalidate the radio elements */
+static unsigned int radio_elems_gen = 0;
+
+
+static void hostapd_radio_elems_clear(struct hostapd_radio_elems *re)
+{
+	int i;
+
+	for (i = 0; i < NUM_RADIO_ELEM; i++) {
+		wpabuf_free(re->elem[i]);
+		re->elem[i] = NULL;
+	}
+	re->valid = false;
+}
+
+
+void hostapd_radio_elems_flush(struct hostapd_iface *iface)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(iface->radio_elems); i++)
+		hostapd_radio_elems_clear(&iface->radio_elems[i]);
+	iface->cur_radio_elems = NULL;
+}
+
+
+static bool
+hostapd_radio_elems_chan_equal(const struct hostapd_radio_elems_chan *a,
+			       const struct hostapd_radio_elems_chan *b)
+{
+	return a->freq == b->freq &&
+		a->channel == b->channel &&
+		a->op_class == b->op_class &&
+		a->secondary_channel == b->secondary_channel &&
+		a->oper_chwidth == b->oper_chwidth &&
+		a->seg0_idx == b->seg0_idx &&
+		a->seg1_idx == b->seg1_idx &&
+		a->ht_op_mode == b->ht_op_mode &&
+		a->ht_capab == b->ht_capab &&
+		a->vht_capab == b->vht_capab;
+}
+
+
+/**
+ * hostapd_radio_elems_select - Select radio elements for the current channel
+ * @iface: Interface data
+ *
+ * This needs to be called before building the frame elements with
+ * hostapd_eid_radio() to select the cached elements matching the current
+ * configuration and operating channel. The least recently used entry is
+ * replaced if no entry matches.
+ */
+static void hostapd_radio_elems_select(struct hostapd_iface *iface)
+{
+	struct hostapd_config *conf = iface->conf;
+	struct hostapd_radio_elems *re, *lru = NULL;
+	struct hostapd_radio_elems_chan chan;
+	size_t i;
+
+	chan.freq = iface->freq;
+	chan.channel = conf->channel;
+	chan.op_class = conf->op_class;
+	chan.secondary_channel = conf->secondary_channel;
+	chan.oper_chwidth = hostapd_get_oper_chwidth(conf);
+	chan.seg0_idx = hostapd_get_oper_centr_freq_seg0_idx(conf);
+	chan.seg1_idx = hostapd_get_oper_centr_freq_seg1_idx(conf);
+	chan.ht_op_mode = iface->ht_op_mode;
+	chan.ht_capab = conf->ht_capab;
+	chan.vht_capab = conf->vht_capab;
+
+	for (i = 0; i < ARRAY_SIZE(iface->radio_elems); i++) {
+		re = &iface->radio_elems[i];
+		if (re->valid && re->gen == radio_elems_gen &&
+		    re->conf == conf && re->mode == iface->current_mode &&
+		    hostapd_radio_elems_chan_equal(&re->chan, &chan))
+			goto out;
+		if (!lru || !re->valid || (lru->valid && re->used < lru->used))
+			lru = re;
+	}
+
+	re = lru;
+	hostapd_radio_elems_clear(re);
+	re->conf = conf;
+	re->mode = iface->current_mode;
+	re->chan = chan;
+	re->gen = radio_elems_gen;
+	re->valid = true;
+out:
+	re->used = ++iface->radio_elems_used;
+	iface->cur_radio_elems = re;
+}
+
+
+static u8 * hostapd_eid_radio_build(struct hostapd_data *hapd, u8 *pos,
+				    u8 *end, enum hostapd_radio_elem type)
+{
+	switch (type) {
+	case RADIO_ELEM_COUNTRY:
+		pos = hostapd_eid_country(hapd, pos, end - pos);
+		pos = hostapd_eid_pwr_constraint(hapd, pos);
+		break;
+	case RADIO_ELEM_HT:
+		pos = hostapd_eid_supported_op_classes(hapd, pos);
+		pos = hostapd_eid_ht_capabilities(hapd, pos);
+		pos = hostapd_eid_ht_operation(hapd, pos);
+		break;
+#ifdef CONFIG_IEEE80211AC
+	case RADIO_ELEM_VHT:
+		pos = hostapd_eid_vht_capabilities(hapd, pos, 0);
+		pos = hostapd_eid_vht_operation(hapd, pos);
+		pos = hostapd_eid_txpower_envelope(hapd, pos);
+		break;
+#endif /* CONFIG_IEEE80211AC */
+	case RADIO_ELEM_TPE:
+		pos = hostapd_eid_txpower_envelope(hapd, pos);
+		break;
+#ifdef CONFIG_IEEE80211AX
+	case RADIO_ELEM_HE_CAPAB:
+		pos = hostapd_eid_he_capab(hapd, pos, IEEE80211_MODE_AP);
+		break;
+	case RADIO_ELEM_HE_PARAMS:
+		pos = hostapd_eid_spatial_reuse(hapd, pos);
+		pos = hostapd_eid_he_mu_edca_parameter_set(hapd, pos);
+		pos = hostapd_eid_he_6ghz_band_cap(hapd, pos);
+		break;
+#endif /* CONFIG_IEEE80211AX */
+#ifdef CONFIG_IEEE80211BE
+	case RADIO_ELEM_EHT_CAPAB:
+		pos = hostapd_eid_eht_capab(hapd, pos, IEEE80211_MODE_AP);
+		break;
+#endif /* CONFIG_IEEE80211BE */
+	default:
+		break;
+	}
+
+	return pos;
+}
+
+
+/**
+ * hostapd_eid_radio - Add a group of radio level elements
+ * @hapd: Pointer to BSS data
+ * @eid: Pointer to the buffer for the elements
+ * @end: End of the buffer
+ * @type: Group of elements to add
+ * Returns: Pointer to the end of the added elements
+ *
+ * The elements are built on the first use after the radio configuration or
+ * operating channel has changed and copied from the cache for the following
+ * frames of all BSSs on the radio. hostapd_radio_elems_select() needs to have
+ * been called before this.
+ */
+static u8 * hostapd_eid_radio(struct hostapd_data *hapd, u8 *eid, u8 *end,
+			      enum hostapd_radio_elem type)
+{
+	struct hostapd_iface *iface = hapd->iface;
+	struct hostapd_radio_elems *re = iface->cur_radio_elems;
+	struct wpabuf *buf;
+	u8 *pos;
+
+	/* Per-BSS parameters that modify the radio level elements */
+	if (!re || (type == RADIO_ELEM_HT && hapd->conf->disable_11n) ||
+	    (type == RADIO_ELEM_VHT && hapd->conf->vendor_vht))
+		return hostapd_eid_radio_build(hapd, eid, end, type);
+
+	buf = re->elem[type];
+	if (buf) {
+		if (wpabuf_len(buf) > (size_t) (end - eid))
+			return hostapd_eid_radio_build(hapd, eid, end, type);
+		os_memcpy(eid, wpabuf_head(buf), wpabuf_len(buf));
+		iface->radio_elems_hits++;
+		return eid + wpabuf_len(buf);
+	}
+
+	pos = hostapd_eid_radio_build(hapd, eid, end, type);
+	re->elem[type] = wpabuf_alloc_copy(eid, pos - eid);
+	iface->radio_elems_misses++;
+	return pos;
+}
+
+
+int hostapd_radio_elems_stats(struct hostapd_iface *iface, char *buf,
+			      size_t buflen)
+{
+	int ret;
+
+	ret = os_snprintf(buf, buflen, "hits=%lu\nmisses=%lu\n",
+			  iface->radio_elems_hits, iface->radio_elems_misses);
+	if (os_snprintf_error(buflen, ret))
+		return 0;
+	return ret;
+}
+
+
 static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 					  struct probe_resp_params *params,
 					  u8 *pos, size_t len)
@@ -695,6 +890,8 @@ static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 
 	epos = pos + len;
 
+	hostapd_radio_elems_select(hapd->iface);
+
 	if (!params->is_ml_sta_info) {
 		*pos++ = WLAN_EID_SSID;
 		*pos++ = hapd->conf->ssid.ssid_len;
@@ -709,10 +906,8 @@ static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 	/* DS Params */
 	pos = hostapd_eid_ds_params(hapd, pos);
 
-	pos = hostapd_eid_country(hapd, pos, epos - pos);
-
-	/* Power Constraint element */
-	pos = hostapd_eid_pwr_constraint(hapd, pos);
+	/* Country and Power Constraint elements */
+	pos = hostapd_eid_radio(hapd, pos, epos, RADIO_ELEM_COUNTRY);
 
 	/*
 	 * CSA IE
@@ -754,9 +949,7 @@ static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 		pos = csa_pos;
 	}
 
-	pos = hostapd_eid_supported_op_classes(hapd, pos);
-	pos = hostapd_eid_ht_capabilities(hapd, pos);
-	pos = hostapd_eid_ht_operation(hapd, pos);
+	pos = hostapd_eid_radio(hapd, pos, epos, RADIO_ELEM_HT);
 
 	/* Probe Response frames always include all non-TX profiles except
 	 * when a list of known BSSes is included in the Probe Request frame. */
@@ -781,17 +974,14 @@ static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 
 #ifdef CONFIG_IEEE80211AC
 	if (hapd->iconf->ieee80211ac && !hapd->conf->disable_11ac &&
-	    !is_6ghz_op_class(hapd->iconf->op_class)) {
-		pos = hostapd_eid_vht_capabilities(hapd, pos, 0);
-		pos = hostapd_eid_vht_operation(hapd, pos);
-		pos = hostapd_eid_txpower_envelope(hapd, pos);
-	}
+	    !is_6ghz_op_class(hapd->iconf->op_class))
+		pos = hostapd_eid_radio(hapd, pos, epos, RADIO_ELEM_VHT);
 #endif /* CONFIG_IEEE80211AC */
 
 #ifdef CONFIG_IEEE80211AX
 	if (hapd->iconf->ieee80211ax && !hapd->conf->disable_11ax &&
 	    is_6ghz_op_class(hapd->iconf->op_class))
-		pos = hostapd_eid_txpower_envelope(hapd, pos);
+		pos = hostapd_eid_radio(hapd, pos, epos, RADIO_ELEM_TPE);
 #endif /* CONFIG_IEEE80211AX */
 
 	pos = hostapd_eid_wb_chsw_wrapper(hapd, pos);
@@ -805,7 +995,7 @@ static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 	if (hapd->iconf->ieee80211ax && !hapd->conf->disable_11ax) {
 		u8 *cca_pos;
 
-		pos = hostapd_eid_he_capab(hapd, pos, IEEE80211_MODE_AP);
+		pos = hostapd_eid_radio(hapd, pos, epos, RADIO_ELEM_HE_CAPAB);
 		pos = hostapd_eid_he_operation(hapd, pos);
 
 		/* BSS Color Change Announcement element */
@@ -816,9 +1006,7 @@ static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 			params->cca_pos = NULL;
 		pos = cca_pos;
 
-		pos = hostapd_eid_spatial_reuse(hapd, pos);
-		pos = hostapd_eid_he_mu_edca_parameter_set(hapd, pos);
-		pos = hostapd_eid_he_6ghz_band_cap(hapd, pos);
+		pos = hostapd_eid_radio(hapd, pos, epos, RADIO_ELEM_HE_PARAMS);
 	}
 #endif /* CONFIG_IEEE80211AX */
 
@@ -832,7 +1020,7 @@ static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 				ml_elem_ap, params->mld_info,
 				pos, !!params->mld_ap);
 
-		pos = hostapd_eid_eht_capab(hapd, pos, IEEE80211_MODE_AP);
+		pos = hostapd_eid_radio(hapd, pos, epos, RADIO_ELEM_EHT_CAPAB);
 		pos = hostapd_eid_eht_operation(hapd, pos);
 	}
 #endif /* CONFIG_IEEE80211BE */
@@ -889,6 +1077,24 @@ static u8 * hostapd_probe_resp_fill_elems(struct hostapd_data *hapd,
 }
 
 
+static void hostapd_probe_resp_set_da(struct hostapd_data *hapd,
+				      struct ieee80211_mgmt *resp,
+				      const struct ieee80211_mgmt *req)
+{
+	/* Unicast the response to all requests on bands other than 6 GHz. For
+	 * the 6 GHz, unicast is used only if the actual SSID is not included in
+	 * the Beacon frames. Otherwise, broadcast response is used per IEEE
+	 * Std 802.11ax-2021, 26.17.2.3.2. Broadcast address is also used for
+	 * the Probe Response frame template for the unsolicited (i.e., not as
+	 * a response to a specific request) case. */
+	if (req && (!is_6ghz_op_class(hapd->iconf->op_class) ||
+		    hapd->conf->ignore_broadcast_ssid))
+		os_memcpy(resp->da, req->sa, ETH_ALEN);
+	else
+		os_memset(resp->da, 0xff, ETH_ALEN);
+}
+
+
 static void hostapd_gen_probe_resp(struct hostapd_data *hapd,
 				   struct probe_resp_params *params)
 {
@@ -908,17 +1114,7 @@ static void hostapd_gen_probe_resp(struct hostapd_data *hapd,
 
 	params->resp->frame_control = IEEE80211_FC(WLAN_FC_TYPE_MGMT,
 						   WLAN_FC_STYPE_PROBE_RESP);
-	/* Unicast the response to all requests on bands other than 6 GHz. For
-	 * the 6 GHz, unicast is used only if the actual SSID is not included in
-	 * the Beacon frames. Otherwise, broadcast response is used per IEEE
-	 * Std 802.11ax-2021, 26.17.2.3.2. Broadcast address is also used for
-	 * the Probe Response frame template for the unsolicited (i.e., not as
-	 * a response to a specific request) case. */
-	if (params->req && (!is_6ghz_op_class(hapd->iconf->op_class) ||
-		    hapd->conf->ignore_broadcast_ssid))
-		os_memcpy(params->resp->da, params->req->sa, ETH_ALEN);
-	else
-		os_memset(params->resp->da, 0xff, ETH_ALEN);
+	hostapd_probe_resp_set_da(hapd, params->resp, params->req);
 	os_memcpy(params->resp->sa, hapd->own_addr, ETH_ALEN);
 
 	os_memcpy(params->resp->bssid, hapd->own_addr, ETH_ALEN);
@@ -937,6 +1133,84 @@ static void hostapd_gen_probe_resp(struct hostapd_data *hapd,
 }
 
 
+/* Incremented on each Beacon frame update to invalidate all templates */
+static unsigned int probe_resp_tmpl_gen = 0;
+
+
+/* Invalidate the Probe Response templates, but not the radio elements */
+static void hostapd_probe_resp_tmpl_new_gen(void)
+{
+	probe_resp_tmpl_gen++;
+}
+
+
+/**
+ * hostapd_probe_resp_tmpl_invalidate - Invalidate Probe Response templates
+ *
+ * This needs to be called when something included in the Probe Response frames
+ * may have changed without a Beacon frame update. The templates of all BSSs
+ * are rebuilt when they are used the next time.
+ */
+void hostapd_probe_resp_tmpl_invalidate(void)
+{
+	hostapd_probe_resp_tmpl_new_gen();
+	radio_elems_gen++;
+}
+
+
+void hostapd_probe_resp_tmpl_flush(struct hostapd_data *hapd)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(hapd->probe_resp_tmpl); i++) {
+		os_free(hapd->probe_resp_tmpl[i].resp);
+		hapd->probe_resp_tmpl[i].resp = NULL;
+		hapd->probe_resp_tmpl[i].resp_len = 0;
+	}
+}
+
+
+static struct hostapd_probe_resp_tmpl *
+hostapd_probe_resp_tmpl_get(struct hostapd_data *hapd,
+			    struct probe_resp_params *params)
+{
+	struct hostapd_data *tx_bss = hostapd_mbssid_get_tx_bss(hapd);
+	struct hostapd_probe_resp_tmpl *tmpl;
+
+	/* The response depends on the request for known BSSs and ML probing,
+	 * and the CSA and CCA counters change without Beacon frame updates. */
+	if (params->known_bss_len || params->mld_ap || params->mld_info ||
+	    hapd->csa_in_progress || tx_bss->csa_in_progress ||
+	    tx_bss->cca_in_progress)
+		return NULL;
+
+	tmpl = &tx_bss->probe_resp_tmpl[params->is_p2p];
+	if (tmpl->resp && tmpl->gen == probe_resp_tmpl_gen &&
+	    tmpl->num_sta == tx_bss->num_sta) {
+		hostapd_probe_resp_set_da(tx_bss, tmpl->resp, params->req);
+		return tmpl;
+	}
+
+	os_free(tmpl->resp);
+	tmpl->resp = NULL;
+	tmpl->resp_len = 0;
+
+	hostapd_gen_probe_resp(hapd, params);
+	if (!params->resp)
+		return NULL;
+	tmpl->resp = params->resp;
+	tmpl->resp_len = params->resp_len;
+	tmpl->gen = probe_resp_tmpl_gen;
+	tmpl->num_sta = tx_bss->num_sta;
+	params->resp = NULL;
+	params->resp_len = 0;
+	wpa_printf(MSG_EXCESSIVE,
+		   "%s: Built Probe Response template (%zu bytes)",
+		   tx_bss->conf->iface, tmpl->resp_len);
+	return tmpl;
+}
+
+
 #ifdef CONFIG_IEEE80211BE
 static void hostapd_fill_probe_resp_ml_params(struct hostapd_data *hapd,
 					      struct probe_resp_params *params,
@@ -1131,6 +1405,224 @@ static enum ssid_match_result ssid_match(struct hostapd_data *hapd,
 }
 
 
+/* Elements used by hostapd_probe_req_filter() */
+static const u8 probe_filter_ids[] = {
+	WLAN_EID_SSID, WLAN_EID_SUPP_RATES, WLAN_EID_DS_PARAMS,
+	WLAN_EID_SSID_LIST
+};
+
+static const u8 probe_filter_ext_ids[] = {
+	WLAN_EID_EXT_SHORT_SSID_LIST
+};
+
+
+static void probe_filter_bits(u32 short_ssid, unsigned int *a, unsigned int *b)
+{
+	*a = short_ssid & 0x3ff;
+	*b = (short_ssid >> 16) & 0x3ff;
+}
+
+
+static void probe_filter_add(struct hostapd_probe_filter *pf, u32 short_ssid)
+{
+	unsigned int a, b;
+
+	probe_filter_bits(short_ssid, &a, &b);
+	pf->ssid_bloom[a / 8] |= BIT(a % 8);
+	pf->ssid_bloom[b / 8] |= BIT(b % 8);
+}
+
+
+static bool probe_filter_match(struct hostapd_probe_filter *pf, u32 short_ssid)
+{
+	unsigned int a, b;
+
+	probe_filter_bits(short_ssid, &a, &b);
+	return (pf->ssid_bloom[a / 8] & BIT(a % 8)) &&
+		(pf->ssid_bloom[b / 8] & BIT(b % 8));
+}
+
+
+static void hostapd_probe_filter_update(struct hostapd_iface *iface)
+{
+	struct hostapd_probe_filter *pf = &iface->probe_filter;
+	size_t i;
+
+	os_memset(pf->ssid_bloom, 0, sizeof(pf->ssid_bloom));
+	pf->hidden = true;
+	pf->bypass = false;
+
+	for (i = 0; i < iface->num_bss; i++) {
+		struct hostapd_data *bss = iface->bss[i];
+		struct hostapd_ssid *ssid = &bss->conf->ssid;
+
+		/* The Short SSID in the configuration is not updated when the
+		 * SSID is changed at runtime, so calculate it here */
+		probe_filter_add(pf, ieee80211_crc32(ssid->ssid,
+						     ssid->ssid_len));
+		if (!bss->conf->ignore_broadcast_ssid)
+			pf->hidden = false;
+		if (bss->num_probereq_cb)
+			pf->bypass = true;
+#ifdef CONFIG_P2P
+		if (bss->conf->p2p & P2P_GROUP_OWNER)
+			pf->bypass = true;
+#endif /* CONFIG_P2P */
+	}
+
+	pf->gen = probe_resp_tmpl_gen;
+	pf->valid = true;
+}
+
+
+/**
+ * hostapd_probe_req_filter - Radio level Probe Request prefilter
+ * @iface: Interface data
+ * @buf: Probe Request frame
+ * @len: Length of the frame in octets
+ * Returns: 1 if the frame was dropped or 0 if it needs to be delivered to the
+ *	BSSs
+ *
+ * This drops Probe Request frames that none of the BSSs on the radio would
+ * reply to based on a single pass over the elements and a compact hash set of
+ * the SSIDs of the BSSs. This is done once for each received frame instead of
+ * a full element parse and SSID matching in handle_probe_req() for each BSS.
+ * Frames that cannot be rejected this way are passed through to the full
+ * processing.
+ */
+int hostapd_probe_req_filter(struct hostapd_iface *iface, const u8 *buf,
+			     size_t len)
+{
+	struct hostapd_probe_filter *pf = &iface->probe_filter;
+	struct hostapd_hw_modes *mode = iface->current_mode;
+	struct ieee802_11_elem_index idx;
+	const u8 *ssid, *ds, *ssid_list, *short_ssid_list, *pos, *end;
+	bool wildcard = false;
+#ifdef CONFIG_TAXONOMY
+	size_t i;
+#endif /* CONFIG_TAXONOMY */
+
+	if (!pf->valid || pf->gen != probe_resp_tmpl_gen)
+		hostapd_probe_filter_update(iface);
+
+	if (pf->bypass || iface->conf->track_sta_max_num ||
+	    len < IEEE80211_HDRLEN) {
+		pf->bypassed++;
+		return 0;
+	}
+
+	if (ieee802_11_elem_index_build(buf + IEEE80211_HDRLEN,
+					len - IEEE80211_HDRLEN,
+					probe_filter_ids,
+					ARRAY_SIZE(probe_filter_ids),
+					probe_filter_ext_ids,
+					ARRAY_SIZE(probe_filter_ext_ids),
+					&idx) < 0) {
+		pf->malformed++;
+		return 1;
+	}
+
+	ssid = ieee802_11_elem_index_get(&idx, WLAN_EID_SSID);
+	if (!ssid || !ieee802_11_elem_index_get(&idx, WLAN_EID_SUPP_RATES)) {
+		pf->no_ssid++;
+		return 1;
+	}
+	if (ssid[1] > SSID_MAX_LEN)
+		goto pass;
+
+	ds = ieee802_11_elem_index_get(&idx, WLAN_EID_DS_PARAMS);
+	if (ds && ds[1] >= 1 && mode &&
+	    (mode->mode == HOSTAPD_MODE_IEEE80211G ||
+	     mode->mode == HOSTAPD_MODE_IEEE80211B) &&
+	    iface->conf->channel != ds[2]) {
+		pf->ds_mismatch++;
+		return 1;
+	}
+
+	if (ssid[1] == 0)
+		wildcard = true;
+	else if (probe_filter_match(pf, ieee80211_crc32(ssid + 2, ssid[1])))
+		goto pass;
+
+	ssid_list = ieee802_11_elem_index_get(&idx, WLAN_EID_SSID_LIST);
+	if (ssid_list) {
+		pos = ssid_list + 2;
+		end = pos + ssid_list[1];
+		while (end - pos >= 2 && 2 + pos[1] <= end - pos) {
+			if (pos[1] == 0)
+				wildcard = true;
+			else if (probe_filter_match(
+					 pf, ieee80211_crc32(pos + 2, pos[1])))
+				goto pass;
+			pos += 2 + pos[1];
+		}
+	}
+
+	short_ssid_list = ieee802_11_elem_index_get_ext(
+		&idx, WLAN_EID_EXT_SHORT_SSID_LIST);
+	if (short_ssid_list) {
+		pos = short_ssid_list + 3;
+		end = short_ssid_list + 2 + short_ssid_list[1];
+		while (end - pos >= 4) {
+			if (probe_filter_match(pf, WPA_GET_LE32(pos)))
+				goto pass;
+			pos += 4;
+		}
+	}
+
+	if (wildcard) {
+		if (!pf->hidden)
+			goto pass;
+		pf->broadcast++;
+		return 1;
+	}
+
+	/* SSIDs of co-located 6 GHz APs are matched in handle_probe_req() */
+	if (iface->interfaces && iface->interfaces->count > 1 &&
+	    !is_6ghz_op_class(iface->conf->op_class))
+		goto pass;
+
+#ifdef CONFIG_TAXONOMY
+	/* Taxonomy information of associated STAs is updated also from Probe
+	 * Request frames for foreign SSIDs */
+	for (i = 0; i < iface->num_bss; i++) {
+		if (ap_get_sta(iface->bss[i],
+			       ((const struct ieee80211_mgmt *) buf)->sa))
+			goto pass;
+	}
+#endif /* CONFIG_TAXONOMY */
+
+	pf->foreign_ssid++;
+	return 1;
+
+pass:
+	pf->passed++;
+	return 0;
+}
+
+
+int hostapd_probe_req_filter_stats(struct hostapd_iface *iface, char *buf,
+				   size_t buflen)
+{
+	struct hostapd_probe_filter *pf = &iface->probe_filter;
+	int ret;
+
+	ret = os_snprintf(buf, buflen,
+			  "passed=%lu\n"
+			  "bypassed=%lu\n"
+			  "malformed=%lu\n"
+			  "no_ssid=%lu\n"
+			  "ds_mismatch=%lu\n"
+			  "broadcast=%lu\n"
+			  "foreign_ssid=%lu\n",
+			  pf->passed, pf->bypassed, pf->malformed, pf->no_ssid,
+			  pf->ds_mismatch, pf->broadcast, pf->foreign_ssid);
+	if (os_snprintf_error(buflen, ret))
+		return 0;
+	return ret;
+}
+
+
 void sta_track_expire(struct hostapd_iface *iface, int force)
 {
 	struct os_reltime now;
@@ -1347,6 +1839,9 @@ void handle_probe_req(struct hostapd_data *hapd,
 	size_t csa_offs_len;
 	struct radius_sta rad_info;
 	struct probe_resp_params params;
+	struct hostapd_probe_resp_tmpl *tmpl;
+	const struct ieee80211_mgmt *resp;
+	size_t resp_len;
 #ifdef CONFIG_IEEE80211BE
 	int mld_id;
 	u16 links;
@@ -1418,27 +1913,35 @@ void handle_probe_req(struct hostapd_data *hapd,
 #ifdef CONFIG_P2P
 	if (hapd->p2p && hapd->p2p_group && elems.wps_ie) {
 		struct wpabuf *wps;
+		bool match;
+
+		wpabuf_arena_begin();
 		wps = ieee802_11_vendor_ie_concat(ie, ie_len, WPS_DEV_OUI_WFA);
-		if (wps && !p2p_group_match_dev_type(hapd->p2p_group, wps)) {
+		match = !wps || p2p_group_match_dev_type(hapd->p2p_group, wps);
+		wpabuf_free(wps);
+		wpabuf_arena_end();
+		if (!match) {
 			wpa_printf(MSG_MSGDUMP, "P2P: Ignore Probe Request "
 				   "due to mismatch with Requested Device "
 				   "Type");
-			wpabuf_free(wps);
 			return;
 		}
-		wpabuf_free(wps);
 	}
 
 	if (hapd->p2p && hapd->p2p_group && elems.p2p) {
 		struct wpabuf *p2p;
+		bool match;
+
+		wpabuf_arena_begin();
 		p2p = ieee802_11_vendor_ie_concat(ie, ie_len, P2P_IE_VENDOR_TYPE);
-		if (p2p && !p2p_group_match_dev_id(hapd->p2p_group, p2p)) {
+		match = !p2p || p2p_group_match_dev_id(hapd->p2p_group, p2p);
+		wpabuf_free(p2p);
+		wpabuf_arena_end();
+		if (!match) {
 			wpa_printf(MSG_MSGDUMP, "P2P: Ignore Probe Request "
 				   "due to mismatch with Device ID");
-			wpabuf_free(p2p);
 			return;
 		}
-		wpabuf_free(p2p);
 	}
 #endif /* CONFIG_P2P */
 
@@ -1599,11 +2102,19 @@ void handle_probe_req(struct hostapd_data *hapd,
 	params.known_bss_len = elems.mbssid_known_bss_len;
 	params.is_ml_sta_info = false;
 
-	hostapd_gen_probe_resp(hapd, &params);
+	tmpl = hostapd_probe_resp_tmpl_get(hapd, &params);
+	if (tmpl) {
+		resp = tmpl->resp;
+		resp_len = tmpl->resp_len;
+	} else {
+		hostapd_gen_probe_resp(hapd, &params);
+		resp = params.resp;
+		resp_len = params.resp_len;
+	}
 
 	hostapd_free_probe_resp_params(&params);
 
-	if (!params.resp)
+	if (!resp)
 		return;
 
 	/*
@@ -1624,7 +2135,7 @@ void handle_probe_req(struct hostapd_data *hapd,
 				params.ecsa_pos - (u8 *) params.resp;
 	}
 
-	ret = hostapd_drv_send_mlme(hapd, params.resp, params.resp_len, noack,
+	ret = hostapd_drv_send_mlme(hapd, resp, resp_len, noack,
 				    csa_offs_len ? csa_offs : NULL,
 				    csa_offs_len, 0);
 
@@ -1701,6 +2212,27 @@ static u8 * hostapd_probe_resp_offloads(struct hostapd_data *hapd,
 	return (u8 *) params.resp;
 }
 
+#else /* NEED_AP_MLME */
+
+static void hostapd_probe_resp_tmpl_new_gen(void)
+{
+}
+
+
+void hostapd_probe_resp_tmpl_invalidate(void)
+{
+}
+
+
+void hostapd_probe_resp_tmpl_flush(struct hostapd_data *hapd)
+{
+}
+
+
+void hostapd_radio_elems_flush(struct hostapd_iface *iface)
+{
+}
+
 #endif /* NEED_AP_MLME */
 
 
@@ -2187,10 +2719,10 @@ int ieee802_11_build_ap_params(struct hostapd_data *hapd,
 
 	head_len = pos - (u8 *) head;
 
-	tailpos = hostapd_eid_country(hapd, tailpos, tailend - tailpos);
+	hostapd_radio_elems_select(hapd->iface);
 
-	/* Power Constraint element */
-	tailpos = hostapd_eid_pwr_constraint(hapd, tailpos);
+	/* Country and Power Constraint elements */
+	tailpos = hostapd_eid_radio(hapd, tailpos, tailend, RADIO_ELEM_COUNTRY);
 
 	/* CSA IE */
 	csa_pos = hostapd_eid_csa(hapd, tailpos);
@@ -2216,9 +2748,7 @@ int ieee802_11_build_ap_params(struct hostapd_data *hapd,
 		hapd->cs_c_off_ecsa_beacon = csa_pos - tail - 1;
 	tailpos = csa_pos;
 
-	tailpos = hostapd_eid_supported_op_classes(hapd, tailpos);
-	tailpos = hostapd_eid_ht_capabilities(hapd, tailpos);
-	tailpos = hostapd_eid_ht_operation(hapd, tailpos);
+	tailpos = hostapd_eid_radio(hapd, tailpos, tailend, RADIO_ELEM_HT);
 
 	if (hapd->iconf->mbssid && hapd->iconf->num_bss > 1) {
 		if (ieee802_11_build_ap_params_mbssid(hapd, params)) {
@@ -2255,17 +2785,16 @@ int ieee802_11_build_ap_params(struct hostapd_data *hapd,
 
 #ifdef CONFIG_IEEE80211AC
 	if (hapd->iconf->ieee80211ac && !hapd->conf->disable_11ac &&
-	    !is_6ghz_op_class(hapd->iconf->op_class)) {
-		tailpos = hostapd_eid_vht_capabilities(hapd, tailpos, 0);
-		tailpos = hostapd_eid_vht_operation(hapd, tailpos);
-		tailpos = hostapd_eid_txpower_envelope(hapd, tailpos);
-	}
+	    !is_6ghz_op_class(hapd->iconf->op_class))
+		tailpos = hostapd_eid_radio(hapd, tailpos, tailend,
+					    RADIO_ELEM_VHT);
 #endif /* CONFIG_IEEE80211AC */
 
 #ifdef CONFIG_IEEE80211AX
 	if (hapd->iconf->ieee80211ax && !hapd->conf->disable_11ax &&
 	    is_6ghz_op_class(hapd->iconf->op_class))
-		tailpos = hostapd_eid_txpower_envelope(hapd, tailpos);
+		tailpos = hostapd_eid_radio(hapd, tailpos, tailend,
+					    RADIO_ELEM_TPE);
 #endif /* CONFIG_IEEE80211AX */
 
 	tailpos = hostapd_eid_wb_chsw_wrapper(hapd, tailpos);
@@ -2280,8 +2809,8 @@ int ieee802_11_build_ap_params(struct hostapd_data *hapd,
 	if (hapd->iconf->ieee80211ax && !hapd->conf->disable_11ax) {
 		u8 *cca_pos;
 
-		tailpos = hostapd_eid_he_capab(hapd, tailpos,
-					       IEEE80211_MODE_AP);
+		tailpos = hostapd_eid_radio(hapd, tailpos, tailend,
+					    RADIO_ELEM_HE_CAPAB);
 		tailpos = hostapd_eid_he_operation(hapd, tailpos);
 
 		/* BSS Color Change Announcement element */
@@ -2290,9 +2819,8 @@ int ieee802_11_build_ap_params(struct hostapd_data *hapd,
 			hapd->cca_c_off_beacon = cca_pos - tail - 2;
 		tailpos = cca_pos;
 
-		tailpos = hostapd_eid_spatial_reuse(hapd, tailpos);
-		tailpos = hostapd_eid_he_mu_edca_parameter_set(hapd, tailpos);
-		tailpos = hostapd_eid_he_6ghz_band_cap(hapd, tailpos);
+		tailpos = hostapd_eid_radio(hapd, tailpos, tailend,
+					    RADIO_ELEM_HE_PARAMS);
 	}
 #endif /* CONFIG_IEEE80211AX */
 
@@ -2301,8 +2829,8 @@ int ieee802_11_build_ap_params(struct hostapd_data *hapd,
 		if (hapd->conf->mld_ap)
 			tailpos = hostapd_eid_eht_ml_beacon(hapd, NULL,
 							    tailpos, false);
-		tailpos = hostapd_eid_eht_capab(hapd, tailpos,
-						IEEE80211_MODE_AP);
+		tailpos = hostapd_eid_radio(hapd, tailpos, tailend,
+					    RADIO_ELEM_EHT_CAPAB);
 		tailpos = hostapd_eid_eht_operation(hapd, tailpos);
 	}
 #endif /* CONFIG_IEEE80211BE */
@@ -2546,6 +3074,11 @@ static int __ieee802_11_set_beacon(struct hostapd_data *hapd)
 	int res, ret = -1, i;
 	struct hostapd_hw_modes *mode;
 
+	/* The radio level elements are kept over Beacon frame updates so that
+	 * they can be shared by all BSSs; they are rebuilt when the operating
+	 * channel or the configuration changes. */
+	hostapd_probe_resp_tmpl_new_gen();
+
 	if (!hapd->drv_priv) {
 		wpa_printf(MSG_ERROR, "Interface is disabled");
 		return -1;
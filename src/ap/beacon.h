@@ -19,6 +19,15 @@ void ieee802_11_set_beacon_per_bss_only(struct hostapd_data *hapd);
 int ieee802_11_set_beacon(struct hostapd_data *hapd);
 int ieee802_11_set_beacons(struct hostapd_iface *iface);
 int ieee802_11_update_beacons(struct hostapd_iface *iface);
+void hostapd_probe_resp_tmpl_flush(struct hostapd_data *hapd);
+void hostapd_probe_resp_tmpl_invalidate(void);
+void hostapd_radio_elems_flush(struct hostapd_iface *iface);
+int hostapd_radio_elems_stats(struct hostapd_iface *iface, char *buf,
+			      size_t buflen);
+int hostapd_probe_req_filter(struct hostapd_iface *iface, const u8 *buf,
+			     size_t len);
+int hostapd_probe_req_filter_stats(struct hostapd_iface *iface, char *buf,
+				   size_t buflen);
 int ieee802_11_build_ap_params(struct hostapd_data *hapd,
 			       struct wpa_driver_ap_params *params);
 void ieee802_11_free_ap_params(struct wpa_driver_ap_params *params);
@@ -126,7 +126,8 @@ int hostapd_dpp_nfc_handover_req(struct hostapd_data *hapd, const char *cmd)
 		return -1;
 	}
 
-	if (dpp_nfc_update_bi(own_bi, peer_bi) < 0)
+	if (dpp_nfc_update_bi(hapd->iface->interfaces->dpp, own_bi,
+			      peer_bi) < 0)
 		return -1;
 
 	return peer_bi->id;
@@ -3560,6 +3561,12 @@ int hostapd_dpp_controller_start(struct hostapd_data *hapd, const char *cmd)
 			config.tcp_port = atoi(pos);
 		}
 
+		pos = os_strstr(cmd, " max_conn=");
+		if (pos) {
+			pos += 10;
+			config.max_conn = atoi(pos);
+		}
+
 		pos = os_strstr(cmd, " role=");
 		if (pos) {
 			pos += 6;
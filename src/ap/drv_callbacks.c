@@ -1662,6 +1662,7 @@ static int hostapd_mgmt_rx(struct hostapd_data *hapd, struct rx_mgmt *rx_mgmt)
 	const struct ieee80211_hdr *hdr;
 	const u8 *bssid;
 	struct hostapd_frame_info fi;
+	u16 fc;
 	int ret;
 	bool is_mld = false;
 
@@ -1697,9 +1698,8 @@ static int hostapd_mgmt_rx(struct hostapd_data *hapd, struct rx_mgmt *rx_mgmt)
 	if (!is_mld)
 		hapd = get_hapd_bssid(iface, bssid);
 
+	fc = le_to_host16(hdr->frame_control);
 	if (!hapd) {
-		u16 fc = le_to_host16(hdr->frame_control);
-
 		/*
 		 * Drop frames to unknown BSSIDs except for Beacon frames which
 		 * could be used to update neighbor information.
@@ -1711,6 +1711,14 @@ static int hostapd_mgmt_rx(struct hostapd_data *hapd, struct rx_mgmt *rx_mgmt)
 			return 0;
 	}
 
+	/* Drop Probe Request frames that no BSS would reply to before
+	 * delivering them to each BSS */
+	if (WLAN_FC_GET_TYPE(fc) == WLAN_FC_TYPE_MGMT &&
+	    WLAN_FC_GET_STYPE(fc) == WLAN_FC_STYPE_PROBE_REQ &&
+	    hostapd_probe_req_filter(iface, rx_mgmt->frame,
+				     rx_mgmt->frame_len))
+		return 1;
+
 	os_memset(&fi, 0, sizeof(fi));
 	fi.freq = rx_mgmt->freq;
 	fi.datarate = rx_mgmt->datarate;
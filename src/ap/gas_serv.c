@@ -536,6 +536,42 @@ static int hs20_add_nai_home_realm_matches(struct hostapd_data *hapd,
 }
 
 
+/* Maximum length of the NAI Realm ANQP-element built by anqp_add_nai_realm()
+ * for either the full list of realms or the NAI Home Realm Query matches */
+static size_t anqp_nai_realm_len(struct hostapd_data *hapd, int nai_realm)
+{
+	size_t len = 0, max_data = 0, data_len;
+	unsigned int i, j;
+
+	for (i = 0; i < hapd->conf->nai_realm_count; i++) {
+		struct hostapd_nai_realm_data *realm;
+		size_t eap_len = 1, names_len = 0, max_name = 0, name_len;
+
+		realm = &hapd->conf->nai_realm_data[i];
+		for (j = 0; j < realm->eap_method_count; j++)
+			eap_len += 3 + 3 * realm->eap_method[j].num_auths;
+		for (j = 0; j < MAX_NAI_REALMS && realm->realm[j]; j++) {
+			name_len = os_strlen(realm->realm[j]);
+			names_len += 1 + name_len;
+			max_name = MAX(max_name, name_len);
+		}
+		/* NAI Realm Data Field Length, NAI Realm Encoding, NAI Realm
+		 * Length, NAI Realm, EAP methods */
+		len += 2 + 1 + 1 + names_len + eap_len;
+		data_len = 2 + 1 + 1 + max_name + eap_len;
+		max_data = MAX(max_data, data_len);
+	}
+
+	/* hs20_add_nai_home_realm_matches() adds at most 10 matches, each in
+	 * its own NAI Realm Data field */
+	if (!nai_realm)
+		len = 10 * max_data;
+
+	/* Info ID, Length, NAI Realm Count */
+	return 2 + 2 + 2 + len;
+}
+
+
 static void anqp_add_nai_realm(struct hostapd_data *hapd, struct wpabuf *buf,
 			       const u8 *home_realm, size_t home_realm_len,
 			       int nai_realm, int nai_home_realm)
@@ -969,6 +1005,161 @@ static size_t anqp_get_required_len(struct hostapd_data *hapd,
 }
 
 
+/* Buffer size for building a single cached ANQP-element */
+#define ANQP_CACHE_ELEM_LEN 2400
+
+/* ANQP-elements that depend on the query and cannot be cached */
+#define ANQP_REQ_NOT_CACHED (ANQP_REQ_NAI_HOME_REALM | ANQP_REQ_ICON_REQUEST)
+
+/* Incremented on configuration changes to invalidate the ANQP caches */
+static unsigned int anqp_cache_gen = 0;
+
+/**
+ * gas_serv_anqp_cache_invalidate - Invalidate cached ANQP-elements
+ *
+ * This needs to be called when the configuration used for building ANQP
+ * responses may have changed. The cached ANQP-elements of all BSSs are rebuilt
+ * when they are used the next time.
+ */
+void gas_serv_anqp_cache_invalidate(void)
+{
+	anqp_cache_gen++;
+}
+
+
+static void gas_serv_anqp_cache_flush(struct hostapd_data *hapd)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(hapd->anqp_cache); i++) {
+		wpabuf_free(hapd->anqp_cache[i]);
+		hapd->anqp_cache[i] = NULL;
+	}
+}
+
+
+static void anqp_build_cached(struct hostapd_data *hapd, struct wpabuf *buf,
+			      u32 req)
+{
+	switch (req) {
+	case ANQP_REQ_CAPABILITY_LIST:
+		anqp_add_capab_list(hapd, buf);
+		break;
+	case ANQP_REQ_VENUE_NAME:
+		anqp_add_venue_name(hapd, buf);
+		break;
+	case ANQP_REQ_EMERGENCY_CALL_NUMBER:
+		anqp_add_elem(hapd, buf, ANQP_EMERGENCY_CALL_NUMBER);
+		break;
+	case ANQP_REQ_NETWORK_AUTH_TYPE:
+		anqp_add_network_auth_type(hapd, buf);
+		break;
+	case ANQP_REQ_ROAMING_CONSORTIUM:
+		anqp_add_roaming_consortium(hapd, buf);
+		break;
+	case ANQP_REQ_IP_ADDR_TYPE_AVAILABILITY:
+		anqp_add_ip_addr_type_availability(hapd, buf);
+		break;
+	case ANQP_REQ_NAI_REALM:
+		anqp_add_nai_realm(hapd, buf, NULL, 0, 1, 0);
+		break;
+	case ANQP_REQ_3GPP_CELLULAR_NETWORK:
+		anqp_add_3gpp_cellular_network(hapd, buf);
+		break;
+	case ANQP_REQ_AP_GEOSPATIAL_LOCATION:
+		anqp_add_elem(hapd, buf, ANQP_AP_GEOSPATIAL_LOCATION);
+		break;
+	case ANQP_REQ_AP_CIVIC_LOCATION:
+		anqp_add_elem(hapd, buf, ANQP_AP_CIVIC_LOCATION);
+		break;
+	case ANQP_REQ_AP_LOCATION_PUBLIC_URI:
+		anqp_add_elem(hapd, buf, ANQP_AP_LOCATION_PUBLIC_URI);
+		break;
+	case ANQP_REQ_DOMAIN_NAME:
+		anqp_add_domain_name(hapd, buf);
+		break;
+	case ANQP_REQ_EMERGENCY_ALERT_URI:
+		anqp_add_elem(hapd, buf, ANQP_EMERGENCY_ALERT_URI);
+		break;
+	case ANQP_REQ_TDLS_CAPABILITY:
+		anqp_add_elem(hapd, buf, ANQP_TDLS_CAPABILITY);
+		break;
+	case ANQP_REQ_EMERGENCY_NAI:
+		anqp_add_elem(hapd, buf, ANQP_EMERGENCY_NAI);
+		break;
+#ifdef CONFIG_HS20
+	case ANQP_REQ_HS_CAPABILITY_LIST:
+		anqp_add_hs_capab_list(hapd, buf);
+		break;
+	case ANQP_REQ_OPERATOR_FRIENDLY_NAME:
+		anqp_add_operator_friendly_name(hapd, buf);
+		break;
+	case ANQP_REQ_WAN_METRICS:
+		anqp_add_wan_metrics(hapd, buf);
+		break;
+	case ANQP_REQ_CONNECTION_CAPABILITY:
+		anqp_add_connection_capability(hapd, buf);
+		break;
+	case ANQP_REQ_OPERATING_CLASS:
+		anqp_add_operating_class(hapd, buf);
+		break;
+	case ANQP_REQ_OSU_PROVIDERS_LIST:
+		anqp_add_osu_providers_list(hapd, buf);
+		break;
+	case ANQP_REQ_OPERATOR_ICON_METADATA:
+		anqp_add_operator_icon_metadata(hapd, buf);
+		break;
+	case ANQP_REQ_OSU_PROVIDERS_NAI_LIST:
+		anqp_add_osu_providers_nai_list(hapd, buf);
+		break;
+#endif /* CONFIG_HS20 */
+#ifdef CONFIG_MBO
+	case ANQP_REQ_MBO_CELL_DATA_CONN_PREF:
+		anqp_add_mbo_cell_data_conn_pref(hapd, buf);
+		break;
+#endif /* CONFIG_MBO */
+	}
+}
+
+
+/* Returns the cached ANQP-element for a single ANQP_REQ_* bit and builds it
+ * from the configuration, if needed. */
+static const struct wpabuf * anqp_cache_get(struct hostapd_data *hapd, u32 req)
+{
+	unsigned int idx = 0;
+	struct wpabuf *buf;
+
+	while (!(req & BIT(idx)))
+		idx++;
+
+	if (hapd->anqp_cache_gen != anqp_cache_gen) {
+		gas_serv_anqp_cache_flush(hapd);
+		hapd->anqp_cache_gen = anqp_cache_gen;
+	}
+
+	if (hapd->anqp_cache[idx])
+		return hapd->anqp_cache[idx];
+
+	buf = wpabuf_alloc(ANQP_CACHE_ELEM_LEN);
+	if (!buf)
+		return NULL;
+	anqp_build_cached(hapd, buf, req);
+	hapd->anqp_cache[idx] = buf;
+	return buf;
+}
+
+
+static void anqp_add_cached(struct hostapd_data *hapd, struct wpabuf *buf,
+			    u32 req)
+{
+	const struct wpabuf *elem;
+
+	elem = anqp_cache_get(hapd, req);
+	if (elem && wpabuf_tailroom(buf) >= wpabuf_len(elem))
+		wpabuf_put_buf(buf, elem);
+}
+
+
 static struct wpabuf *
 gas_serv_build_gas_resp_payload(struct hostapd_data *hapd,
 				unsigned int request,
@@ -980,16 +1171,46 @@ gas_serv_build_gas_resp_payload(struct hostapd_data *hapd,
 	struct wpabuf *buf;
 	size_t len;
 	unsigned int i;
+	u32 cached;
 
-	len = 1400;
-	if (request & (ANQP_REQ_NAI_REALM | ANQP_REQ_NAI_HOME_REALM))
-		len += 1000;
+	/* The NAI Realm list depends on the query when it is requested
+	 * together with NAI Home Realm Query */
+	cached = request & ~ANQP_REQ_NOT_CACHED;
+	if (request & ANQP_REQ_NAI_HOME_REALM)
+		cached &= ~ANQP_REQ_NAI_REALM;
+
+	len = 0;
+	for (i = 0; i < 32; i++) {
+		const struct wpabuf *elem;
+
+		if (!(cached & BIT(i)))
+			continue;
+		elem = anqp_cache_get(hapd, BIT(i));
+		if (!elem)
+			return NULL;
+		len += wpabuf_len(elem);
+	}
+	if (request & ANQP_REQ_NAI_HOME_REALM)
+		len += anqp_nai_realm_len(hapd, request & ANQP_REQ_NAI_REALM);
+	/* Info ID, Length, OI, Type, Subtype, Reserved, Download Status, Icon
+	 * Type Length, Icon Type, Icon Binary Data Length, Icon Binary Data */
 	if (request & ANQP_REQ_ICON_REQUEST)
-		len += 65536;
+		len += 2 + 2 + 3 + 1 + 1 + 1 + 1 + 1 + 255 + 2 + 65535;
+	for (i = 0; i < num_extra_req; i++) {
 #ifdef CONFIG_FILS
-	if (request & ANQP_FILS_REALM_INFO)
-		len += 2 * dl_list_len(&hapd->conf->fils_realms);
+		if (extra_req[i] == ANQP_FILS_REALM_INFO)
+			len += 2 + 2 +
+				2 * MIN(dl_list_len(&hapd->conf->fils_realms),
+					10000);
 #endif /* CONFIG_FILS */
+		if (extra_req[i] == ANQP_VENUE_URL) {
+			unsigned int j;
+
+			len += 2 + 2;
+			for (j = 0; j < hapd->conf->venue_url_count; j++)
+				len += 2 + hapd->conf->venue_url[j].url_len;
+		}
+	}
 	len += anqp_get_required_len(hapd, extra_req, num_extra_req);
 
 	buf = wpabuf_alloc(len);
@@ -997,37 +1218,39 @@ gas_serv_build_gas_resp_payload(struct hostapd_data *hapd,
 		return NULL;
 
 	if (request & ANQP_REQ_CAPABILITY_LIST)
-		anqp_add_capab_list(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_CAPABILITY_LIST);
 	if (request & ANQP_REQ_VENUE_NAME)
-		anqp_add_venue_name(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_VENUE_NAME);
 	if (request & ANQP_REQ_EMERGENCY_CALL_NUMBER)
-		anqp_add_elem(hapd, buf, ANQP_EMERGENCY_CALL_NUMBER);
+		anqp_add_cached(hapd, buf, ANQP_REQ_EMERGENCY_CALL_NUMBER);
 	if (request & ANQP_REQ_NETWORK_AUTH_TYPE)
-		anqp_add_network_auth_type(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_NETWORK_AUTH_TYPE);
 	if (request & ANQP_REQ_ROAMING_CONSORTIUM)
-		anqp_add_roaming_consortium(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_ROAMING_CONSORTIUM);
 	if (request & ANQP_REQ_IP_ADDR_TYPE_AVAILABILITY)
-		anqp_add_ip_addr_type_availability(hapd, buf);
-	if (request & (ANQP_REQ_NAI_REALM | ANQP_REQ_NAI_HOME_REALM))
+		anqp_add_cached(hapd, buf, ANQP_REQ_IP_ADDR_TYPE_AVAILABILITY);
+	if (cached & ANQP_REQ_NAI_REALM)
+		anqp_add_cached(hapd, buf, ANQP_REQ_NAI_REALM);
+	else if (request & (ANQP_REQ_NAI_REALM | ANQP_REQ_NAI_HOME_REALM))
 		anqp_add_nai_realm(hapd, buf, home_realm, home_realm_len,
 				   request & ANQP_REQ_NAI_REALM,
 				   request & ANQP_REQ_NAI_HOME_REALM);
 	if (request & ANQP_REQ_3GPP_CELLULAR_NETWORK)
-		anqp_add_3gpp_cellular_network(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_3GPP_CELLULAR_NETWORK);
 	if (request & ANQP_REQ_AP_GEOSPATIAL_LOCATION)
-		anqp_add_elem(hapd, buf, ANQP_AP_GEOSPATIAL_LOCATION);
+		anqp_add_cached(hapd, buf, ANQP_REQ_AP_GEOSPATIAL_LOCATION);
 	if (request & ANQP_REQ_AP_CIVIC_LOCATION)
-		anqp_add_elem(hapd, buf, ANQP_AP_CIVIC_LOCATION);
+		anqp_add_cached(hapd, buf, ANQP_REQ_AP_CIVIC_LOCATION);
 	if (request & ANQP_REQ_AP_LOCATION_PUBLIC_URI)
-		anqp_add_elem(hapd, buf, ANQP_AP_LOCATION_PUBLIC_URI);
+		anqp_add_cached(hapd, buf, ANQP_REQ_AP_LOCATION_PUBLIC_URI);
 	if (request & ANQP_REQ_DOMAIN_NAME)
-		anqp_add_domain_name(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_DOMAIN_NAME);
 	if (request & ANQP_REQ_EMERGENCY_ALERT_URI)
-		anqp_add_elem(hapd, buf, ANQP_EMERGENCY_ALERT_URI);
+		anqp_add_cached(hapd, buf, ANQP_REQ_EMERGENCY_ALERT_URI);
 	if (request & ANQP_REQ_TDLS_CAPABILITY)
-		anqp_add_elem(hapd, buf, ANQP_TDLS_CAPABILITY);
+		anqp_add_cached(hapd, buf, ANQP_REQ_TDLS_CAPABILITY);
 	if (request & ANQP_REQ_EMERGENCY_NAI)
-		anqp_add_elem(hapd, buf, ANQP_EMERGENCY_NAI);
+		anqp_add_cached(hapd, buf, ANQP_REQ_EMERGENCY_NAI);
 
 	for (i = 0; i < num_extra_req; i++) {
 #ifdef CONFIG_FILS
@@ -1045,28 +1268,28 @@ gas_serv_build_gas_resp_payload(struct hostapd_data *hapd,
 
 #ifdef CONFIG_HS20
 	if (request & ANQP_REQ_HS_CAPABILITY_LIST)
-		anqp_add_hs_capab_list(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_HS_CAPABILITY_LIST);
 	if (request & ANQP_REQ_OPERATOR_FRIENDLY_NAME)
-		anqp_add_operator_friendly_name(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_OPERATOR_FRIENDLY_NAME);
 	if (request & ANQP_REQ_WAN_METRICS)
-		anqp_add_wan_metrics(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_WAN_METRICS);
 	if (request & ANQP_REQ_CONNECTION_CAPABILITY)
-		anqp_add_connection_capability(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_CONNECTION_CAPABILITY);
 	if (request & ANQP_REQ_OPERATING_CLASS)
-		anqp_add_operating_class(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_OPERATING_CLASS);
 	if (request & ANQP_REQ_OSU_PROVIDERS_LIST)
-		anqp_add_osu_providers_list(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_OSU_PROVIDERS_LIST);
 	if (request & ANQP_REQ_ICON_REQUEST)
 		anqp_add_icon_binary_file(hapd, buf, icon_name, icon_name_len);
 	if (request & ANQP_REQ_OPERATOR_ICON_METADATA)
-		anqp_add_operator_icon_metadata(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_OPERATOR_ICON_METADATA);
 	if (request & ANQP_REQ_OSU_PROVIDERS_NAI_LIST)
-		anqp_add_osu_providers_nai_list(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_OSU_PROVIDERS_NAI_LIST);
 #endif /* CONFIG_HS20 */
 
 #ifdef CONFIG_MBO
 	if (request & ANQP_REQ_MBO_CELL_DATA_CONN_PREF)
-		anqp_add_mbo_cell_data_conn_pref(hapd, buf);
+		anqp_add_cached(hapd, buf, ANQP_REQ_MBO_CELL_DATA_CONN_PREF);
 #endif /* CONFIG_MBO */
 
 	return buf;
@@ -1892,4 +2115,5 @@ int gas_serv_init(struct hostapd_data *hapd)
 
 void gas_serv_deinit(struct hostapd_data *hapd)
 {
+	gas_serv_anqp_cache_flush(hapd);
 }
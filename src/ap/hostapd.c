@@ -37,6 +37,7 @@
 #include "dpp_hostapd.h"
 #include "gas_query_ap.h"
 #include "hw_features.h"
+#include "ctrl_iface_ap.h"
 #include "wpa_auth_glue.h"
 #include "ap_drv_ops.h"
 #include "ap_config.h"
@@ -131,6 +132,10 @@ static void hostapd_reload_bss(struct hostapd_data *hapd)
 {
 	struct hostapd_ssid *ssid;
 
+#ifdef CONFIG_INTERWORKING
+	gas_serv_anqp_cache_invalidate();
+#endif /* CONFIG_INTERWORKING */
+
 	if (!hapd->started)
 		return;
 
@@ -227,6 +232,69 @@ static void hostapd_clear_old(struct hostapd_iface *iface)
 }
 
 
+static int hostapd_bss_conf_changed(struct hostapd_bss_config *newconf,
+				    struct hostapd_bss_config *oldconf)
+{
+	if (newconf->config_id || oldconf->config_id)
+		return !newconf->config_id || !oldconf->config_id ||
+			os_strcmp(newconf->config_id, oldconf->config_id) != 0;
+
+	/* Without an explicit config_id, compare the parameters that cannot be
+	 * changed without disconnecting stations */
+	return !newconf->config_digest_set || !oldconf->config_digest_set ||
+		os_memcmp(newconf->config_digest, oldconf->config_digest,
+			  SHA256_MAC_LEN) != 0;
+}
+
+
+static int hostapd_reload_sta_psk_allowed(struct hostapd_data *hapd,
+					  struct sta_info *sta)
+{
+	struct hostapd_wpa_psk *psk;
+	const u8 *pmk;
+	int pmk_len;
+
+	if (!sta->wpa_sm ||
+	    !wpa_key_mgmt_wpa_psk_no_sae(wpa_auth_sta_key_mgmt(sta->wpa_sm)))
+		return 1;
+
+	pmk = wpa_auth_get_pmk(sta->wpa_sm, &pmk_len);
+	for (psk = hapd->conf->ssid.wpa_psk; pmk && psk; psk = psk->next) {
+		if (pmk_len == PMK_LEN &&
+		    os_memcmp(psk->psk, pmk, PMK_LEN) == 0 &&
+		    (psk->group || ether_addr_equal(sta->addr, psk->addr)))
+			return 1;
+	}
+
+	return 0;
+}
+
+
+/* Disconnect the stations that the reloaded ACL and PSK files no longer allow
+ * while keeping all other stations of the BSS associated. */
+static void hostapd_reload_bss_stations(struct hostapd_data *hapd)
+{
+	struct sta_info *sta;
+
+	hostapd_disassoc_deny_mac(hapd);
+	hostapd_disassoc_accept_mac(hapd);
+
+	if (!hapd->conf->ssid.wpa_psk_file)
+		return;
+
+	for (sta = hapd->sta_list; sta; sta = sta->next) {
+		if (!(sta->flags & WLAN_STA_ASSOC) ||
+		    hostapd_reload_sta_psk_allowed(hapd, sta))
+			continue;
+		wpa_printf(MSG_INFO, "STA " MACSTR
+			   " PSK no longer allowed after configuration reload - disconnect",
+			   MAC2STR(sta->addr));
+		ap_sta_disconnect(hapd, sta, sta->addr,
+				  WLAN_REASON_PREV_AUTH_NOT_VALID);
+	}
+}
+
+
 static int hostapd_iface_conf_changed(struct hostapd_config *newconf,
 				      struct hostapd_config *oldconf)
 {
@@ -300,13 +368,19 @@ int hostapd_reload_config(struct hostapd_iface *iface)
 		return res;
 	}
 	iface->conf = newconf;
+	hostapd_radio_elems_flush(iface);
 
 	for (j = 0; j < iface->num_bss; j++) {
+		bool changed;
+
 		hapd = iface->bss[j];
-		if (!hapd->conf->config_id || !newconf->bss[j]->config_id ||
-		    os_strcmp(hapd->conf->config_id,
-			      newconf->bss[j]->config_id) != 0)
+		changed = hostapd_bss_conf_changed(newconf->bss[j], hapd->conf);
+		if (changed)
 			hostapd_clear_old_bss(hapd);
+		else
+			wpa_printf(MSG_DEBUG,
+				   "BSS %s: No changes requiring station disconnection",
+				   hapd->conf->iface);
 		hapd->iconf = newconf;
 		hapd->iconf->channel = oldconf->channel;
 		hapd->iconf->acs = oldconf->acs;
@@ -325,6 +399,8 @@ int hostapd_reload_config(struct hostapd_iface *iface)
 			hostapd_get_oper_centr_freq_seg1_idx(oldconf));
 		hapd->conf = newconf->bss[j];
 		hostapd_reload_bss(hapd);
+		if (!changed)
+			hostapd_reload_bss_stations(hapd);
 	}
 
 	hostapd_config_free(oldconf);
@@ -550,6 +626,7 @@ void hostapd_free_hapd_data(struct hostapd_data *hapd)
 
 	wpabuf_free(hapd->time_adv);
 	hapd->time_adv = NULL;
+	hostapd_probe_resp_tmpl_flush(hapd);
 
 #ifdef CONFIG_INTERWORKING
 	gas_serv_deinit(hapd);
@@ -585,17 +662,7 @@ void hostapd_free_hapd_data(struct hostapd_data *hapd)
 #endif /* CONFIG_OCV */
 
 #ifdef CONFIG_SAE
-	{
-		struct hostapd_sae_commit_queue *q;
-
-		while ((q = dl_list_first(&hapd->sae_commit_queue,
-					  struct hostapd_sae_commit_queue,
-					  list))) {
-			dl_list_del(&q->list);
-			os_free(q);
-		}
-	}
-	eloop_cancel_timeout(auth_sae_process_commit, hapd, NULL);
+	auth_sae_queue_flush(hapd);
 #endif /* CONFIG_SAE */
 
 #ifdef CONFIG_IEEE80211AX
@@ -666,6 +733,7 @@ void hostapd_cleanup_iface_partial(struct hostapd_iface *iface)
 	ap_list_deinit(iface);
 	sta_track_deinit(iface);
 	airtime_policy_update_deinit(iface);
+	hostapd_radio_elems_flush(iface);
 }
 
 
@@ -162,6 +162,107 @@ struct hostapd_sae_commit_queue {
 	u8 msg[];
 };
 
+/**
+ * struct hostapd_probe_resp_tmpl - Prebuilt Probe Response frame
+ * @resp: Probe Response frame; DA is filled in for each response
+ * @resp_len: Length of the frame in octets
+ * @gen: Beacon update generation at the time the frame was built
+ * @num_sta: Number of associated STAs at the time the frame was built
+ */
+struct hostapd_probe_resp_tmpl {
+	struct ieee80211_mgmt *resp;
+	size_t resp_len;
+	unsigned int gen;
+	int num_sta;
+};
+
+/**
+ * struct hostapd_probe_filter - Radio level Probe Request prefilter
+ * @ssid_bloom: Bloom filter of the Short SSIDs of all BSSs on the radio
+ * @gen: Beacon update generation at the time the filter was built
+ * @valid: Whether the filter has been built
+ * @hidden: Whether all BSSs ignore Probe Request frames for the wildcard SSID
+ * @bypass: Whether a BSS needs to see all Probe Request frames
+ *
+ * The counters track the Probe Request frames that were passed to the BSSs
+ * and the frames that were dropped by the filter, by reason.
+ */
+struct hostapd_probe_filter {
+	u8 ssid_bloom[128];
+	unsigned int gen;
+	bool valid;
+	bool hidden;
+	bool bypass;
+
+	unsigned long passed;
+	unsigned long bypassed;
+	unsigned long malformed;
+	unsigned long no_ssid;
+	unsigned long ds_mismatch;
+	unsigned long broadcast;
+	unsigned long foreign_ssid;
+};
+
+/**
+ * enum hostapd_radio_elem - Groups of radio level elements
+ * @RADIO_ELEM_COUNTRY: Country and Power Constraint elements
+ * @RADIO_ELEM_HT: Supported Operating Classes, HT Capabilities, and HT Operation
+ *	elements
+ * @RADIO_ELEM_VHT: VHT Capabilities, VHT Operation, and Transmit Power Envelope
+ *	elements
+ * @RADIO_ELEM_TPE: Transmit Power Envelope elements on the 6 GHz band
+ * @RADIO_ELEM_HE_CAPAB: HE Capabilities element
+ * @RADIO_ELEM_HE_PARAMS: Spatial Reuse Parameter Set, MU EDCA Parameter Set,
+ *	and HE 6 GHz Band Capabilities elements
+ * @RADIO_ELEM_EHT_CAPAB: EHT Capabilities element
+ */
+enum hostapd_radio_elem {
+	RADIO_ELEM_COUNTRY,
+	RADIO_ELEM_HT,
+	RADIO_ELEM_VHT,
+	RADIO_ELEM_TPE,
+	RADIO_ELEM_HE_CAPAB,
+	RADIO_ELEM_HE_PARAMS,
+	RADIO_ELEM_EHT_CAPAB,
+	NUM_RADIO_ELEM
+};
+
+/**
+ * struct hostapd_radio_elems - Radio level elements shared by all BSSs
+ * @conf: Interface configuration the elements were built from
+ * @mode: Hardware mode the elements were built for
+ * @chan: Operating channel parameters the elements were built for
+ * @gen: Configuration generation at the time the elements were built
+ * @used: Counter value for selecting the least recently used entry
+ * @valid: Whether this entry is in use
+ * @elem: Elements for each group; %NULL if not yet built
+ *
+ * These elements depend only on the radio configuration and operating channel,
+ * so they are built once and copied into the Beacon and Probe Response frames
+ * of each BSS. Two entries are maintained to cover the current and the new
+ * channel while building the frames for a channel switch.
+ */
+struct hostapd_radio_elems {
+	const struct hostapd_config *conf;
+	const struct hostapd_hw_modes *mode;
+	struct hostapd_radio_elems_chan {
+		int freq;
+		u8 channel;
+		u8 op_class;
+		int secondary_channel;
+		u8 oper_chwidth;
+		u8 seg0_idx;
+		u8 seg1_idx;
+		u16 ht_op_mode;
+		u16 ht_capab;
+		u32 vht_capab;
+	} chan;
+	unsigned int gen;
+	unsigned int used;
+	bool valid;
+	struct wpabuf *elem[NUM_RADIO_ELEM];
+};
+
 /**
  * struct hostapd_data - hostapd per-BSS data structure
  */
@@ -257,6 +358,8 @@ struct hostapd_data {
 	int beacon_set_done;
 	struct wpabuf *wps_beacon_ie;
 	struct wpabuf *wps_probe_resp_ie;
+	/* Probe Response frame templates without and with P2P IE */
+	struct hostapd_probe_resp_tmpl probe_resp_tmpl[2];
 #ifdef CONFIG_WPS
 	unsigned int ap_pin_failures;
 	unsigned int ap_pin_failures_consecutive;
@@ -279,6 +382,10 @@ struct hostapd_data {
 	void (*public_action_cb2)(void *ctx, const u8 *buf, size_t len,
 				  int freq);
 	void *public_action_cb2_ctx;
+	/* Cached ANQP-elements built from the configuration indexed by the
+	 * ANQP_REQ_* bit number */
+	struct wpabuf *anqp_cache[32];
+	unsigned int anqp_cache_gen;
 
 	int (*vendor_action_cb)(void *ctx, const u8 *buf, size_t len,
 				int freq);
@@ -370,6 +477,9 @@ struct hostapd_data {
 	u16 comeback_pending_idx[COMEBACK_PENDING_IDX_SIZE];
 	int dot11RSNASAERetransPeriod; /* msec */
 	struct dl_list sae_commit_queue; /* struct hostapd_sae_commit_queue */
+	/* Entry in the SAE commit queue round-robin list while queue is not
+	 * empty */
+	struct dl_list sae_commit_sched;
 #endif /* CONFIG_SAE */
 
 #ifdef CONFIG_TESTING_OPTIONS
@@ -644,6 +754,8 @@ struct hostapd_iface {
 
 #ifdef CONFIG_ACS
 	unsigned int acs_num_completed_scans;
+	/* frequency indexed channel lookup table used during an ACS study */
+	struct hostapd_channel_data **acs_chan_idx;
 #endif /* CONFIG_ACS */
 
 	void (*scan_cb)(struct hostapd_iface *iface);
@@ -652,6 +764,14 @@ struct hostapd_iface {
 	struct dl_list sta_seen; /* struct hostapd_sta_info */
 	unsigned int num_sta_seen;
 
+	struct hostapd_probe_filter probe_filter;
+
+	struct hostapd_radio_elems radio_elems[2];
+	struct hostapd_radio_elems *cur_radio_elems;
+	unsigned int radio_elems_used;
+	unsigned long radio_elems_hits;
+	unsigned long radio_elems_misses;
+
 	u8 dfs_domain;
 #ifdef CONFIG_AIRTIME_POLICY
 	unsigned int airtime_quantum;
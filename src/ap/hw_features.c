@@ -115,6 +115,8 @@ int hostapd_get_hw_features(struct hostapd_iface *iface)
 	hostapd_free_hw_features(iface->hw_features, iface->num_hw_features);
 	iface->hw_features = modes;
 	iface->num_hw_features = num_modes;
+	/* The radio level elements depend on the channel flags */
+	hostapd_radio_elems_flush(iface);
 
 	for (i = 0; i < num_modes; i++) {
 		struct hostapd_hw_modes *feature = &modes[i];
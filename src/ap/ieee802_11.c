@@ -1631,28 +1631,67 @@ int auth_sae_init_committed(struct hostapd_data *hapd, struct sta_info *sta)
 }
 
 
-void auth_sae_process_commit(void *eloop_ctx, void *user_ctx)
+/* BSSs that have queued SAE commit messages (struct hostapd_data::
+ * sae_commit_sched). A single timeout serves the queues of all BSSs on all
+ * interfaces in round-robin order so that a commit flood on one BSS cannot
+ * starve the others and the total time spent on queued commits remains bounded
+ * independently of the number of radios under attack. */
+static DEFINE_DL_LIST(sae_commit_sched);
+
+
+static unsigned int auth_sae_queued_total(void)
 {
-	struct hostapd_data *hapd = eloop_ctx;
+	struct hostapd_data *hapd;
+	unsigned int len = 0;
+
+	dl_list_for_each(hapd, &sae_commit_sched, struct hostapd_data,
+			 sae_commit_sched)
+		len += dl_list_len(&hapd->sae_commit_queue);
+
+	return len;
+}
+
+
+static void auth_sae_process_commit(void *eloop_ctx, void *user_ctx);
+
+static void auth_sae_schedule(unsigned int queue_len)
+{
+	if (dl_list_empty(&sae_commit_sched) ||
+	    eloop_is_timeout_registered(auth_sae_process_commit, NULL, NULL))
+		return;
+	eloop_register_timeout(0, queue_len * 10000, auth_sae_process_commit,
+			       NULL, NULL);
+}
+
+
+static void auth_sae_process_commit(void *eloop_ctx, void *user_ctx)
+{
+	struct hostapd_data *hapd;
 	struct hostapd_sae_commit_queue *q;
-	unsigned int queue_len;
 
+	hapd = dl_list_first(&sae_commit_sched, struct hostapd_data,
+			     sae_commit_sched);
+	if (!hapd)
+		return;
 	q = dl_list_first(&hapd->sae_commit_queue,
 			  struct hostapd_sae_commit_queue, list);
-	if (!q)
-		return;
-	wpa_printf(MSG_DEBUG,
-		   "SAE: Process next available message from queue");
-	dl_list_del(&q->list);
-	handle_auth(hapd, (const struct ieee80211_mgmt *) q->msg, q->len,
-		    q->rssi, 1);
-	os_free(q);
+	dl_list_del(&hapd->sae_commit_sched);
+	if (q) {
+		dl_list_del(&q->list);
+		/* Give the other BSSs a turn before the next message from this
+		 * BSS */
+		if (!dl_list_empty(&hapd->sae_commit_queue))
+			dl_list_add_tail(&sae_commit_sched,
+					 &hapd->sae_commit_sched);
+		wpa_printf(MSG_DEBUG,
+			   "SAE: Process next available message from queue (%s)",
+			   hapd->conf->iface);
+		handle_auth(hapd, (const struct ieee80211_mgmt *) q->msg,
+			    q->len, q->rssi, 1);
+		os_free(q);
+	}
 
-	if (eloop_is_timeout_registered(auth_sae_process_commit, hapd, NULL))
-		return;
-	queue_len = dl_list_len(&hapd->sae_commit_queue);
-	eloop_register_timeout(0, queue_len * 10000, auth_sae_process_commit,
-			       hapd, NULL);
+	auth_sae_schedule(auth_sae_queued_total());
 }
 
 
@@ -1707,10 +1746,30 @@ static void auth_sae_queue(struct hostapd_data *hapd,
 	dl_list_add_tail(&hapd->sae_commit_queue, &q->list);
 
 queued:
-	if (eloop_is_timeout_registered(auth_sae_process_commit, hapd, NULL))
-		return;
-	eloop_register_timeout(0, queue_len * 10000, auth_sae_process_commit,
-			       hapd, NULL);
+	if (!hapd->sae_commit_sched.next)
+		dl_list_add_tail(&sae_commit_sched, &hapd->sae_commit_sched);
+	auth_sae_schedule(auth_sae_queued_total() - 1);
+}
+
+
+/**
+ * auth_sae_queue_flush - Drop all queued SAE messages of a BSS
+ * @hapd: BSS data
+ */
+void auth_sae_queue_flush(struct hostapd_data *hapd)
+{
+	struct hostapd_sae_commit_queue *q;
+
+	while ((q = dl_list_first(&hapd->sae_commit_queue,
+				  struct hostapd_sae_commit_queue, list))) {
+		dl_list_del(&q->list);
+		os_free(q);
+	}
+
+	if (hapd->sae_commit_sched.next)
+		dl_list_del(&hapd->sae_commit_sched);
+	if (dl_list_empty(&sae_commit_sched))
+		eloop_cancel_timeout(auth_sae_process_commit, NULL, NULL);
 }
 
 
@@ -4840,6 +4899,9 @@ static u16 send_assoc_resp(struct hostapd_data *hapd, struct sta_info *sta,
 	}
 #endif /* CONFIG_IEEE80211BE */
 
+	/* Allocate the temporary buffers for the elements from the arena */
+	wpabuf_arena_begin();
+
 	buf = os_zalloc(buflen);
 	if (!buf) {
 		res = WLAN_STATUS_UNSPECIFIED_FAILURE;
@@ -5143,6 +5205,7 @@ rsnxe_done:
 
 done:
 	os_free(buf);
+	wpabuf_arena_end();
 	return res;
 }
 
@@ -50,6 +50,8 @@ static void ap_sa_query_timer(void *eloop_ctx, void *timeout_ctx);
 static int ap_sta_remove(struct hostapd_data *hapd, struct sta_info *sta);
 static void ap_sta_delayed_1x_auth_fail_cb(void *eloop_ctx, void *timeout_ctx);
 
+static struct os_pool sta_info_pool = OS_POOL_INIT("sta_info", struct sta_info);
+
 int ap_for_each_sta(struct hostapd_data *hapd,
 		    int (*cb)(struct hostapd_data *hapd, struct sta_info *sta,
 			      void *ctx),
@@ -430,7 +432,7 @@ void ap_free_sta(struct hostapd_data *hapd, struct sta_info *sta)
 	forced_memzero(sta->last_tk, WPA_TK_MAX_LEN);
 #endif /* CONFIG_TESTING_OPTIONS */
 
-	os_free(sta);
+	os_pool_free(&sta_info_pool, sta);
 }
 
 
@@ -740,14 +742,14 @@ struct sta_info * ap_sta_add(struct hostapd_data *hapd, const u8 *addr)
 		return NULL;
 	}
 
-	sta = os_zalloc(sizeof(struct sta_info));
+	sta = os_pool_zalloc(&sta_info_pool);
 	if (sta == NULL) {
 		wpa_printf(MSG_ERROR, "malloc failed");
 		return NULL;
 	}
 	sta->acct_interim_interval = hapd->conf->acct_interim_interval;
 	if (accounting_sta_get_id(hapd, sta) < 0) {
-		os_free(sta);
+		os_pool_free(&sta_info_pool, sta);
 		return NULL;
 	}
 
@@ -36,6 +36,9 @@ int hostapd_register_probereq_cb(struct hostapd_data *hapd,
 	n->cb = cb;
 	n->ctx = ctx;
 
+	/* The callback needs to see all Probe Request frames */
+	hapd->iface->probe_filter.valid = false;
+
 	return 0;
 }
 
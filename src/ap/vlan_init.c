@@ -11,10 +11,12 @@
 #include "utils/includes.h"
 
 #include "utils/common.h"
+#include "utils/eloop.h"
 #include "hostapd.h"
 #include "ap_config.h"
 #include "ap_drv_ops.h"
 #include "wpa_auth.h"
+#include "vlan.h"
 #include "vlan_init.h"
 #include "vlan_util.h"
 
@@ -130,6 +132,131 @@ static void vlan_dynamic_remove(struct hostapd_data *hapd,
 }
 
 
+static int vlan_prewarm(struct hostapd_data *hapd)
+{
+	struct hostapd_vlan *wildcard, *vlan;
+	struct vlan_description desc;
+	int *id;
+
+	for (wildcard = hapd->conf->vlan; wildcard; wildcard = wildcard->next) {
+		if (wildcard->vlan_id == VLAN_ID_WILDCARD)
+			break;
+	}
+	if (!wildcard) {
+		wpa_printf(MSG_ERROR,
+			   "VLAN: vlan_prewarm requires dynamic VLAN interfaces");
+		return -1;
+	}
+
+	for (id = hapd->conf->ssid.vlan_prewarm; *id; id++) {
+		os_memset(&desc, 0, sizeof(desc));
+		desc.notempty = 1;
+		desc.untagged = *id;
+
+		for (vlan = hapd->conf->vlan; vlan; vlan = vlan->next) {
+			if (!vlan_compare(&vlan->vlan_desc, &desc))
+				break;
+		}
+		if (vlan)
+			continue;
+
+		/* The reference from vlan_add_dynamic() is kept until deinit
+		 * so that the interface is not removed when not in use. */
+		vlan = vlan_add_dynamic(hapd, wildcard, *id, &desc);
+		if (!vlan) {
+			wpa_printf(MSG_ERROR,
+				   "VLAN: Could not prewarm VLAN %d", *id);
+			return -1;
+		}
+		wpa_printf(MSG_DEBUG, "VLAN: Prewarmed VLAN interface %s",
+			   vlan->ifname);
+	}
+
+	return 0;
+}
+
+
+static void vlan_remove_iface(struct hostapd_data *hapd,
+			      struct hostapd_vlan *vlan)
+{
+	vlan_if_remove(hapd, vlan);
+#ifdef CONFIG_FULL_DYNAMIC_VLAN
+	vlan_dellink(vlan->ifname, hapd);
+#endif /* CONFIG_FULL_DYNAMIC_VLAN */
+}
+
+
+static void vlan_linger_timeout(void *eloop_ctx, void *timeout_ctx);
+
+static void vlan_linger_schedule(struct hostapd_data *hapd)
+{
+	struct hostapd_vlan *vlan, *first = NULL;
+	struct os_reltime now, diff;
+
+	eloop_cancel_timeout(vlan_linger_timeout, hapd, NULL);
+
+	for (vlan = hapd->conf->vlan; vlan; vlan = vlan->next) {
+		if (vlan->linger &&
+		    (!first || os_reltime_before(&vlan->linger_expire,
+						 &first->linger_expire)))
+			first = vlan;
+	}
+	if (!first)
+		return;
+
+	os_get_reltime(&now);
+	if (os_reltime_before(&now, &first->linger_expire))
+		os_reltime_sub(&first->linger_expire, &now, &diff);
+	else
+		diff.sec = diff.usec = 0;
+	eloop_register_timeout(diff.sec, diff.usec, vlan_linger_timeout, hapd,
+			       NULL);
+}
+
+
+static void vlan_linger_timeout(void *eloop_ctx, void *timeout_ctx)
+{
+	struct hostapd_data *hapd = eloop_ctx;
+	struct hostapd_vlan *vlan, *next;
+	struct os_reltime now;
+
+	os_get_reltime(&now);
+	for (vlan = hapd->conf->vlan; vlan; vlan = next) {
+		next = vlan->next;
+		if (!vlan->linger ||
+		    os_reltime_before(&now, &vlan->linger_expire))
+			continue;
+
+		/* Drop the grace period reference */
+		vlan->linger = 0;
+		if (--vlan->dynamic_vlan > 0)
+			continue;
+
+		wpa_printf(MSG_DEBUG,
+			   "VLAN: Remove unused VLAN interface %s after grace period",
+			   vlan->ifname);
+		vlan_remove_iface(hapd, vlan);
+	}
+
+	vlan_linger_schedule(hapd);
+}
+
+
+static void vlan_linger_start(struct hostapd_data *hapd,
+			      struct hostapd_vlan *vlan)
+{
+	if (!vlan->linger) {
+		vlan->linger = 1;
+		vlan->dynamic_vlan++;
+	}
+	os_get_reltime(&vlan->linger_expire);
+	vlan->linger_expire.sec += hapd->conf->ssid.vlan_remove_grace;
+	wpa_printf(MSG_DEBUG, "VLAN: Keep unused VLAN interface %s for %u s",
+		   vlan->ifname, hapd->conf->ssid.vlan_remove_grace);
+	vlan_linger_schedule(hapd);
+}
+
+
 int vlan_init(struct hostapd_data *hapd)
 {
 #ifdef CONFIG_FULL_DYNAMIC_VLAN
@@ -168,12 +295,16 @@ int vlan_init(struct hostapd_data *hapd)
 	if (vlan_dynamic_add(hapd, hapd->conf->vlan))
 		return -1;
 
+	if (hapd->conf->ssid.vlan_prewarm && vlan_prewarm(hapd) < 0)
+		return -1;
+
         return 0;
 }
 
 
 void vlan_deinit(struct hostapd_data *hapd)
 {
+	eloop_cancel_timeout(vlan_linger_timeout, hapd, NULL);
 	vlan_dynamic_remove(hapd, hapd->conf->vlan);
 
 #ifdef CONFIG_FULL_DYNAMIC_VLAN
@@ -256,11 +387,16 @@ int vlan_remove_dynamic(struct hostapd_data *hapd, int vlan_id)
 	if (vlan == NULL)
 		return 1;
 
-	if (vlan->dynamic_vlan == 0) {
-		vlan_if_remove(hapd, vlan);
-#ifdef CONFIG_FULL_DYNAMIC_VLAN
-		vlan_dellink(vlan->ifname, hapd);
-#endif /* CONFIG_FULL_DYNAMIC_VLAN */
+	if ((vlan->dynamic_vlan == 0 ||
+	     (vlan->linger && vlan->dynamic_vlan == 1)) &&
+	    hapd->conf->ssid.vlan_remove_grace &&
+	    !hapd->conf->ssid.per_sta_vif) {
+		/* Keep the interface for reuse by another station and
+		 * remove it only once it has not been used for the grace
+		 * period */
+		vlan_linger_start(hapd, vlan);
+	} else if (vlan->dynamic_vlan == 0) {
+		vlan_remove_iface(hapd, vlan);
 	}
 
 	return 0;
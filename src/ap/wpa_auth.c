@@ -83,6 +83,9 @@ static const int dot11RSNAConfigPMKLifetime = 43200;
 static const int dot11RSNAConfigPMKReauthThreshold = 70;
 static const int dot11RSNAConfigSATimeout = 60;
 
+static struct os_pool wpa_sm_pool =
+	OS_POOL_INIT("wpa_state_machine", struct wpa_state_machine);
+
 
 static const u8 * wpa_auth_get_aa(const struct wpa_state_machine *sm)
 {
@@ -740,7 +743,7 @@ wpa_auth_sta_init(struct wpa_authenticator *wpa_auth, const u8 *addr,
 	if (wpa_auth->group->wpa_group_state == WPA_GROUP_FATAL_FAILURE)
 		return NULL;
 
-	sm = os_zalloc(sizeof(struct wpa_state_machine));
+	sm = os_pool_zalloc(&wpa_sm_pool);
 	if (!sm)
 		return NULL;
 	os_memcpy(sm->addr, addr, ETH_ALEN);
@@ -846,7 +849,8 @@ static void wpa_free_sta_sm(struct wpa_state_machine *sm)
 #ifdef CONFIG_DPP2
 	wpabuf_clear_free(sm->dpp_z);
 #endif /* CONFIG_DPP2 */
-	bin_clear_free(sm, sizeof(*sm));
+	forced_memzero(sm, sizeof(*sm));
+	os_pool_free(&wpa_sm_pool, sm);
 }
 
 
@@ -84,6 +84,43 @@ static const struct ieee802_11_parse_test_data parse_tests[] = {
 	{ NULL, 0, ParseOK, 0 }
 };
 
+static int ieee802_11_elem_index_test(const u8 *data, size_t len)
+{
+	struct ieee802_11_elem_index idx;
+	u8 ids[IEEE802_11_ELEM_INDEX_MAX];
+	const u8 vendor_id = WLAN_EID_VENDOR_SPECIFIC;
+	int res;
+	unsigned int id, i;
+
+	for (id = 0; id < 256; id += ARRAY_SIZE(ids)) {
+		for (i = 0; i < ARRAY_SIZE(ids); i++)
+			ids[i] = id + i;
+		res = ieee802_11_elem_index_build(data, len, ids,
+						  ARRAY_SIZE(ids), ids,
+						  ARRAY_SIZE(ids), &idx);
+		if (res == 0 &&
+		    (int) idx.count != ieee802_11_ie_count(data, len))
+			return -1;
+
+		for (i = 0; i < ARRAY_SIZE(ids); i++) {
+			if (ieee802_11_elem_index_get(&idx, ids[i]) !=
+			    get_ie(data, len, ids[i]) ||
+			    ieee802_11_elem_index_get_ext(&idx, ids[i]) !=
+			    get_ie_ext(data, len, ids[i]))
+				return -1;
+		}
+	}
+
+	ieee802_11_elem_index_build(data, len, &vendor_id, 1, NULL, 0, &idx);
+	if (ieee802_11_elem_index_get(&idx, WLAN_EID_SSID) ||
+	    ieee802_11_elem_index_get_vendor(&idx, WMM_IE_VENDOR_TYPE) !=
+	    get_vendor_ie(data, len, WMM_IE_VENDOR_TYPE))
+		return -1;
+
+	return 0;
+}
+
+
 static int ieee802_11_parse_tests(void)
 {
 	int i, ret = 0;
@@ -104,6 +141,19 @@ static int ieee802_11_parse_tests(void)
 				   i);
 			ret = -1;
 		}
+
+		if (ieee802_11_elem_index_test(test->data, test->len) < 0) {
+			wpa_printf(MSG_ERROR,
+				   "ieee802_11_elem_index test %d failed", i);
+			ret = -1;
+		}
+	}
+
+	if (ieee802_11_elem_index_test(
+		    (const u8 *) "\x00\x04test\xdd\x03\x00\x50\xf2\xdd\x07\x00\x50\xf2\x02\x00\x01\x00\xff\x01\x23\x00\x00\xff\x02\x23\x01",
+		    29) < 0) {
+		wpa_printf(MSG_ERROR, "ieee802_11_elem_index test failed");
+		ret = -1;
 	}
 
 	if (ieee802_11_vendor_ie_concat((const u8 *) "\x00\x01", 2, 0) != NULL)
@@ -251,6 +301,47 @@ static int gas_tests(void)
 }
 
 
+#ifdef CONFIG_SAE
+static int sae_pt_commit_test(struct sae_pt *pt, const u8 *addr1,
+			      const u8 *addr2,
+			      const struct crypto_ec_point *pwe)
+{
+	struct sae_data sae;
+	struct crypto_bignum *mask;
+	struct crypto_ec_point *elem;
+	int ret = -1;
+
+	/* COMMIT-ELEMENT may be derived from PT without using PWE, so verify
+	 * that it matches inverse(scalar-op(mask, PWE)) with
+	 * mask = (commit-scalar - rand) mod r */
+	os_memset(&sae, 0, sizeof(sae));
+	mask = crypto_bignum_init();
+	if (!mask || sae_set_group(&sae, pt->group) < 0 ||
+	    sae_prepare_commit_pt(&sae, pt, addr1, addr2, NULL, NULL) < 0)
+		goto fail;
+	elem = crypto_ec_point_init(sae.tmp->ec);
+	if (!elem ||
+	    crypto_bignum_sub(sae.tmp->own_commit_scalar, sae.tmp->sae_rand,
+			      mask) < 0 ||
+	    crypto_bignum_mod(mask, sae.tmp->order, mask) < 0 ||
+	    crypto_ec_point_mul(sae.tmp->ec, pwe, mask, elem) < 0 ||
+	    crypto_ec_point_invert(sae.tmp->ec, elem) < 0 ||
+	    crypto_ec_point_cmp(sae.tmp->ec, elem,
+				sae.tmp->own_commit_element_ecc) != 0) {
+		wpa_printf(MSG_ERROR, "SAE: PT commit-element mismatch");
+		crypto_ec_point_deinit(elem, 1);
+		goto fail;
+	}
+	crypto_ec_point_deinit(elem, 1);
+	ret = 0;
+fail:
+	sae_clear_data(&sae);
+	crypto_bignum_deinit(mask, 1);
+	return ret;
+}
+#endif /* CONFIG_SAE */
+
+
 static int sae_tests(void)
 {
 #ifdef CONFIG_SAE
@@ -475,6 +566,11 @@ static int sae_tests(void)
 				sae_deinit_pt(pt);
 				goto fail;
 			}
+			if (sae_pt_commit_test(pt, addr1b, addr2b, pwe) < 0) {
+				crypto_ec_point_deinit(pwe, 1);
+				sae_deinit_pt(pt);
+				goto fail;
+			}
 			crypto_ec_point_deinit(pwe, 1);
 		}
 
@@ -1489,7 +1489,7 @@ void dpp_auth_deinit(struct dpp_authentication *auth)
 	wpabuf_free(auth->net_access_key);
 	dpp_bootstrap_info_free(auth->tmp_own_bi);
 	if (auth->tmp_peer_bi) {
-		dl_list_del(&auth->tmp_peer_bi->list);
+		dpp_bootstrap_unlink(auth->global, auth->tmp_peer_bi);
 		dpp_bootstrap_info_free(auth->tmp_peer_bi);
 	}
 	os_free(auth->e_name);
@@ -1958,8 +1958,7 @@ static int dpp_get_peer_bi_id(struct dpp_authentication *auth)
 	bi = os_zalloc(sizeof(*bi));
 	if (!bi)
 		return -1;
-	bi->id = dpp_next_id(auth->global);
-	dl_list_add(&auth->global->bootstrap, &bi->list);
+	dpp_bootstrap_add(auth->global, bi);
 	auth->tmp_peer_bi = bi;
 	return bi->id;
 }
@@ -4316,16 +4315,50 @@ int dpp_get_connector_version(const char *connector)
 #endif /* CONFIG_DPP3 */
 
 
-unsigned int dpp_next_id(struct dpp_global *dpp)
+/**
+ * dpp_bootstrap_add - Add bootstrapping information to the global list
+ * @dpp: DPP global context
+ * @bi: Bootstrapping information with the public key hashes already derived
+ *
+ * This assigns the next free identifier to the entry and adds it to the
+ * public key hash indexes used for matching received key hashes.
+ */
+void dpp_bootstrap_add(struct dpp_global *dpp, struct dpp_bootstrap_info *bi)
 {
-	struct dpp_bootstrap_info *bi;
-	unsigned int max_id = 0;
+	struct dpp_bootstrap_info *tmp;
+
+	if (dpp->bootstrap_max_id_stale) {
+		dpp->bootstrap_max_id = 0;
+		dl_list_for_each(tmp, &dpp->bootstrap,
+				 struct dpp_bootstrap_info, list) {
+			if (tmp->id > dpp->bootstrap_max_id)
+				dpp->bootstrap_max_id = tmp->id;
+		}
+		dpp->bootstrap_max_id_stale = false;
+	}
 
-	dl_list_for_each(bi, &dpp->bootstrap, struct dpp_bootstrap_info, list) {
-		if (bi->id > max_id)
-			max_id = bi->id;
+	bi->id = ++dpp->bootstrap_max_id;
+	dl_list_add(&dpp->bootstrap, &bi->list);
+	if (bi->pubkey) {
+		dl_list_add(&dpp->bootstrap_hash[bi->pubkey_hash[0]],
+			    &bi->hash_list);
+		dl_list_add(&dpp->bootstrap_chirp[bi->pubkey_hash_chirp[0]],
+			    &bi->chirp_list);
+	} else {
+		dl_list_init(&bi->hash_list);
+		dl_list_init(&bi->chirp_list);
 	}
-	return max_id + 1;
+}
+
+
+void dpp_bootstrap_unlink(struct dpp_global *dpp,
+			  struct dpp_bootstrap_info *bi)
+{
+	dl_list_del(&bi->list);
+	dl_list_del(&bi->hash_list);
+	dl_list_del(&bi->chirp_list);
+	if (bi->id == dpp->bootstrap_max_id)
+		dpp->bootstrap_max_id_stale = true;
 }
 
 
@@ -4346,7 +4379,7 @@ static int dpp_bootstrap_del(struct dpp_global *dpp, unsigned int id)
 		if (dpp->remove_bi)
 			dpp->remove_bi(dpp->cb_ctx, bi);
 #endif /* CONFIG_DPP2 */
-		dl_list_del(&bi->list);
+		dpp_bootstrap_unlink(dpp, bi);
 		dpp_bootstrap_info_free(bi);
 	}
 
@@ -4369,8 +4402,7 @@ struct dpp_bootstrap_info * dpp_add_qr_code(struct dpp_global *dpp,
 		return NULL;
 
 	bi->type = DPP_BOOTSTRAP_QR_CODE;
-	bi->id = dpp_next_id(dpp);
-	dl_list_add(&dpp->bootstrap, &bi->list);
+	dpp_bootstrap_add(dpp, bi);
 	return bi;
 }
 
@@ -4388,12 +4420,79 @@ struct dpp_bootstrap_info * dpp_add_nfc_uri(struct dpp_global *dpp,
 		return NULL;
 
 	bi->type = DPP_BOOTSTRAP_NFC_URI;
-	bi->id = dpp_next_id(dpp);
-	dl_list_add(&dpp->bootstrap, &bi->list);
+	dpp_bootstrap_add(dpp, bi);
 	return bi;
 }
 
 
+/**
+ * dpp_bootstrap_import - Import peer bootstrapping URIs from a file
+ * @dpp: DPP global context
+ * @fname: File with one DPP URI per line; empty lines and lines starting with
+ *	'#' are ignored
+ * Returns: Number of imported URIs or -1 if the file could not be read
+ *
+ * This is meant for loading large pre-provisioned lists of device
+ * bootstrapping keys. Each URI is added as if it had been scanned from a QR
+ * Code. Invalid lines are reported and skipped.
+ */
+int dpp_bootstrap_import(struct dpp_global *dpp, const char *fname)
+{
+	FILE *f;
+	char buf[1024], *pos, *end;
+	int line = 0, count = 0;
+
+	if (!dpp)
+		return -1;
+
+	f = fopen(fname, "r");
+	if (!f) {
+		wpa_printf(MSG_INFO, "DPP: Could not open bootstrap list '%s'",
+			   fname);
+		return -1;
+	}
+
+	while (fgets(buf, sizeof(buf), f)) {
+		line++;
+
+		end = os_strchr(buf, '\n');
+		if (!end && !feof(f)) {
+			int c;
+
+			wpa_printf(MSG_INFO,
+				   "DPP: Too long URI on line %d in '%s'",
+				   line, fname);
+			while ((c = fgetc(f)) != EOF && c != '\n')
+				;
+			continue;
+		}
+		if (!end)
+			end = buf + os_strlen(buf);
+		while (end > buf && isspace((unsigned char) end[-1]))
+			end--;
+		*end = '\0';
+
+		pos = buf;
+		while (isspace((unsigned char) *pos))
+			pos++;
+		if (*pos == '\0' || *pos == '#')
+			continue;
+
+		if (!dpp_add_qr_code(dpp, pos)) {
+			wpa_printf(MSG_INFO, "DPP: Invalid URI on line %d in '%s'",
+				   line, fname);
+			continue;
+		}
+		count++;
+	}
+
+	fclose(f);
+	wpa_printf(MSG_DEBUG, "DPP: Imported %d bootstrapping URI(s) from '%s'",
+		   count, fname);
+	return count;
+}
+
+
 static int dpp_parse_supported_curves_list(struct dpp_bootstrap_info *bi,
 					   char *txt)
 {
@@ -4481,8 +4580,7 @@ int dpp_bootstrap_gen(struct dpp_global *dpp, const char *cmd)
 	    dpp_gen_uri(bi) < 0)
 		goto fail;
 
-	bi->id = dpp_next_id(dpp);
-	dl_list_add(&dpp->bootstrap, &bi->list);
+	dpp_bootstrap_add(dpp, bi);
 	ret = bi->id;
 	bi = NULL;
 fail:
@@ -4648,25 +4746,28 @@ void dpp_bootstrap_find_pair(struct dpp_global *dpp, const u8 *i_bootstrap,
 	if (!dpp)
 		return;
 
-	dl_list_for_each(bi, &dpp->bootstrap, struct dpp_bootstrap_info, list) {
-		if (!*own_bi && bi->own &&
+	dl_list_for_each(bi, &dpp->bootstrap_hash[r_bootstrap[0]],
+			 struct dpp_bootstrap_info, hash_list) {
+		if (bi->own &&
 		    os_memcmp(bi->pubkey_hash, r_bootstrap,
 			      SHA256_MAC_LEN) == 0) {
 			wpa_printf(MSG_DEBUG,
 				   "DPP: Found matching own bootstrapping information");
 			*own_bi = bi;
+			break;
 		}
+	}
 
-		if (!*peer_bi && !bi->own &&
+	dl_list_for_each(bi, &dpp->bootstrap_hash[i_bootstrap[0]],
+			 struct dpp_bootstrap_info, hash_list) {
+		if (!bi->own &&
 		    os_memcmp(bi->pubkey_hash, i_bootstrap,
 			      SHA256_MAC_LEN) == 0) {
 			wpa_printf(MSG_DEBUG,
 				   "DPP: Found matching peer bootstrapping information");
 			*peer_bi = bi;
-		}
-
-		if (*own_bi && *peer_bi)
 			break;
+		}
 	}
 }
 
@@ -4680,7 +4781,8 @@ struct dpp_bootstrap_info * dpp_bootstrap_find_chirp(struct dpp_global *dpp,
 	if (!dpp)
 		return NULL;
 
-	dl_list_for_each(bi, &dpp->bootstrap, struct dpp_bootstrap_info, list) {
+	dl_list_for_each(bi, &dpp->bootstrap_chirp[hash[0]],
+			 struct dpp_bootstrap_info, chirp_list) {
 		if (!bi->own && os_memcmp(bi->pubkey_hash_chirp, hash,
 					  SHA256_MAC_LEN) == 0)
 			return bi;
@@ -4739,7 +4841,8 @@ static int dpp_nfc_update_bi_channel(struct dpp_bootstrap_info *own_bi,
 }
 
 
-static int dpp_nfc_update_bi_key(struct dpp_bootstrap_info *own_bi,
+static int dpp_nfc_update_bi_key(struct dpp_global *dpp,
+				 struct dpp_bootstrap_info *own_bi,
 				 struct dpp_bootstrap_info *peer_bi)
 {
 	if (peer_bi->curve == own_bi->curve)
@@ -4755,19 +4858,28 @@ static int dpp_nfc_update_bi_key(struct dpp_bootstrap_info *own_bi,
 	    dpp_gen_uri(own_bi) < 0)
 		goto fail;
 
+	/* Move the entry to the index buckets for the new key hash */
+	dl_list_del(&own_bi->hash_list);
+	dl_list_del(&own_bi->chirp_list);
+	dl_list_add(&dpp->bootstrap_hash[own_bi->pubkey_hash[0]],
+		    &own_bi->hash_list);
+	dl_list_add(&dpp->bootstrap_chirp[own_bi->pubkey_hash_chirp[0]],
+		    &own_bi->chirp_list);
+
 	return 0;
 fail:
-	dl_list_del(&own_bi->list);
+	dpp_bootstrap_unlink(dpp, own_bi);
 	dpp_bootstrap_info_free(own_bi);
 	return -1;
 }
 
 
-int dpp_nfc_update_bi(struct dpp_bootstrap_info *own_bi,
+int dpp_nfc_update_bi(struct dpp_global *dpp,
+		      struct dpp_bootstrap_info *own_bi,
 		      struct dpp_bootstrap_info *peer_bi)
 {
 	if (dpp_nfc_update_bi_channel(own_bi, peer_bi) < 0 ||
-	    dpp_nfc_update_bi_key(own_bi, peer_bi) < 0)
+	    dpp_nfc_update_bi_key(dpp, own_bi, peer_bi) < 0)
 		return -1;
 	return 0;
 }
@@ -4999,6 +5111,7 @@ struct dpp_configurator * dpp_configurator_find_kid(struct dpp_global *dpp,
 struct dpp_global * dpp_global_init(struct dpp_global_config *config)
 {
 	struct dpp_global *dpp;
+	unsigned int i;
 
 	dpp = os_zalloc(sizeof(*dpp));
 	if (!dpp)
@@ -5009,6 +5122,10 @@ struct dpp_global * dpp_global_init(struct dpp_global_config *config)
 #endif /* CONFIG_DPP2 */
 
 	dl_list_init(&dpp->bootstrap);
+	for (i = 0; i < DPP_BOOTSTRAP_HASH_SIZE; i++) {
+		dl_list_init(&dpp->bootstrap_hash[i]);
+		dl_list_init(&dpp->bootstrap_chirp[i]);
+	}
 	dl_list_init(&dpp->configurator);
 #ifdef CONFIG_DPP2
 	dl_list_init(&dpp->controllers);
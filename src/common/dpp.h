@@ -162,6 +162,8 @@ enum dpp_bootstrap_supported_curves {
 
 struct dpp_bootstrap_info {
 	struct dl_list list;
+	struct dl_list hash_list; /* dpp_global::bootstrap_hash */
+	struct dl_list chirp_list; /* dpp_global::bootstrap_chirp */
 	unsigned int id;
 	enum dpp_bootstrap_type type;
 	char *uri;
@@ -441,6 +443,7 @@ struct dpp_relay_config {
 struct dpp_controller_config {
 	const char *configurator_params;
 	int tcp_port;
+	unsigned int max_conn; /* 0 = use default */
 	u8 allowed_roles;
 	int qr_mutual;
 	enum dpp_netrole netrole;
@@ -579,7 +582,8 @@ int dpp_parse_uri_chan_list(struct dpp_bootstrap_info *bi,
 			    const char *chan_list);
 int dpp_parse_uri_mac(struct dpp_bootstrap_info *bi, const char *mac);
 int dpp_parse_uri_info(struct dpp_bootstrap_info *bi, const char *info);
-int dpp_nfc_update_bi(struct dpp_bootstrap_info *own_bi,
+int dpp_nfc_update_bi(struct dpp_global *dpp,
+		      struct dpp_bootstrap_info *own_bi,
 		      struct dpp_bootstrap_info *peer_bi);
 const char * dpp_netrole_str(enum dpp_netrole netrole);
 struct dpp_authentication *
@@ -732,6 +736,7 @@ const char * dpp_bootstrap_get_uri(struct dpp_global *dpp, unsigned int id);
 int dpp_bootstrap_info(struct dpp_global *dpp, int id,
 		       char *reply, int reply_size);
 int dpp_bootstrap_set(struct dpp_global *dpp, int id, const char *params);
+int dpp_bootstrap_import(struct dpp_global *dpp, const char *fname);
 void dpp_bootstrap_find_pair(struct dpp_global *dpp, const u8 *i_bootstrap,
 			     const u8 *r_bootstrap,
 			     struct dpp_bootstrap_info **own_bi,
@@ -13,9 +13,18 @@
 
 #ifdef CONFIG_DPP
 
+/* Number of buckets in the bootstrapping key hash indexes; the index is the
+ * first octet of the SHA-256 based key hash */
+#define DPP_BOOTSTRAP_HASH_SIZE 256
+
 struct dpp_global {
 	void *msg_ctx;
 	struct dl_list bootstrap; /* struct dpp_bootstrap_info */
+	/* Bootstrapping keys indexed by pubkey_hash and pubkey_hash_chirp */
+	struct dl_list bootstrap_hash[DPP_BOOTSTRAP_HASH_SIZE];
+	struct dl_list bootstrap_chirp[DPP_BOOTSTRAP_HASH_SIZE];
+	unsigned int bootstrap_max_id;
+	bool bootstrap_max_id_stale;
 	struct dl_list configurator; /* struct dpp_configurator */
 #ifdef CONFIG_DPP2
 	struct dl_list controllers; /* struct dpp_relay_controller */
@@ -40,7 +49,9 @@ struct dpp_global {
 
 void dpp_build_attr_status(struct wpabuf *msg, enum dpp_status_error status);
 void dpp_build_attr_r_bootstrap_key_hash(struct wpabuf *msg, const u8 *hash);
-unsigned int dpp_next_id(struct dpp_global *dpp);
+void dpp_bootstrap_add(struct dpp_global *dpp, struct dpp_bootstrap_info *bi);
+void dpp_bootstrap_unlink(struct dpp_global *dpp,
+			  struct dpp_bootstrap_info *bi);
 struct wpabuf * dpp_build_conn_status(enum dpp_status_error result,
 				      const u8 *ssid, size_t ssid_len,
 				      const char *channel_list);
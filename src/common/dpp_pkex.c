@@ -1348,7 +1348,6 @@ dpp_pkex_finish(struct dpp_global *dpp, struct dpp_pkex *pkex, const u8 *peer,
 	bi = os_zalloc(sizeof(*bi));
 	if (!bi)
 		return NULL;
-	bi->id = dpp_next_id(dpp);
 	bi->type = DPP_BOOTSTRAP_PKEX;
 	if (peer)
 		os_memcpy(bi->mac_addr, peer, ETH_ALEN);
@@ -1366,7 +1365,7 @@ dpp_pkex_finish(struct dpp_global *dpp, struct dpp_pkex *pkex, const u8 *peer,
 	os_memcpy(pkex->own_bi->peer_pubkey_hash, bi->pubkey_hash,
 		  SHA256_MAC_LEN);
 	dpp_pkex_free(pkex);
-	dl_list_add(&dpp->bootstrap, &bi->list);
+	dpp_bootstrap_add(dpp, bi);
 	return bi;
 }
 
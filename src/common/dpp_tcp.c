@@ -20,6 +20,11 @@
 
 #ifdef CONFIG_DPP2
 
+/* Default maximum number of simultaneous connections to the local Controller
+ * and the time after which an inactive connection is removed */
+#define DPP_CONTROLLER_MAX_CONN 50
+#define DPP_CONTROLLER_CONN_TIMEOUT 60
+
 struct dpp_connection {
 	struct dl_list list;
 	struct dpp_controller *ctrl;
@@ -76,6 +81,7 @@ struct dpp_controller {
 	int qr_mutual;
 	int sock;
 	struct dl_list conn; /* struct dpp_connection */
+	unsigned int max_conn;
 	char *configurator_params;
 	enum dpp_netrole netrole;
 	struct dpp_bootstrap_info *pkex_bi;
@@ -97,6 +103,7 @@ static void dpp_tcp_build_new_key(void *eloop_ctx, void *timeout_ctx);
 #endif /* CONFIG_DPP3 */
 static void dpp_tcp_gas_query_comeback(void *eloop_ctx, void *timeout_ctx);
 static void dpp_relay_conn_timeout(void *eloop_ctx, void *timeout_ctx);
+static void dpp_controller_conn_timeout(void *eloop_ctx, void *timeout_ctx);
 
 
 static void dpp_connection_free(struct dpp_connection *conn)
@@ -113,6 +120,7 @@ static void dpp_connection_free(struct dpp_connection *conn)
 	eloop_cancel_timeout(dpp_tcp_build_csr, conn, NULL);
 	eloop_cancel_timeout(dpp_tcp_gas_query_comeback, conn, NULL);
 	eloop_cancel_timeout(dpp_relay_conn_timeout, conn, NULL);
+	eloop_cancel_timeout(dpp_controller_conn_timeout, conn, NULL);
 #ifdef CONFIG_DPP3
 	eloop_cancel_timeout(dpp_tcp_build_new_key, conn, NULL);
 #endif /* CONFIG_DPP3 */
@@ -266,7 +274,10 @@ static int dpp_tcp_send(struct dpp_connection *conn)
 	res = send(conn->sock,
 		   wpabuf_head_u8(conn->msg_out) + conn->msg_out_pos,
 		   wpabuf_len(conn->msg_out) - conn->msg_out_pos, 0);
-	if (res < 0) {
+	if (res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		/* Socket send buffer full; continue once writable */
+		res = 0;
+	} else if (res < 0) {
 		wpa_printf(MSG_DEBUG, "DPP: Failed to send buffer: %s",
 			   strerror(errno));
 		dpp_connection_remove(conn);
@@ -314,32 +325,56 @@ static int dpp_tcp_send(struct dpp_connection *conn)
 }
 
 
-static int dpp_tcp_send_msg(struct dpp_connection *conn,
-			    const struct wpabuf *msg)
+/**
+ * dpp_tcp_queue_msg - Queue a length prefixed message for transmission
+ * @conn: Connection
+ * @msg: Message to send; this is freed by the call
+ * Returns: 0 on success, -1 on allocation failure
+ *
+ * The message is appended to any data that has not yet been fully written to
+ * the socket so that a message generated while a previous one is still being
+ * sent is not lost. Note that the connection may have been removed when this
+ * function returns 0 if the socket write failed.
+ */
+static int dpp_tcp_queue_msg(struct dpp_connection *conn, struct wpabuf *msg)
 {
-	wpabuf_free(conn->msg_out);
-	conn->msg_out_pos = 0;
-	conn->msg_out = wpabuf_alloc(4 + wpabuf_len(msg) - 1);
-	if (!conn->msg_out)
+	if (!msg)
 		return -1;
-	wpabuf_put_be32(conn->msg_out, wpabuf_len(msg) - 1);
-	wpabuf_put_data(conn->msg_out, wpabuf_head_u8(msg) + 1,
-			wpabuf_len(msg) - 1);
 
-	if (dpp_tcp_send(conn) == 1) {
-		if (!conn->write_eloop) {
-			if (eloop_register_sock(conn->sock, EVENT_TYPE_WRITE,
-						dpp_conn_tx_ready,
-						conn, NULL) < 0)
-				return -1;
-			conn->write_eloop = 1;
+	if (conn->msg_out) {
+		if (wpabuf_resize(&conn->msg_out, wpabuf_len(msg)) < 0) {
+			wpabuf_free(msg);
+			return -1;
 		}
+		wpabuf_put_buf(conn->msg_out, msg);
+		wpabuf_free(msg);
+	} else {
+		conn->msg_out = msg;
+		conn->msg_out_pos = 0;
 	}
 
+	/* Pending data is sent from dpp_conn_tx_ready() */
+	if (!conn->write_eloop)
+		dpp_tcp_send(conn);
 	return 0;
 }
 
 
+static int dpp_tcp_send_msg(struct dpp_connection *conn,
+			    const struct wpabuf *msg)
+{
+	struct wpabuf *buf;
+
+	buf = wpabuf_alloc(4 + wpabuf_len(msg) - 1);
+	if (!buf)
+		return -1;
+	wpabuf_put_be32(buf, wpabuf_len(msg) - 1);
+	wpabuf_put_data(buf, wpabuf_head_u8(msg) + 1, wpabuf_len(msg) - 1);
+
+	return dpp_tcp_queue_msg(conn, buf);
+}
+
+
 static void dpp_controller_start_gas_client(struct dpp_connection *conn)
 {
 	struct dpp_authentication *auth = conn->auth;
@@ -539,19 +574,15 @@ static int dpp_relay_tx(struct dpp_connection *conn, const u8 *hdr,
 
 	wpa_printf(MSG_DEBUG,
 		   "DPP: Continue already established Relay/Controller connection for this session");
-	wpabuf_free(conn->msg_out);
-	conn->msg_out_pos = 0;
-	conn->msg_out = dpp_tcp_encaps(hdr, buf, len);
-	if (!conn->msg_out) {
-		dpp_connection_remove(conn);
-		return -1;
-	}
 
 	/* TODO: for proto ver 1, need to do remove connection based on GAS Resp
 	 * TX status */
 	if (type == DPP_PA_CONFIGURATION_RESULT)
 		conn->on_tcp_tx_complete_remove = 1;
-	dpp_tcp_send(conn);
+	if (dpp_tcp_queue_msg(conn, dpp_tcp_encaps(hdr, buf, len)) < 0) {
+		dpp_connection_remove(conn);
+		return -1;
+	}
 	return 0;
 }
 
@@ -700,11 +731,7 @@ int dpp_relay_rx_gas_req(struct dpp_global *dpp, const u8 *src, const u8 *data,
 	wpabuf_put_data(msg, data, data_len);
 	wpa_hexdump_buf(MSG_MSGDUMP, "DPP: Outgoing TCP message", msg);
 
-	wpabuf_free(conn->msg_out);
-	conn->msg_out_pos = 0;
-	conn->msg_out = msg;
-	dpp_tcp_send(conn);
-	return 0;
+	return dpp_tcp_queue_msg(conn, msg);
 }
 
 
@@ -1329,11 +1356,7 @@ static int dpp_tcp_send_comeback_delay(struct dpp_connection *conn, u8 action)
 
 	/* Send Config Response over TCP */
 	wpa_hexdump_buf(MSG_MSGDUMP, "DPP: Outgoing TCP message", buf);
-	wpabuf_free(conn->msg_out);
-	conn->msg_out_pos = 0;
-	conn->msg_out = buf;
-	dpp_tcp_send(conn);
-	return 0;
+	return dpp_tcp_queue_msg(conn, buf);
 }
 
 
@@ -1372,12 +1395,8 @@ static int dpp_tcp_send_gas_resp(struct dpp_connection *conn, u8 action,
 	/* Send Config Response over TCP; GAS fragmentation is taken care of by
 	 * the Relay */
 	wpa_hexdump_buf(MSG_MSGDUMP, "DPP: Outgoing TCP message", buf);
-	wpabuf_free(conn->msg_out);
-	conn->msg_out_pos = 0;
-	conn->msg_out = buf;
 	conn->on_tcp_tx_complete_gas_done = 1;
-	dpp_tcp_send(conn);
-	return 0;
+	return dpp_tcp_queue_msg(conn, buf);
 }
 
 
@@ -1641,10 +1660,7 @@ static void dpp_tcp_gas_query_comeback(void *eloop_ctx, void *timeout_ctx)
 	wpabuf_put_u8(msg, conn->gas_dialog_token);
 	wpa_hexdump_buf(MSG_MSGDUMP, "DPP: Outgoing TCP message", msg);
 
-	wpabuf_free(conn->msg_out);
-	conn->msg_out_pos = 0;
-	conn->msg_out = msg;
-	dpp_tcp_send(conn);
+	dpp_tcp_queue_msg(conn, msg);
 }
 
 
@@ -1736,6 +1752,17 @@ static int dpp_rx_gas_resp(struct dpp_connection *conn, const u8 *msg,
 }
 
 
+static void dpp_controller_conn_timeout(void *eloop_ctx, void *timeout_ctx)
+{
+	struct dpp_connection *conn = eloop_ctx;
+
+	wpa_printf(MSG_DEBUG,
+		   "DPP: Remove inactive Controller connection (sock %d)",
+		   conn->sock);
+	dpp_connection_remove(conn);
+}
+
+
 static void dpp_controller_rx(int sd, void *eloop_ctx, void *sock_ctx)
 {
 	struct dpp_connection *conn = eloop_ctx;
@@ -1745,6 +1772,11 @@ static void dpp_controller_rx(int sd, void *eloop_ctx, void *sock_ctx)
 	wpa_printf(MSG_DEBUG, "DPP: TCP data available for reading (sock %d)",
 		   sd);
 
+	if (conn->ctrl)
+		eloop_replenish_timeout(DPP_CONTROLLER_CONN_TIMEOUT, 0,
+					dpp_controller_conn_timeout, conn,
+					NULL);
+
 	if (conn->msg_len_octets < 4) {
 		u32 msglen;
 
@@ -1876,6 +1908,14 @@ static void dpp_controller_tcp_cb(int sd, void *eloop_ctx, void *sock_ctx)
 	wpa_printf(MSG_DEBUG, "DPP: Connection from %s:%d",
 		   inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
 
+	if ((unsigned int) dl_list_len(&ctrl->conn) >= ctrl->max_conn) {
+		wpa_printf(MSG_DEBUG,
+			   "DPP: Too many ongoing Controller connections (%u) - reject new connection",
+			   ctrl->max_conn);
+		close(fd);
+		return;
+	}
+
 	conn = os_zalloc(sizeof(*conn));
 	if (!conn)
 		goto fail;
@@ -1900,8 +1940,8 @@ static void dpp_controller_tcp_cb(int sd, void *eloop_ctx, void *sock_ctx)
 		goto fail;
 	conn->read_eloop = 1;
 
-	/* TODO: eloop timeout to expire connections that do not complete in
-	 * reasonable time */
+	eloop_register_timeout(DPP_CONTROLLER_CONN_TIMEOUT, 0,
+			       dpp_controller_conn_timeout, conn, NULL);
 	dl_list_add(&ctrl->conn, &conn->list);
 	return;
 
@@ -2153,6 +2193,8 @@ int dpp_controller_start(struct dpp_global *dpp,
 	ctrl->cb_ctx = config->cb_ctx;
 	ctrl->process_conf_obj = config->process_conf_obj;
 	ctrl->tcp_msg_sent = config->tcp_msg_sent;
+	ctrl->max_conn = config->max_conn ? config->max_conn :
+		DPP_CONTROLLER_MAX_CONN;
 
 	ctrl->sock = socket(AF_INET, SOCK_STREAM, 0);
 	if (ctrl->sock < 0)
@@ -2184,7 +2226,7 @@ int dpp_controller_start(struct dpp_global *dpp,
 			   strerror(errno));
 		goto fail;
 	}
-	if (listen(ctrl->sock, 10 /* max backlog */) < 0 ||
+	if (listen(ctrl->sock, ctrl->max_conn /* max backlog */) < 0 ||
 	    fcntl(ctrl->sock, F_SETFL, O_NONBLOCK) < 0 ||
 	    eloop_register_sock(ctrl->sock, EVENT_TYPE_READ,
 				dpp_controller_tcp_cb, ctrl, NULL))
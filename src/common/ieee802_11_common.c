@@ -693,6 +693,162 @@ ParseRes ieee802_11_parse_elems(const u8 *start, size_t len,
 }
 
 
+/**
+ * ieee802_11_elem_index_build - Index the requested elements in a buffer
+ * @start: Pointer to the start of the elements
+ * @len: Length of the element buffer in octets
+ * @ids: Element IDs (WLAN_EID_*) to index
+ * @num_ids: Number of entries in @ids (at most IEEE802_11_ELEM_INDEX_MAX)
+ * @ext_ids: Element ID Extensions (WLAN_EID_EXT_*) to index
+ * @num_ext_ids: Number of entries in @ext_ids (at most
+ * IEEE802_11_ELEM_INDEX_MAX)
+ * @idx: Index to fill in
+ * Returns: 0 on success or -1 if the element buffer is malformed
+ *
+ * This validates the element framing with a single pass over the buffer and
+ * records the first instance of each requested Element ID and Element ID
+ * Extension without interpreting the element contents. Only the requested
+ * elements can then be fetched with ieee802_11_elem_index_get() and the
+ * related functions. This is a cheaper alternative to
+ * ieee802_11_parse_elems() for code paths that need only a few elements from
+ * a frame. @ids and @ext_ids are referenced from @idx and need to remain
+ * valid while the index is used.
+ *
+ * Similarly to get_ie(), the elements preceding a framing error are still
+ * indexed on failure.
+ */
+int ieee802_11_elem_index_build(const u8 *start, size_t len,
+				const u8 *ids, size_t num_ids,
+				const u8 *ext_ids, size_t num_ext_ids,
+				struct ieee802_11_elem_index *idx)
+{
+	const u8 *pos, *end;
+	unsigned int count = 0;
+	u8 want[256 / 8]; /* Element IDs that need a lookup in ids/ext_ids */
+	size_t i;
+
+	idx->start = start;
+	idx->len = len;
+	idx->count = 0;
+	idx->ids = ids;
+	idx->num_ids = 0;
+	idx->ext_ids = ext_ids;
+	idx->num_ext_ids = 0;
+
+	if (num_ids > IEEE802_11_ELEM_INDEX_MAX ||
+	    num_ext_ids > IEEE802_11_ELEM_INDEX_MAX)
+		return -1;
+
+	idx->num_ids = num_ids;
+	idx->num_ext_ids = num_ext_ids;
+	os_memset(idx->elem, 0, sizeof(idx->elem));
+	os_memset(idx->ext_elem, 0, sizeof(idx->ext_elem));
+	os_memset(want, 0, sizeof(want));
+	for (i = 0; i < num_ids; i++)
+		want[ids[i] / 8] |= BIT(ids[i] % 8);
+	if (num_ext_ids)
+		want[WLAN_EID_EXTENSION / 8] |= BIT(WLAN_EID_EXTENSION % 8);
+
+	pos = end = start;
+	if (start)
+		end += len;
+	while (end - pos >= 2) {
+		u8 id = pos[0], elen = pos[1];
+
+		if (elen > end - pos - 2)
+			break;
+
+		if (want[id / 8] & BIT(id % 8)) {
+			for (i = 0; i < num_ids; i++) {
+				if (ids[i] == id && !idx->elem[i])
+					idx->elem[i] = pos;
+			}
+
+			if (id == WLAN_EID_EXTENSION && elen > 0) {
+				for (i = 0; i < num_ext_ids; i++) {
+					if (ext_ids[i] == pos[2] &&
+					    !idx->ext_elem[i])
+						idx->ext_elem[i] = pos;
+				}
+			}
+		}
+
+		count++;
+		pos += 2 + elen;
+	}
+
+	idx->count = count;
+
+	return pos == end ? 0 : -1;
+}
+
+
+/**
+ * ieee802_11_elem_index_get - Fetch an element using an element index
+ * @idx: Element index from ieee802_11_elem_index_build()
+ * @eid: Element ID (WLAN_EID_*)
+ * Returns: Pointer to the first matching element (id field) or %NULL if not
+ * found or not included in the indexed Element IDs
+ */
+const u8 * ieee802_11_elem_index_get(const struct ieee802_11_elem_index *idx,
+				     u8 eid)
+{
+	size_t i;
+
+	for (i = 0; i < idx->num_ids; i++) {
+		if (idx->ids[i] == eid)
+			return idx->elem[i];
+	}
+
+	return NULL;
+}
+
+
+/**
+ * ieee802_11_elem_index_get_ext - Fetch an extension element using an index
+ * @idx: Element index from ieee802_11_elem_index_build()
+ * @ext: Element ID Extension (WLAN_EID_EXT_*)
+ * Returns: Pointer to the first matching element (id field) or %NULL if not
+ * found or not included in the indexed Element ID Extensions
+ */
+const u8 *
+ieee802_11_elem_index_get_ext(const struct ieee802_11_elem_index *idx, u8 ext)
+{
+	size_t i;
+
+	for (i = 0; i < idx->num_ext_ids; i++) {
+		if (idx->ext_ids[i] == ext)
+			return idx->ext_elem[i];
+	}
+
+	return NULL;
+}
+
+
+/**
+ * ieee802_11_elem_index_get_vendor - Fetch a vendor element using an index
+ * @idx: Element index from ieee802_11_elem_index_build()
+ * @vendor_type: Vendor type (OUI and OUI type)
+ * Returns: Pointer to the first matching element (id field) or %NULL if not
+ * found
+ *
+ * WLAN_EID_VENDOR_SPECIFIC needs to be included in the indexed Element IDs.
+ * Only the part of the buffer starting from the first Vendor Specific element
+ * is searched.
+ */
+const u8 *
+ieee802_11_elem_index_get_vendor(const struct ieee802_11_elem_index *idx,
+				 u32 vendor_type)
+{
+	const u8 *pos;
+
+	pos = ieee802_11_elem_index_get(idx, WLAN_EID_VENDOR_SPECIFIC);
+	if (!pos)
+		return NULL;
+	return get_vendor_ie(pos, idx->start + idx->len - pos, vendor_type);
+}
+
+
 /**
  * ieee802_11_elems_clear_ids - Clear the data for the given element IDs
  * @ids: Array of element IDs for which data should be cleared.
@@ -185,6 +185,22 @@ struct ieee802_11_elems {
 
 typedef enum { ParseOK = 0, ParseUnknown = 1, ParseFailed = -1 } ParseRes;
 
+#define IEEE802_11_ELEM_INDEX_MAX 8
+
+/* First instance of each requested element in an element buffer for lookups
+ * without parsing all the elements */
+struct ieee802_11_elem_index {
+	const u8 *start;
+	size_t len;
+	unsigned int count; /* number of elements */
+	const u8 *ids; /* requested Element IDs */
+	size_t num_ids;
+	const u8 *ext_ids; /* requested Element ID Extensions */
+	size_t num_ext_ids;
+	const u8 *elem[IEEE802_11_ELEM_INDEX_MAX]; /* matching ids[] */
+	const u8 *ext_elem[IEEE802_11_ELEM_INDEX_MAX]; /* matching ext_ids[] */
+};
+
 ParseRes ieee802_11_parse_elems(const u8 *start, size_t len,
 				struct ieee802_11_elems *elems,
 				int show_errors);
@@ -196,6 +212,17 @@ ParseRes ieee802_11_parse_link_assoc_req(const u8 *start, size_t len,
 					 struct ieee802_11_elems *elems,
 					 struct wpabuf *mlbuf,
 					 u8 link_id, bool show_errors);
+int ieee802_11_elem_index_build(const u8 *start, size_t len,
+				const u8 *ids, size_t num_ids,
+				const u8 *ext_ids, size_t num_ext_ids,
+				struct ieee802_11_elem_index *idx);
+const u8 * ieee802_11_elem_index_get(const struct ieee802_11_elem_index *idx,
+				     u8 eid);
+const u8 *
+ieee802_11_elem_index_get_ext(const struct ieee802_11_elem_index *idx, u8 ext);
+const u8 *
+ieee802_11_elem_index_get_vendor(const struct ieee802_11_elem_index *idx,
+				 u32 vendor_type);
 int ieee802_11_ie_count(const u8 *ies, size_t ies_len);
 struct wpabuf * ieee802_11_vendor_ie_concat(const u8 *ies, size_t ies_len,
 					    u32 oui_type);
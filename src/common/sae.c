@@ -1135,9 +1135,37 @@ static void sae_max_min_addr(const u8 *addr[], size_t len[],
 }
 
 
-struct crypto_ec_point *
-sae_derive_pwe_from_pt_ecc(const struct sae_pt *pt,
-			   const u8 *addr1, const u8 *addr2)
+static int sae_pt_mul_ecc(struct sae_pt *pt, const struct crypto_bignum *b,
+			  struct crypto_ec_point *res)
+{
+	/* PT is used as the base point of a scalar multiplication in each SAE
+	 * commit, so precompute its multiples. The table takes about 150 kB and
+	 * the time of about ten point multiplications (group 19), so it is
+	 * built only once PT is used for a second commit instead of for every
+	 * configured password and group. This is only an optimization and the
+	 * generic point multiplication is used if it fails. */
+	if (!pt->ecc_pt_table && !pt->ecc_pt_table_failed &&
+	    ++pt->ecc_pt_uses >= 2) {
+		pt->ecc_pt_table = crypto_ec_point_table_init(pt->ec,
+							      pt->ecc_pt);
+		if (!pt->ecc_pt_table) {
+			wpa_printf(MSG_DEBUG,
+				   "SAE: Could not precompute PT multiples");
+			pt->ecc_pt_table_failed = true;
+		}
+	}
+
+	if (pt->ecc_pt_table)
+		return crypto_ec_point_mul_table(pt->ec, pt->ecc_pt_table, b,
+						 res);
+	return crypto_ec_point_mul(pt->ec, pt->ecc_pt, b, res);
+}
+
+
+static struct crypto_ec_point *
+sae_derive_pwe_from_pt_ecc_val(struct sae_pt *pt,
+			       const u8 *addr1, const u8 *addr2,
+			       struct crypto_bignum **pwe_val)
 {
 	u8 bin[SAE_MAX_ECC_PRIME_LEN * 2];
 	size_t prime_len;
@@ -1183,7 +1211,7 @@ sae_derive_pwe_from_pt_ecc(const struct sae_pt *pt,
 	/* PWE = scalar-op(val, PT) */
 	pwe = crypto_ec_point_init(pt->ec);
 	if (!pwe ||
-	    crypto_ec_point_mul(pt->ec, pt->ecc_pt, val, pwe) < 0 ||
+	    sae_pt_mul_ecc(pt, val, pwe) < 0 ||
 	    crypto_ec_point_to_bin(pt->ec, pwe, bin, bin + prime_len) < 0) {
 		crypto_ec_point_deinit(pwe, 1);
 		pwe = NULL;
@@ -1192,6 +1220,11 @@ sae_derive_pwe_from_pt_ecc(const struct sae_pt *pt,
 	wpa_hexdump_key(MSG_DEBUG, "SAE: PWE.x", bin, prime_len);
 	wpa_hexdump_key(MSG_DEBUG, "SAE: PWE.y", bin + prime_len, prime_len);
 
+	if (pwe_val) {
+		*pwe_val = val;
+		val = NULL;
+	}
+
 fail:
 	crypto_bignum_deinit(tmp, 1);
 	crypto_bignum_deinit(val, 1);
@@ -1200,6 +1233,14 @@ fail:
 }
 
 
+struct crypto_ec_point *
+sae_derive_pwe_from_pt_ecc(struct sae_pt *pt,
+			   const u8 *addr1, const u8 *addr2)
+{
+	return sae_derive_pwe_from_pt_ecc_val(pt, addr1, addr2, NULL);
+}
+
+
 struct crypto_bignum *
 sae_derive_pwe_from_pt_ffc(const struct sae_pt *pt,
 			   const u8 *addr1, const u8 *addr2)
@@ -1265,6 +1306,7 @@ void sae_deinit_pt(struct sae_pt *pt)
 	struct sae_pt *prev;
 
 	while (pt) {
+		crypto_ec_point_table_deinit(pt->ecc_pt_table);
 		crypto_ec_point_deinit(pt->ecc_pt, 1);
 		crypto_bignum_deinit(pt->ffc_pt, 1);
 		crypto_ec_deinit(pt->ec);
@@ -1276,8 +1318,13 @@ void sae_deinit_pt(struct sae_pt *pt)
 
 
 static int sae_derive_commit_element_ecc(struct sae_data *sae,
-					 struct crypto_bignum *mask)
+					 struct crypto_bignum *mask,
+					 const struct sae_pt *pt,
+					 const struct crypto_bignum *pwe_val)
 {
+	struct crypto_bignum *tmp = NULL;
+	int res;
+
 	/* COMMIT-ELEMENT = inverse(scalar-op(mask, PWE)) */
 	if (!sae->tmp->own_commit_element_ecc) {
 		sae->tmp->own_commit_element_ecc =
@@ -1286,8 +1333,23 @@ static int sae_derive_commit_element_ecc(struct sae_data *sae,
 			return -1;
 	}
 
-	if (crypto_ec_point_mul(sae->tmp->ec, sae->tmp->pwe_ecc, mask,
-				sae->tmp->own_commit_element_ecc) < 0 ||
+	if (pt && pt->ecc_pt_table && pwe_val) {
+		/* With PWE = scalar-op(val, PT), use the precomputed multiples
+		 * of PT: scalar-op(mask, PWE) = scalar-op(mask * val, PT) */
+		tmp = crypto_bignum_init();
+		res = !tmp ||
+			crypto_bignum_mulmod(mask, pwe_val, sae->tmp->order,
+					     tmp) < 0 ||
+			crypto_ec_point_mul_table(
+				sae->tmp->ec, pt->ecc_pt_table, tmp,
+				sae->tmp->own_commit_element_ecc) < 0;
+		crypto_bignum_deinit(tmp, 1);
+	} else {
+		res = crypto_ec_point_mul(sae->tmp->ec, sae->tmp->pwe_ecc, mask,
+					  sae->tmp->own_commit_element_ecc) < 0;
+	}
+
+	if (res ||
 	    crypto_ec_point_invert(sae->tmp->ec,
 				   sae->tmp->own_commit_element_ecc) < 0) {
 		wpa_printf(MSG_DEBUG, "SAE: Could not compute commit-element");
@@ -1321,7 +1383,8 @@ static int sae_derive_commit_element_ffc(struct sae_data *sae,
 }
 
 
-static int sae_derive_commit(struct sae_data *sae)
+static int sae_derive_commit(struct sae_data *sae, const struct sae_pt *pt,
+			     const struct crypto_bignum *pwe_val)
 {
 	struct crypto_bignum *mask;
 	int ret;
@@ -1336,7 +1399,7 @@ static int sae_derive_commit(struct sae_data *sae)
 					  mask,
 					  sae->tmp->own_commit_scalar) < 0 ||
 		(sae->tmp->ec &&
-		 sae_derive_commit_element_ecc(sae, mask) < 0) ||
+		 sae_derive_commit_element_ecc(sae, mask, pt, pwe_val) < 0) ||
 		(sae->tmp->dh &&
 		 sae_derive_commit_element_ffc(sae, mask) < 0);
 	crypto_bignum_deinit(mask, 1);
@@ -1357,14 +1420,17 @@ int sae_prepare_commit(const u8 *addr1, const u8 *addr2,
 
 	sae->h2e = 0;
 	sae->pk = 0;
-	return sae_derive_commit(sae);
+	return sae_derive_commit(sae, NULL, NULL);
 }
 
 
-int sae_prepare_commit_pt(struct sae_data *sae, const struct sae_pt *pt,
+int sae_prepare_commit_pt(struct sae_data *sae, struct sae_pt *pt,
 			  const u8 *addr1, const u8 *addr2,
 			  int *rejected_groups, const struct sae_pk *pk)
 {
+	struct crypto_bignum *pwe_val = NULL;
+	int ret;
+
 	if (!sae->tmp)
 		return -1;
 
@@ -1402,8 +1468,9 @@ int sae_prepare_commit_pt(struct sae_data *sae, const struct sae_pt *pt,
 
 	if (pt->ec) {
 		crypto_ec_point_deinit(sae->tmp->pwe_ecc, 1);
-		sae->tmp->pwe_ecc = sae_derive_pwe_from_pt_ecc(pt, addr1,
-							       addr2);
+		sae->tmp->pwe_ecc = sae_derive_pwe_from_pt_ecc_val(pt, addr1,
+								   addr2,
+								   &pwe_val);
 		if (!sae->tmp->pwe_ecc)
 			return -1;
 	}
@@ -1417,7 +1484,9 @@ int sae_prepare_commit_pt(struct sae_data *sae, const struct sae_pt *pt,
 	}
 
 	sae->h2e = 1;
-	return sae_derive_commit(sae);
+	ret = sae_derive_commit(sae, pt, pwe_val);
+	crypto_bignum_deinit(pwe_val, 1);
+	return ret;
 }
 
 
@@ -89,6 +89,11 @@ struct sae_pt {
 	int group;
 	struct crypto_ec *ec;
 	struct crypto_ec_point *ecc_pt;
+	/* Precomputed multiples of PT for deriving PWE and COMMIT-ELEMENT;
+	 * built on the second use of PT */
+	struct crypto_ec_point_table *ecc_pt_table;
+	unsigned int ecc_pt_uses;
+	bool ecc_pt_table_failed;
 
 	const struct dh_group *dh;
 	struct crypto_bignum *ffc_pt;
@@ -128,7 +133,7 @@ void sae_clear_data(struct sae_data *sae);
 int sae_prepare_commit(const u8 *addr1, const u8 *addr2,
 		       const u8 *password, size_t password_len,
 		       struct sae_data *sae);
-int sae_prepare_commit_pt(struct sae_data *sae, const struct sae_pt *pt,
+int sae_prepare_commit_pt(struct sae_data *sae, struct sae_pt *pt,
 			  const u8 *addr1, const u8 *addr2,
 			  int *rejected_groups, const struct sae_pk *pk);
 int sae_process_commit(struct sae_data *sae);
@@ -148,7 +153,7 @@ struct sae_pt * sae_derive_pt(int *groups, const u8 *ssid, size_t ssid_len,
 			      const u8 *password, size_t password_len,
 			      const char *identifier);
 struct crypto_ec_point *
-sae_derive_pwe_from_pt_ecc(const struct sae_pt *pt,
+sae_derive_pwe_from_pt_ecc(struct sae_pt *pt,
 			   const u8 *addr1, const u8 *addr2);
 struct crypto_bignum *
 sae_derive_pwe_from_pt_ffc(const struct sae_pt *pt,
@@ -876,6 +876,53 @@ int crypto_ec_point_mul(struct crypto_ec *e, const struct crypto_ec_point *p,
 			const struct crypto_bignum *b,
 			struct crypto_ec_point *res);
 
+/**
+ * struct crypto_ec_point_table - Precomputed multiples of a fixed EC point
+ *
+ * Internal data structure for EC implementation to speed up repeated scalar
+ * multiplications of the same point. The contents is specific to the used
+ * crypto library.
+ */
+struct crypto_ec_point_table;
+
+/**
+ * crypto_ec_point_table_init - Precompute multiples of a fixed point
+ * @e: EC context from crypto_ec_init()
+ * @p: EC point that is going to be used with crypto_ec_point_mul_table()
+ * Returns: Precomputed table or %NULL on failure
+ *
+ * This is a relatively expensive operation that is worth doing only for
+ * points that are multiplied many times. The table contains information
+ * derived from the point and needs to be protected in the same way as the
+ * point itself.
+ */
+struct crypto_ec_point_table *
+crypto_ec_point_table_init(struct crypto_ec *e,
+			   const struct crypto_ec_point *p);
+
+/**
+ * crypto_ec_point_table_deinit - Free a precomputed point table
+ * @t: Table from crypto_ec_point_table_init() or %NULL
+ */
+void crypto_ec_point_table_deinit(struct crypto_ec_point_table *t);
+
+/**
+ * crypto_ec_point_mul_table - res = b * p using a precomputed table for p
+ * @e: EC context from crypto_ec_init()
+ * @t: Precomputed table for p from crypto_ec_point_table_init()
+ * @b: Bignum
+ * @res: EC point; used to store the result of b * p
+ * Returns: 0 on success, -1 on failure
+ *
+ * The result is the same as with crypto_ec_point_mul(), but the computation
+ * can be faster depending on the crypto library. The implementation is
+ * expected to be constant time with respect to b.
+ */
+int crypto_ec_point_mul_table(struct crypto_ec *e,
+			      const struct crypto_ec_point_table *t,
+			      const struct crypto_bignum *b,
+			      struct crypto_ec_point *res);
+
 /**
  * crypto_ec_point_invert - Compute inverse of an EC point
  * @e: EC context from crypto_ec_init()
@@ -1786,6 +1786,20 @@ int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
 }
 
 
+int pbkdf2_sha1_mb(size_t num, const char *passphrase[], const u8 *ssid,
+		   size_t ssid_len, int iterations, u8 *buf[], size_t buflen)
+{
+	size_t i;
+
+	for (i = 0; i < num; i++) {
+		if (pbkdf2_sha1(passphrase[i], ssid, ssid_len, iterations,
+				buf[i], buflen))
+			return -1;
+	}
+	return 0;
+}
+
+
 int crypto_get_random(void *buf, size_t len)
 {
 	if (RAND_bytes(buf, len) != 1)
@@ -2540,6 +2554,76 @@ int crypto_ec_point_mul(struct crypto_ec *e, const struct crypto_ec_point *p,
 }
 
 
+struct crypto_ec_point_table {
+	/* Copy of the group with the fixed point as the generator so that
+	 * OpenSSL can use its precomputed, constant time generator
+	 * multiplication for the point */
+	EC_GROUP *group;
+};
+
+
+struct crypto_ec_point_table *
+crypto_ec_point_table_init(struct crypto_ec *e,
+			   const struct crypto_ec_point *p)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	if (TEST_FAIL())
+		return NULL;
+
+	/* OpenSSL 3.0 deprecated EC_GROUP_precompute_mult() and the EVP API
+	 * has no replacement for precomputing multiples of a point that is not
+	 * the standard generator, so let the callers use the generic point
+	 * multiplication. */
+	return NULL;
+#else /* OpenSSL version >= 3.0 */
+	struct crypto_ec_point_table *t;
+	BIGNUM *cofactor;
+
+	if (TEST_FAIL())
+		return NULL;
+
+	t = os_zalloc(sizeof(*t));
+	cofactor = BN_new();
+	if (!t || !cofactor)
+		goto fail;
+	t->group = EC_GROUP_dup(e->group);
+	if (!t->group ||
+	    !EC_GROUP_get_cofactor(e->group, cofactor, e->bnctx) ||
+	    !EC_GROUP_set_generator(t->group, (const EC_POINT *) p, e->order,
+				    cofactor) ||
+	    !EC_GROUP_precompute_mult(t->group, e->bnctx))
+		goto fail;
+	BN_free(cofactor);
+	return t;
+fail:
+	BN_free(cofactor);
+	crypto_ec_point_table_deinit(t);
+	return NULL;
+#endif /* OpenSSL version >= 3.0 */
+}
+
+
+void crypto_ec_point_table_deinit(struct crypto_ec_point_table *t)
+{
+	if (!t)
+		return;
+	EC_GROUP_free(t->group);
+	os_free(t);
+}
+
+
+int crypto_ec_point_mul_table(struct crypto_ec *e,
+			      const struct crypto_ec_point_table *t,
+			      const struct crypto_bignum *b,
+			      struct crypto_ec_point *res)
+{
+	if (TEST_FAIL())
+		return -1;
+	return EC_POINT_mul(t->group, (EC_POINT *) res, (const BIGNUM *) b,
+			    NULL, NULL, e->bnctx) ? 0 : -1;
+}
+
+
 int crypto_ec_point_invert(struct crypto_ec *e, struct crypto_ec_point *p)
 {
 	if (TEST_FAIL())
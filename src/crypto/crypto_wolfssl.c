@@ -527,6 +527,20 @@ int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
 }
 
 
+int pbkdf2_sha1_mb(size_t num, const char *passphrase[], const u8 *ssid,
+		   size_t ssid_len, int iterations, u8 *buf[], size_t buflen)
+{
+	size_t i;
+
+	for (i = 0; i < num; i++) {
+		if (pbkdf2_sha1(passphrase[i], ssid, ssid_len, iterations,
+				buf[i], buflen))
+			return -1;
+	}
+	return 0;
+}
+
+
 #ifdef CONFIG_DES
 int des_encrypt(const u8 *clear, const u8 *key, u8 *cypher)
 {
@@ -2013,6 +2027,52 @@ int crypto_ec_point_mul(struct crypto_ec *e, const struct crypto_ec_point *p,
 }
 
 
+struct crypto_ec_point_table {
+	/* No precomputation; only a copy of the point */
+	struct crypto_ec_point *p;
+};
+
+
+struct crypto_ec_point_table *
+crypto_ec_point_table_init(struct crypto_ec *e,
+			   const struct crypto_ec_point *p)
+{
+	struct crypto_ec_point_table *t;
+
+	if (TEST_FAIL())
+		return NULL;
+
+	t = os_zalloc(sizeof(*t));
+	if (!t)
+		return NULL;
+	t->p = crypto_ec_point_init(e);
+	if (!t->p ||
+	    wc_ecc_copy_point((ecc_point *) p, (ecc_point *) t->p) != 0) {
+		crypto_ec_point_table_deinit(t);
+		return NULL;
+	}
+	return t;
+}
+
+
+void crypto_ec_point_table_deinit(struct crypto_ec_point_table *t)
+{
+	if (!t)
+		return;
+	crypto_ec_point_deinit(t->p, 1);
+	os_free(t);
+}
+
+
+int crypto_ec_point_mul_table(struct crypto_ec *e,
+			      const struct crypto_ec_point_table *t,
+			      const struct crypto_bignum *b,
+			      struct crypto_ec_point *res)
+{
+	return crypto_ec_point_mul(e, t->p, b, res);
+}
+
+
 int crypto_ec_point_invert(struct crypto_ec *e, struct crypto_ec_point *p)
 {
 	ecc_point *point = (ecc_point *) p;
@@ -7,6 +7,9 @@
  */
 
 #include "includes.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
 
 #include "common.h"
 #include "sha1.h"
@@ -229,6 +232,117 @@ void SHA1Transform(u32 state[5], const unsigned char buffer[64])
 }
 
 
+#ifdef __SSE2__
+
+/* Four SHA1 block operations in parallel using one 32-bit lane of the SSE2
+ * registers for each block */
+
+#define rol_x4(v, bits) _mm_or_si128(_mm_slli_epi32((v), (bits)), \
+				     _mm_srli_epi32((v), 32 - (bits)))
+
+#define blk_x4(i) (w[i & 15] = rol_x4(_mm_xor_si128( \
+	_mm_xor_si128(w[(i + 13) & 15], w[(i + 8) & 15]), \
+	_mm_xor_si128(w[(i + 2) & 15], w[i & 15])), 1))
+
+#define ROUND_x4(f, k, wi) do { \
+	t = _mm_add_epi32(_mm_add_epi32(rol_x4(a, 5), (f)), \
+			  _mm_add_epi32(_mm_add_epi32(e, (k)), (wi))); \
+	e = d; d = c; c = rol_x4(b, 30); b = a; a = t; \
+} while (0)
+
+static void SHA1Transform_x4(u32 *state[4], const unsigned char *buffer[4])
+{
+	__m128i a, b, c, d, e, t, k, w[16], v[5];
+	u32 tmp[4];
+	int i, j;
+
+	for (i = 0; i < 16; i++)
+		w[i] = _mm_set_epi32(WPA_GET_BE32(buffer[3] + 4 * i),
+				     WPA_GET_BE32(buffer[2] + 4 * i),
+				     WPA_GET_BE32(buffer[1] + 4 * i),
+				     WPA_GET_BE32(buffer[0] + 4 * i));
+	for (i = 0; i < 5; i++)
+		v[i] = _mm_set_epi32(state[3][i], state[2][i], state[1][i],
+				     state[0][i]);
+	a = v[0];
+	b = v[1];
+	c = v[2];
+	d = v[3];
+	e = v[4];
+
+	k = _mm_set1_epi32(0x5A827999);
+	for (i = 0; i < 16; i++)
+		ROUND_x4(_mm_xor_si128(_mm_and_si128(b, _mm_xor_si128(c, d)),
+				       d), k, w[i]);
+	for (; i < 20; i++)
+		ROUND_x4(_mm_xor_si128(_mm_and_si128(b, _mm_xor_si128(c, d)),
+				       d), k, blk_x4(i));
+	k = _mm_set1_epi32(0x6ED9EBA1);
+	for (; i < 40; i++)
+		ROUND_x4(_mm_xor_si128(_mm_xor_si128(b, c), d), k, blk_x4(i));
+	k = _mm_set1_epi32(0x8F1BBCDC);
+	for (; i < 60; i++)
+		ROUND_x4(_mm_or_si128(_mm_and_si128(_mm_or_si128(b, c), d),
+				      _mm_and_si128(b, c)), k, blk_x4(i));
+	k = _mm_set1_epi32(0xCA62C1D6);
+	for (; i < 80; i++)
+		ROUND_x4(_mm_xor_si128(_mm_xor_si128(b, c), d), k, blk_x4(i));
+
+	v[0] = _mm_add_epi32(v[0], a);
+	v[1] = _mm_add_epi32(v[1], b);
+	v[2] = _mm_add_epi32(v[2], c);
+	v[3] = _mm_add_epi32(v[3], d);
+	v[4] = _mm_add_epi32(v[4], e);
+	for (i = 0; i < 5; i++) {
+		_mm_storeu_si128((__m128i *) tmp, v[i]);
+		for (j = 0; j < 4; j++)
+			state[j][i] = tmp[j];
+	}
+
+	/* Wipe variables */
+	a = b = c = d = e = t = _mm_setzero_si128();
+	forced_memzero(w, sizeof(w));
+	forced_memzero(tmp, sizeof(tmp));
+}
+
+#endif /* __SSE2__ */
+
+
+/**
+ * SHA1Transform_mb - Hash multiple independent 512-bit blocks
+ * @num: Number of blocks (at most SHA1_MB_LANES)
+ * @state: Hash states to update, one for each block
+ * @buffer: Blocks to process
+ *
+ * The result is the same as calling SHA1Transform() separately for each block,
+ * but when SIMD instructions are available, the blocks are processed in
+ * parallel.
+ */
+void SHA1Transform_mb(size_t num, u32 *state[],
+		      const unsigned char *buffer[])
+{
+	size_t i;
+#ifdef __SSE2__
+	u32 *st[4];
+	const unsigned char *buf[4];
+	u32 dummy[5];
+
+	if (num > 1 && num <= 4) {
+		/* Fill in unused lanes with a copy of the first block */
+		os_memcpy(dummy, state[0], sizeof(dummy));
+		for (i = 0; i < 4; i++) {
+			st[i] = i < num ? state[i] : dummy;
+			buf[i] = buffer[i < num ? i : 0];
+		}
+		SHA1Transform_x4(st, buf);
+		return;
+	}
+#endif /* __SSE2__ */
+
+	for (i = 0; i < num; i++)
+		SHA1Transform(state[i], buffer[i]);
+}
+
 /* SHA1Init - Initialize new context */
 
 void SHA1Init(SHA1_CTX* context)
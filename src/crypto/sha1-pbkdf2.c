@@ -10,6 +10,136 @@
 
 #include "common.h"
 #include "sha1.h"
+#ifdef CONFIG_CRYPTO_INTERNAL
+#include "sha1_i.h"
+#endif /* CONFIG_CRYPTO_INTERNAL */
+
+#ifdef CONFIG_CRYPTO_INTERNAL
+
+/*
+ * With the internal SHA1 implementation, the inner and outer hash states after
+ * processing the HMAC key pads are computed only once and each PBKDF2 iteration
+ * after the first one is a single SHA1 block operation for both the inner and
+ * the outer hash. This allows the iterations for multiple passphrases to be
+ * run in parallel with SHA1Transform_mb().
+ */
+struct pbkdf2_sha1_lane {
+	struct SHA1Context inner;
+	struct SHA1Context outer;
+	u32 state[5];
+	u8 block[64];
+	u8 digest[SHA1_MAC_LEN];
+};
+
+
+static void pbkdf2_sha1_lane_init(struct pbkdf2_sha1_lane *lane,
+				  const char *passphrase)
+{
+	const u8 *key = (const u8 *) passphrase;
+	size_t key_len = os_strlen(passphrase);
+	u8 k_pad[64];
+	u8 tk[SHA1_MAC_LEN];
+	size_t i;
+
+	if (key_len > sizeof(k_pad)) {
+		SHA1Init(&lane->inner);
+		SHA1Update(&lane->inner, key, key_len);
+		SHA1Final(tk, &lane->inner);
+		key = tk;
+		key_len = SHA1_MAC_LEN;
+	}
+
+	os_memset(k_pad, 0, sizeof(k_pad));
+	os_memcpy(k_pad, key, key_len);
+	for (i = 0; i < sizeof(k_pad); i++)
+		k_pad[i] ^= 0x36;
+	SHA1Init(&lane->inner);
+	SHA1Update(&lane->inner, k_pad, sizeof(k_pad));
+
+	for (i = 0; i < sizeof(k_pad); i++)
+		k_pad[i] ^= 0x36 ^ 0x5c;
+	SHA1Init(&lane->outer);
+	SHA1Update(&lane->outer, k_pad, sizeof(k_pad));
+
+	forced_memzero(k_pad, sizeof(k_pad));
+	forced_memzero(tk, sizeof(tk));
+}
+
+
+static void pbkdf2_sha1_put_state(u8 *block, const u32 *state)
+{
+	int i;
+
+	for (i = 0; i < 5; i++)
+		WPA_PUT_BE32(&block[4 * i], state[i]);
+}
+
+
+static void pbkdf2_sha1_f_mb(struct pbkdf2_sha1_lane *lanes, size_t num,
+			     const u8 *ssid, size_t ssid_len, int iterations,
+			     unsigned int count)
+{
+	u32 *state[SHA1_MB_LANES];
+	const unsigned char *block[SHA1_MB_LANES];
+	struct SHA1Context ctx;
+	unsigned char count_buf[4];
+	size_t l;
+	int i, j;
+
+	/* F(P, S, c, i) = U1 xor U2 xor ... Uc
+	 * U1 = PRF(P, S || i)
+	 * U2 = PRF(P, U1)
+	 * Uc = PRF(P, Uc-1)
+	 */
+
+	WPA_PUT_BE32(count_buf, count);
+	for (l = 0; l < num; l++) {
+		struct pbkdf2_sha1_lane *lane = &lanes[l];
+		u8 *u = lane->block;
+
+		ctx = lane->inner;
+		SHA1Update(&ctx, ssid, ssid_len);
+		SHA1Update(&ctx, count_buf, 4);
+		SHA1Final(u, &ctx);
+		ctx = lane->outer;
+		SHA1Update(&ctx, u, SHA1_MAC_LEN);
+		SHA1Final(u, &ctx);
+		os_memcpy(lane->digest, u, SHA1_MAC_LEN);
+
+		/* Both the inner and the outer hash of the following iterations
+		 * process a 20 octet message after the 64 octet key pad, so the
+		 * SHA1 padding of the last block is the same for all of them. */
+		os_memset(u + SHA1_MAC_LEN, 0,
+			  sizeof(lane->block) - SHA1_MAC_LEN);
+		u[SHA1_MAC_LEN] = 0x80;
+		WPA_PUT_BE16(&u[62], (64 + SHA1_MAC_LEN) * 8);
+
+		state[l] = lane->state;
+		block[l] = u;
+	}
+
+	for (i = 1; i < iterations; i++) {
+		for (l = 0; l < num; l++)
+			os_memcpy(lanes[l].state, lanes[l].inner.state,
+				  sizeof(lanes[l].state));
+		SHA1Transform_mb(num, state, block);
+		for (l = 0; l < num; l++) {
+			pbkdf2_sha1_put_state(lanes[l].block, lanes[l].state);
+			os_memcpy(lanes[l].state, lanes[l].outer.state,
+				  sizeof(lanes[l].state));
+		}
+		SHA1Transform_mb(num, state, block);
+		for (l = 0; l < num; l++) {
+			pbkdf2_sha1_put_state(lanes[l].block, lanes[l].state);
+			for (j = 0; j < SHA1_MAC_LEN; j++)
+				lanes[l].digest[j] ^= lanes[l].block[j];
+		}
+	}
+
+	forced_memzero(&ctx, sizeof(ctx));
+}
+
+#else /* CONFIG_CRYPTO_INTERNAL */
 
 static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid,
 			 size_t ssid_len, int iterations, unsigned int count,
@@ -56,6 +186,8 @@ static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid,
 	return 0;
 }
 
+#endif /* CONFIG_CRYPTO_INTERNAL */
+
 
 /**
  * pbkdf2_sha1 - SHA1-based key derivation function (PBKDF2) for IEEE 802.11i
@@ -74,6 +206,10 @@ static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid,
 int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
 		int iterations, u8 *buf, size_t buflen)
 {
+#ifdef CONFIG_CRYPTO_INTERNAL
+	return pbkdf2_sha1_mb(1, &passphrase, ssid, ssid_len, iterations, &buf,
+			      buflen);
+#else /* CONFIG_CRYPTO_INTERNAL */
 	unsigned int count = 0;
 	unsigned char *pos = buf;
 	size_t left = buflen, plen;
@@ -92,4 +228,65 @@ int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
 	forced_memzero(digest, SHA1_MAC_LEN);
 
 	return 0;
+#endif /* CONFIG_CRYPTO_INTERNAL */
+}
+
+
+/**
+ * pbkdf2_sha1_mb - PBKDF2-SHA1 for multiple passphrases with the same SSID
+ * @num: Number of passphrases
+ * @passphrase: ASCII passphrases
+ * @ssid: SSID
+ * @ssid_len: SSID length in bytes
+ * @iterations: Number of iterations to run
+ * @buf: Buffers for the generated keys, one for each passphrase
+ * @buflen: Length of each buffer in bytes
+ * Returns: 0 on success, -1 of failure
+ *
+ * This function derives the same keys as calling pbkdf2_sha1() separately for
+ * each passphrase, but with the internal SHA1 implementation the iterations
+ * for the passphrases are processed in parallel when the platform supports
+ * that.
+ */
+int pbkdf2_sha1_mb(size_t num, const char *passphrase[], const u8 *ssid,
+		   size_t ssid_len, int iterations, u8 *buf[], size_t buflen)
+{
+#ifdef CONFIG_CRYPTO_INTERNAL
+	struct pbkdf2_sha1_lane lanes[SHA1_MB_LANES];
+	unsigned int count;
+	size_t first, n, l, pos, plen;
+
+	for (first = 0; first < num; first += n) {
+		n = num - first;
+		if (n > SHA1_MB_LANES)
+			n = SHA1_MB_LANES;
+		for (l = 0; l < n; l++)
+			pbkdf2_sha1_lane_init(&lanes[l], passphrase[first + l]);
+
+		count = 0;
+		for (pos = 0; pos < buflen; pos += plen) {
+			count++;
+			pbkdf2_sha1_f_mb(lanes, n, ssid, ssid_len, iterations,
+					 count);
+			plen = buflen - pos > SHA1_MAC_LEN ?
+				SHA1_MAC_LEN : buflen - pos;
+			for (l = 0; l < n; l++)
+				os_memcpy(buf[first + l] + pos,
+					  lanes[l].digest, plen);
+		}
+	}
+	forced_memzero(lanes, sizeof(lanes));
+
+	return 0;
+#else /* CONFIG_CRYPTO_INTERNAL */
+	size_t i;
+
+	for (i = 0; i < num; i++) {
+		if (pbkdf2_sha1(passphrase[i], ssid, ssid_len, iterations,
+				buf[i], buflen))
+			return -1;
+	}
+
+	return 0;
+#endif /* CONFIG_CRYPTO_INTERNAL */
 }
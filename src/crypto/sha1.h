@@ -24,4 +24,6 @@ int __must_check tls_prf_sha1_md5(const u8 *secret, size_t secret_len,
 				  size_t seed_len, u8 *out, size_t outlen);
 int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
 		int iterations, u8 *buf, size_t buflen);
+int pbkdf2_sha1_mb(size_t num, const char *passphrase[], const u8 *ssid,
+		   size_t ssid_len, int iterations, u8 *buf[], size_t buflen);
 #endif /* SHA1_H */
@@ -9,6 +9,9 @@
 #ifndef SHA1_I_H
 #define SHA1_I_H
 
+/* Maximum number of blocks processed in parallel by SHA1Transform_mb() */
+#define SHA1_MB_LANES 4
+
 struct SHA1Context {
 	u32 state[5];
 	u32 count[2];
@@ -19,5 +22,7 @@ void SHA1Init(struct SHA1Context *context);
 void SHA1Update(struct SHA1Context *context, const void *data, u32 len);
 void SHA1Final(unsigned char digest[20], struct SHA1Context *context);
 void SHA1Transform(u32 state[5], const unsigned char buffer[64]);
+void SHA1Transform_mb(size_t num, u32 *state[],
+		      const unsigned char *buffer[]);
 
 #endif /* SHA1_I_H */
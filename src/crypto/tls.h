@@ -93,6 +93,7 @@ struct tls_config {
 	int cert_in_cb;
 	const char *openssl_ciphers;
 	unsigned int tls_session_lifetime;
+	const char *tls_session_cache;
 	unsigned int crl_reload_interval;
 	unsigned int tls_flags;
 
@@ -656,6 +657,24 @@ tls_connection_get_success_data(struct tls_connection *conn);
 
 void tls_connection_remove_session(struct tls_connection *conn);
 
+/**
+ * tls_get_session_cache_stats - Get TLS session cache statistics
+ * @tls_ctx: TLS context data from tls_init()
+ * @buf: Buffer for returning the statistics as text lines
+ * @buflen: Maximum length of the buffer in bytes
+ * Returns: Number of bytes written to buf or -1 if not supported
+ */
+int tls_get_session_cache_stats(void *tls_ctx, char *buf, size_t buflen);
+
+/**
+ * tls_get_ocsp_stapling_status - Get status of the OCSP stapling response
+ * @tls_ctx: TLS context data from tls_init()
+ * @buf: Buffer for returning the status as text lines
+ * @buflen: Maximum length of the buffer in bytes
+ * Returns: Number of bytes written to buf or -1 if not available
+ */
+int tls_get_ocsp_stapling_status(void *tls_ctx, char *buf, size_t buflen);
+
 /**
  * tls_get_tls_unique - Fetch "tls-unique" for channel binding
  * @conn: Connection context data from tls_connection_init()
@@ -802,3 +802,15 @@ tls_connection_get_success_data(struct tls_connection *conn)
 void tls_connection_remove_session(struct tls_connection *conn)
 {
 }
+
+
+int tls_get_session_cache_stats(void *tls_ctx, char *buf, size_t buflen)
+{
+	return -1;
+}
+
+
+int tls_get_ocsp_stapling_status(void *tls_ctx, char *buf, size_t buflen)
+{
+	return -1;
+}
@@ -10,6 +10,11 @@
 #ifdef CONFIG_TESTING_OPTIONS
 #include <fcntl.h>
 #endif /* CONFIG_TESTING_OPTIONS */
+#ifndef CONFIG_NATIVE_WINDOWS
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#endif /* CONFIG_NATIVE_WINDOWS */
 
 #ifndef CONFIG_SMARTCARD
 #ifndef OPENSSL_NO_ENGINE
@@ -212,13 +217,40 @@ struct tls_session_data {
 	struct wpabuf *buf;
 };
 
+#ifdef HAVE_OCSP
+/* Interval (in seconds) for checking the OCSP stapling response file for
+ * changes and time before nextUpdate to start warning about expiration */
+#define TLS_OCSP_STAPLE_CHECK_INTERVAL 5
+#define TLS_OCSP_STAPLE_EXPIRY_WARNING 3600
+
+/* In-memory copy of the configured OCSP stapling response */
+struct tls_ocsp_staple {
+	struct wpabuf *resp;
+	struct os_reltime last_check;
+	os_time_t this_update; /* 0 if not known */
+	os_time_t next_update; /* 0 if not known */
+	int expiry_warned; /* 1 = expires soon, 2 = expired */
+	unsigned int reloads;
+	unsigned int sent;
+	unsigned int stale;
+	unsigned int errors;
+};
+#endif /* HAVE_OCSP */
+
 struct tls_context {
 	void (*event_cb)(void *ctx, enum tls_event ev,
 			 union tls_event_data *data);
 	void *cb_ctx;
 	int cert_in_cb;
 	char *ocsp_stapling_response;
+#ifdef HAVE_OCSP
+	struct tls_ocsp_staple ocsp_staple;
+#endif /* HAVE_OCSP */
 	struct dl_list sessions; /* struct tls_session_data */
+	char *session_cache; /* external session cache directory */
+	unsigned int session_cache_hits;
+	unsigned int session_cache_misses;
+	unsigned int session_cache_stores;
 };
 
 static struct tls_context *tls_global = NULL;
@@ -954,6 +986,254 @@ static struct tls_session_data * get_session_data(struct tls_context *context,
 }
 
 
+#ifndef CONFIG_NATIVE_WINDOWS
+
+/*
+ * External session cache: each resumable server session is stored in its own
+ * file named by the hex encoded session ID within the configured directory.
+ * The file contains the length of the success data (16-bit, big endian), the
+ * success data, and the DER encoded SSL_SESSION. This allows sessions to be
+ * resumed after a restart and by other processes sharing the directory.
+ */
+
+static int tls_session_cache_fname(struct tls_context *context,
+				   const unsigned char *id, unsigned int id_len,
+				   char *buf, size_t buflen)
+{
+	char hex[2 * SSL_MAX_SSL_SESSION_ID_LENGTH + 1];
+	int ret;
+
+	if (id_len == 0 || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+		return -1;
+	wpa_snprintf_hex(hex, sizeof(hex), id, id_len);
+	ret = os_snprintf(buf, buflen, "%s/%s", context->session_cache, hex);
+	if (os_snprintf_error(buflen, ret))
+		return -1;
+	return 0;
+}
+
+
+static void tls_session_cache_store(struct tls_context *context,
+				    SSL_SESSION *sess,
+				    const struct wpabuf *data)
+{
+	const unsigned char *id;
+	unsigned int id_len;
+	char fname[256], tmp[300];
+	struct wpabuf *buf;
+	unsigned char *pos;
+	int der_len, fd, ret;
+
+	if (!context->session_cache || !data || wpabuf_len(data) > 0xffff)
+		return;
+	id = SSL_SESSION_get_id(sess, &id_len);
+	if (tls_session_cache_fname(context, id, id_len, fname,
+				    sizeof(fname)) < 0)
+		return;
+	der_len = i2d_SSL_SESSION(sess, NULL);
+	if (der_len <= 0)
+		return;
+	buf = wpabuf_alloc(2 + wpabuf_len(data) + der_len);
+	if (!buf)
+		return;
+	wpabuf_put_be16(buf, wpabuf_len(data));
+	wpabuf_put_buf(buf, data);
+	pos = wpabuf_put(buf, der_len);
+	if (i2d_SSL_SESSION(sess, &pos) != der_len)
+		goto fail;
+
+	/* Write to a temporary file and rename it to make the new entry
+	 * visible atomically to other processes using the same directory. */
+	ret = os_snprintf(tmp, sizeof(tmp), "%s.%d.tmp", fname, (int) getpid());
+	if (os_snprintf_error(sizeof(tmp), ret))
+		goto fail;
+	fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd < 0) {
+		wpa_printf(MSG_INFO, "OpenSSL: Could not create %s: %s",
+			   tmp, strerror(errno));
+		goto fail;
+	}
+	if (write(fd, wpabuf_head(buf), wpabuf_len(buf)) !=
+	    (ssize_t) wpabuf_len(buf)) {
+		wpa_printf(MSG_INFO, "OpenSSL: Could not write %s: %s",
+			   tmp, strerror(errno));
+		close(fd);
+		unlink(tmp);
+		goto fail;
+	}
+	close(fd);
+	if (rename(tmp, fname) < 0) {
+		wpa_printf(MSG_INFO, "OpenSSL: Could not rename %s: %s",
+			   tmp, strerror(errno));
+		unlink(tmp);
+		goto fail;
+	}
+
+	context->session_cache_stores++;
+	wpa_printf(MSG_DEBUG, "OpenSSL: Stored session %p to %s", sess, fname);
+fail:
+	wpabuf_clear_free(buf);
+}
+
+
+static void tls_session_cache_remove(struct tls_context *context,
+				     SSL_SESSION *sess)
+{
+	const unsigned char *id;
+	unsigned int id_len;
+	char fname[256];
+
+	if (!context || !context->session_cache)
+		return;
+	id = SSL_SESSION_get_id(sess, &id_len);
+	if (tls_session_cache_fname(context, id, id_len, fname,
+				    sizeof(fname)) == 0 &&
+	    unlink(fname) == 0)
+		wpa_printf(MSG_DEBUG, "OpenSSL: Removed %s", fname);
+}
+
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L && !defined(LIBRESSL_VERSION_NUMBER)
+static SSL_SESSION * tls_session_cache_get_cb(SSL *ssl,
+					      const unsigned char *id,
+					      int id_len, int *copy)
+#else
+static SSL_SESSION * tls_session_cache_get_cb(SSL *ssl, unsigned char *id,
+					      int id_len, int *copy)
+#endif
+{
+	struct tls_context *context;
+	struct tls_session_data *sess_data = NULL;
+	struct wpabuf *data = NULL;
+	SSL_SESSION *sess = NULL;
+	const unsigned char *pos;
+	char fname[256], *buf;
+	size_t len = 0, data_len;
+
+	*copy = 0;
+	context = SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl));
+	if (!context->session_cache || id_len < 0 ||
+	    tls_session_cache_fname(context, id, id_len, fname,
+				    sizeof(fname)) < 0)
+		return NULL;
+
+	buf = os_readfile(fname, &len);
+	if (!buf) {
+		context->session_cache_misses++;
+		return NULL;
+	}
+
+	if (len < 2)
+		goto fail;
+	data_len = WPA_GET_BE16((u8 *) buf);
+	if (data_len > len - 2)
+		goto fail;
+	pos = (const unsigned char *) buf + 2 + data_len;
+	sess = d2i_SSL_SESSION(NULL, &pos, len - 2 - data_len);
+	data = wpabuf_alloc_copy(buf + 2, data_len);
+	sess_data = os_zalloc(sizeof(*sess_data));
+	if (!sess || !data || !sess_data ||
+	    SSL_SESSION_set_ex_data(sess, tls_ex_idx_session, data) != 1)
+		goto fail;
+
+	sess_data->buf = data;
+	dl_list_add(&context->sessions, &sess_data->list);
+	bin_clear_free(buf, len);
+	context->session_cache_hits++;
+	wpa_printf(MSG_DEBUG, "OpenSSL: Loaded session %p from %s",
+		   sess, fname);
+	return sess;
+
+fail:
+	wpa_printf(MSG_INFO, "OpenSSL: Invalid session cache entry %s", fname);
+	unlink(fname);
+	SSL_SESSION_free(sess);
+	wpabuf_free(data);
+	os_free(sess_data);
+	bin_clear_free(buf, len);
+	context->session_cache_misses++;
+	return NULL;
+}
+
+
+static int tls_session_cache_init(struct tls_context *context, SSL_CTX *ssl,
+				  const char *dir, unsigned int lifetime)
+{
+	struct stat st;
+	struct os_time now;
+	struct dirent *ent;
+	char fname[256];
+	DIR *d;
+	int ret;
+
+	if (stat(dir, &st) < 0 || !S_ISDIR(st.st_mode)) {
+		wpa_printf(MSG_ERROR,
+			   "OpenSSL: TLS session cache directory %s not found",
+			   dir);
+		return -1;
+	}
+	if (st.st_mode & (S_IRWXG | S_IRWXO)) {
+		wpa_printf(MSG_ERROR,
+			   "OpenSSL: TLS session cache directory %s must not be accessible by group or others",
+			   dir);
+		return -1;
+	}
+
+	os_free(context->session_cache);
+	context->session_cache = os_strdup(dir);
+	if (!context->session_cache)
+		return -1;
+	SSL_CTX_sess_set_get_cb(ssl, tls_session_cache_get_cb);
+
+	/* Remove entries that have expired since they were stored */
+	os_get_time(&now);
+	d = opendir(dir);
+	if (!d)
+		return 0;
+	while ((ent = readdir(d))) {
+		if (ent->d_name[0] == '.')
+			continue;
+		ret = os_snprintf(fname, sizeof(fname), "%s/%s",
+				  dir, ent->d_name);
+		if (os_snprintf_error(sizeof(fname), ret) ||
+		    stat(fname, &st) < 0 || !S_ISREG(st.st_mode))
+			continue;
+		if ((os_time_t) st.st_mtime + lifetime < now.sec &&
+		    unlink(fname) == 0)
+			wpa_printf(MSG_DEBUG, "OpenSSL: Removed expired %s",
+				   fname);
+	}
+	closedir(d);
+
+	return 0;
+}
+
+#else /* CONFIG_NATIVE_WINDOWS */
+
+static void tls_session_cache_store(struct tls_context *context,
+				    SSL_SESSION *sess,
+				    const struct wpabuf *data)
+{
+}
+
+
+static void tls_session_cache_remove(struct tls_context *context,
+				     SSL_SESSION *sess)
+{
+}
+
+
+static int tls_session_cache_init(struct tls_context *context, SSL_CTX *ssl,
+				  const char *dir, unsigned int lifetime)
+{
+	wpa_printf(MSG_ERROR,
+		   "OpenSSL: External TLS session cache not supported");
+	return -1;
+}
+
+#endif /* CONFIG_NATIVE_WINDOWS */
+
+
 static void remove_session_cb(SSL_CTX *ctx, SSL_SESSION *sess)
 {
 	struct wpabuf *buf;
@@ -964,13 +1244,15 @@ static void remove_session_cb(SSL_CTX *ctx, SSL_SESSION *sess)
 		   "OpenSSL: Remove session %p (tls_ex_idx_session=%d)", sess,
 		   tls_ex_idx_session);
 
+	context = SSL_CTX_get_app_data(ctx);
+	tls_session_cache_remove(context, sess);
+
 	if (tls_ex_idx_session < 0)
 		return;
 	buf = SSL_SESSION_get_ex_data(sess, tls_ex_idx_session);
 	if (!buf)
 		return;
 
-	context = SSL_CTX_get_app_data(ctx);
 	SSL_SESSION_set_ex_data(sess, tls_ex_idx_session, NULL);
 	found = get_session_data(context, buf);
 	if (!found) {
@@ -1153,6 +1435,13 @@ void * tls_init(const struct tls_config *conf)
 		}
 	}
 
+	if (data->tls_session_lifetime > 0 && conf && conf->tls_session_cache &&
+	    tls_session_cache_init(context, ssl, conf->tls_session_cache,
+				   data->tls_session_lifetime) < 0) {
+		tls_deinit(data);
+		return NULL;
+	}
+
 #ifndef OPENSSL_NO_ENGINE
 	wpa_printf(MSG_DEBUG, "ENGINE: Loading builtin engines");
 	ENGINE_load_builtin_engines();
@@ -1190,6 +1479,10 @@ void tls_deinit(void *ssl_ctx)
 	struct tls_context *context = SSL_CTX_get_app_data(ssl);
 	struct tls_session_data *sess_data;
 
+	/* Keep the external session cache entries for other processes and
+	 * for the next start while flushing the local cache. */
+	os_free(context->session_cache);
+	context->session_cache = NULL;
 	if (data->tls_session_lifetime > 0) {
 		wpa_printf(MSG_DEBUG, "OpenSSL: Flush sessions");
 		SSL_CTX_flush_sessions(ssl, 0);
@@ -1222,6 +1515,9 @@ void tls_deinit(void *ssl_ctx)
 #endif /* < 1.1.0 */
 		os_free(tls_global->ocsp_stapling_response);
 		tls_global->ocsp_stapling_response = NULL;
+#ifdef HAVE_OCSP
+		wpabuf_free(tls_global->ocsp_staple.resp);
+#endif /* HAVE_OCSP */
 		os_free(tls_global);
 		tls_global = NULL;
 	}
@@ -3110,7 +3406,11 @@ static int tls_set_conn_flags(struct tls_connection *conn, unsigned int flags,
 	SSL *ssl = conn->ssl;
 
 #ifdef SSL_OP_NO_TICKET
-	if (flags & TLS_CONN_DISABLE_SESSION_TICKET)
+	/* Stateless session tickets cannot be resumed through the external
+	 * session cache, so use session IDs (or stateful tickets with TLS
+	 * v1.3) when that cache is enabled. */
+	if ((flags & TLS_CONN_DISABLE_SESSION_TICKET) ||
+	    conn->context->session_cache)
 		SSL_set_options(ssl, SSL_OP_NO_TICKET);
 	else
 		SSL_clear_options(ssl, SSL_OP_NO_TICKET);
@@ -5218,34 +5518,169 @@ static int ocsp_resp_cb(SSL *s, void *arg)
 }
 
 
+static int ocsp_time_to_os_time(const ASN1_GENERALIZEDTIME *t,
+				os_time_t now, os_time_t *res)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L && !defined(LIBRESSL_VERSION_NUMBER)
+	int days, secs;
+
+	if (!t || !ASN1_TIME_diff(&days, &secs, NULL, t))
+		return -1;
+	*res = now + (os_time_t) days * 86400 + secs;
+	return 0;
+#else
+	return -1;
+#endif
+}
+
+
+static void ocsp_staple_parse(struct tls_ocsp_staple *staple)
+{
+	const unsigned char *pos = wpabuf_head(staple->resp);
+	OCSP_RESPONSE *resp;
+	OCSP_BASICRESP *basic = NULL;
+	ASN1_GENERALIZEDTIME *this_upd, *next_upd;
+	struct os_time now;
+	os_time_t t;
+	int i, reason;
+
+	staple->this_update = 0;
+	staple->next_update = 0;
+	staple->expiry_warned = 0;
+
+	resp = d2i_OCSP_RESPONSE(NULL, &pos, wpabuf_len(staple->resp));
+	if (resp &&
+	    OCSP_response_status(resp) == OCSP_RESPONSE_STATUS_SUCCESSFUL)
+		basic = OCSP_response_get1_basic(resp);
+	if (!basic) {
+		wpa_printf(MSG_INFO,
+			   "OpenSSL: Could not parse OCSP stapling response - validity time not known");
+		staple->errors++;
+		OCSP_RESPONSE_free(resp);
+		return;
+	}
+
+	/* Use the oldest thisUpdate and the earliest nextUpdate from all the
+	 * included responses */
+	os_get_time(&now);
+	for (i = 0; i < OCSP_resp_count(basic); i++) {
+		this_upd = next_upd = NULL;
+		OCSP_single_get0_status(OCSP_resp_get0(basic, i), &reason,
+					NULL, &this_upd, &next_upd);
+		if (ocsp_time_to_os_time(this_upd, now.sec, &t) == 0 &&
+		    (!staple->this_update || t < staple->this_update))
+			staple->this_update = t;
+		if (ocsp_time_to_os_time(next_upd, now.sec, &t) == 0 &&
+		    (!staple->next_update || t < staple->next_update))
+			staple->next_update = t;
+	}
+
+	OCSP_BASICRESP_free(basic);
+	OCSP_RESPONSE_free(resp);
+}
+
+
+static void ocsp_staple_refresh(struct tls_ocsp_staple *staple,
+				const char *fname)
+{
+	struct os_reltime now;
+	char *buf;
+	size_t len;
+
+	os_get_reltime(&now);
+	if (os_reltime_initialized(&staple->last_check) &&
+	    !os_reltime_expired(&now, &staple->last_check,
+				TLS_OCSP_STAPLE_CHECK_INTERVAL))
+		return;
+	staple->last_check = now;
+
+	buf = os_readfile(fname, &len);
+	if (!buf) {
+		if (staple->resp)
+			wpa_printf(MSG_INFO,
+				   "OpenSSL: Could not read OCSP stapling response file %s - drop cached response",
+				   fname);
+		wpabuf_free(staple->resp);
+		staple->resp = NULL;
+		staple->errors++;
+		return;
+	}
+
+	if (staple->resp && wpabuf_len(staple->resp) == len &&
+	    os_memcmp(wpabuf_head(staple->resp), buf, len) == 0) {
+		os_free(buf);
+		return;
+	}
+
+	wpabuf_free(staple->resp);
+	staple->resp = wpabuf_alloc_ext_data((u8 *) buf, len);
+	if (!staple->resp) {
+		os_free(buf);
+		staple->errors++;
+		return;
+	}
+	staple->reloads++;
+	ocsp_staple_parse(staple);
+	wpa_printf(MSG_DEBUG,
+		   "OpenSSL: Loaded OCSP stapling response from %s (%zu bytes, nextUpdate in %ld seconds)",
+		   fname, len,
+		   staple->next_update ?
+		   (long) (staple->next_update - now.sec) : -1L);
+}
+
+
+static void ocsp_staple_check_validity(struct tls_ocsp_staple *staple)
+{
+	struct os_time now;
+
+	if (!staple->next_update)
+		return;
+	os_get_time(&now);
+	if (now.sec > staple->next_update) {
+		staple->stale++;
+		if (staple->expiry_warned < 2)
+			wpa_printf(MSG_INFO,
+				   "OpenSSL: Cached OCSP stapling response has expired");
+		staple->expiry_warned = 2;
+	} else if (!staple->expiry_warned &&
+		   staple->next_update - now.sec <
+		   TLS_OCSP_STAPLE_EXPIRY_WARNING) {
+		wpa_printf(MSG_INFO,
+			   "OpenSSL: Cached OCSP stapling response expires in %ld seconds",
+			   (long) (staple->next_update - now.sec));
+		staple->expiry_warned = 1;
+	}
+}
+
+
 static int ocsp_status_cb(SSL *s, void *arg)
 {
+	struct tls_ocsp_staple *staple = &tls_global->ocsp_staple;
 	char *tmp;
-	char *resp;
-	size_t len;
 
 	if (tls_global->ocsp_stapling_response == NULL) {
 		wpa_printf(MSG_DEBUG, "OpenSSL: OCSP status callback - no response configured");
 		return SSL_TLSEXT_ERR_OK;
 	}
 
-	resp = os_readfile(tls_global->ocsp_stapling_response, &len);
-	if (resp == NULL) {
+	ocsp_staple_refresh(staple, tls_global->ocsp_stapling_response);
+	if (!staple->resp) {
 		wpa_printf(MSG_DEBUG, "OpenSSL: OCSP status callback - could not read response file");
 		/* TODO: Build OCSPResponse with responseStatus = internalError
 		 */
 		return SSL_TLSEXT_ERR_OK;
 	}
+	/* An expired response is still sent to let the peer report the
+	 * failure in the same way as it would for any other stale response */
+	ocsp_staple_check_validity(staple);
 	wpa_printf(MSG_DEBUG, "OpenSSL: OCSP status callback - send cached response");
-	tmp = OPENSSL_malloc(len);
-	if (tmp == NULL) {
-		os_free(resp);
+	tmp = OPENSSL_malloc(wpabuf_len(staple->resp));
+	if (tmp == NULL)
 		return SSL_TLSEXT_ERR_ALERT_FATAL;
-	}
 
-	os_memcpy(tmp, resp, len);
-	os_free(resp);
-	SSL_set_tlsext_status_ocsp_resp(s, tmp, len);
+	os_memcpy(tmp, wpabuf_head(staple->resp), wpabuf_len(staple->resp));
+	SSL_set_tlsext_status_ocsp_resp(s, tmp, wpabuf_len(staple->resp));
+	staple->sent++;
 
 	return SSL_TLSEXT_ERR_OK;
 }
@@ -5761,11 +6196,17 @@ int tls_global_set_params(void *tls_ctx,
 	SSL_CTX_set_tlsext_status_cb(ssl_ctx, ocsp_status_cb);
 	SSL_CTX_set_tlsext_status_arg(ssl_ctx, ssl_ctx);
 	os_free(tls_global->ocsp_stapling_response);
-	if (params->ocsp_stapling_response)
+	wpabuf_free(tls_global->ocsp_staple.resp);
+	os_memset(&tls_global->ocsp_staple, 0, sizeof(tls_global->ocsp_staple));
+	if (params->ocsp_stapling_response) {
 		tls_global->ocsp_stapling_response =
 			os_strdup(params->ocsp_stapling_response);
-	else
+		if (tls_global->ocsp_stapling_response)
+			ocsp_staple_refresh(&tls_global->ocsp_staple,
+					    tls_global->ocsp_stapling_response);
+	} else {
 		tls_global->ocsp_stapling_response = NULL;
+	}
 #endif /* HAVE_OCSP */
 
 	openssl_debug_dump_ctx(ssl_ctx);
@@ -5935,6 +6376,7 @@ void tls_connection_set_success_data(struct tls_connection *conn,
 	wpa_printf(MSG_DEBUG, "OpenSSL: Stored success data %p (sess %p)",
 		   data, sess);
 	conn->success_data = 1;
+	tls_session_cache_store(conn->context, sess, data);
 	return;
 
 fail:
@@ -5972,15 +6414,95 @@ void tls_connection_remove_session(struct tls_connection *conn)
 	if (!sess)
 		return;
 
-	if (SSL_CTX_remove_session(conn->ssl_ctx, sess) != 1)
+	if (SSL_CTX_remove_session(conn->ssl_ctx, sess) != 1) {
 		wpa_printf(MSG_DEBUG,
 			   "OpenSSL: Session was not cached");
-	else
+		tls_session_cache_remove(conn->context, sess);
+	} else
 		wpa_printf(MSG_DEBUG,
 			   "OpenSSL: Removed cached session to disable session resumption");
 }
 
 
+int tls_get_session_cache_stats(void *tls_ctx, char *buf, size_t buflen)
+{
+	struct tls_data *data = tls_ctx;
+	SSL_CTX *ssl = data->ssl;
+	struct tls_context *context = SSL_CTX_get_app_data(ssl);
+	int ret;
+
+	ret = os_snprintf(buf, buflen,
+			  "tls_session_cache_entries=%ld\n"
+			  "tls_session_cache_hits=%ld\n"
+			  "tls_session_cache_misses=%ld\n"
+			  "tls_session_cache_timeouts=%ld\n"
+			  "tls_session_cache_ext_hits=%u\n"
+			  "tls_session_cache_ext_misses=%u\n"
+			  "tls_session_cache_ext_stores=%u\n",
+			  SSL_CTX_sess_number(ssl),
+			  SSL_CTX_sess_hits(ssl),
+			  SSL_CTX_sess_misses(ssl),
+			  SSL_CTX_sess_timeouts(ssl),
+			  context->session_cache_hits,
+			  context->session_cache_misses,
+			  context->session_cache_stores);
+	if (os_snprintf_error(buflen, ret))
+		return -1;
+	return ret;
+}
+
+
+int tls_get_ocsp_stapling_status(void *tls_ctx, char *buf, size_t buflen)
+{
+#ifdef HAVE_OCSP
+	struct tls_ocsp_staple *staple;
+	struct os_time now;
+	char *pos = buf, *end = buf + buflen;
+	int ret;
+
+	if (!tls_global || !tls_global->ocsp_stapling_response)
+		return -1;
+	staple = &tls_global->ocsp_staple;
+	os_get_time(&now);
+
+	ret = os_snprintf(pos, end - pos, "ocsp_stapling_loaded=%d\n",
+			  !!staple->resp);
+	if (os_snprintf_error(end - pos, ret))
+		return -1;
+	pos += ret;
+	if (staple->resp && staple->this_update) {
+		ret = os_snprintf(pos, end - pos, "ocsp_stapling_age=%ld\n",
+				  (long) (now.sec - staple->this_update));
+		if (os_snprintf_error(end - pos, ret))
+			return -1;
+		pos += ret;
+	}
+	if (staple->resp && staple->next_update) {
+		ret = os_snprintf(pos, end - pos,
+				  "ocsp_stapling_expires_in=%ld\n",
+				  (long) (staple->next_update - now.sec));
+		if (os_snprintf_error(end - pos, ret))
+			return -1;
+		pos += ret;
+	}
+	ret = os_snprintf(pos, end - pos,
+			  "ocsp_stapling_reloads=%u\n"
+			  "ocsp_stapling_sent=%u\n"
+			  "ocsp_stapling_stale=%u\n"
+			  "ocsp_stapling_errors=%u\n",
+			  staple->reloads, staple->sent, staple->stale,
+			  staple->errors);
+	if (os_snprintf_error(end - pos, ret))
+		return -1;
+	pos += ret;
+
+	return pos - buf;
+#else /* HAVE_OCSP */
+	return -1;
+#endif /* HAVE_OCSP */
+}
+
+
 int tls_get_tls_unique(struct tls_connection *conn, u8 *buf, size_t max_len)
 {
 	size_t len;
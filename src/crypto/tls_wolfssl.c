@@ -2225,6 +2225,18 @@ void tls_connection_remove_session(struct tls_connection *conn)
 }
 
 
+int tls_get_session_cache_stats(void *tls_ctx, char *buf, size_t buflen)
+{
+	return -1;
+}
+
+
+int tls_get_ocsp_stapling_status(void *tls_ctx, char *buf, size_t buflen)
+{
+	return -1;
+}
+
+
 int tls_get_tls_unique(struct tls_connection *conn, u8 *buf, size_t max_len)
 {
 	size_t len;
@@ -154,6 +154,34 @@ struct hostapd_channel_data {
 	 * need to set this)
 	 */
 	long double interference_factor;
+
+	/**
+	 * acs_factor_sum - Sum of the per-survey interference factors of the
+	 * processed survey_list entries (used internally in src/ap/acs.c)
+	 */
+	long double acs_factor_sum;
+
+	/**
+	 * acs_num_factors - Number of surveys included in acs_factor_sum
+	 */
+	unsigned int acs_num_factors;
+
+	/**
+	 * acs_num_surveys - Number of survey_list entries processed so far
+	 */
+	unsigned int acs_num_surveys;
+
+	/**
+	 * acs_factor_nf - Interface lowest noise floor that was used for the
+	 * factors in acs_factor_sum
+	 */
+	s8 acs_factor_nf;
+
+	/**
+	 * acs_scored - Whether interference_factor was computed for this
+	 * channel in the last ACS study
+	 */
+	bool acs_scored;
 #endif /* CONFIG_ACS */
 
 	/**
@@ -122,9 +122,14 @@ static void nl_destroy_handles(struct nl_sock **handle)
 #define ELOOP_SOCKET_INVALID	(intptr_t) 0x88888889ULL
 #endif
 
-static void nl80211_register_eloop_read(struct nl_sock **handle,
-					eloop_sock_handler handler,
-					void *eloop_data, int persist)
+/* Default RX buffer size for event sockets; see driver_params
+ * event_buf_size=<bytes> */
+#define NL80211_EVENT_BUF_SIZE 262144
+
+/* Maximum number of netlink datagrams to process per event socket wakeup */
+#define NL80211_EVENT_BATCH 64
+
+static void nl80211_set_event_buf_size(struct nl_sock *handle, int buf_size)
 {
 	/*
 	 * libnl uses a pretty small buffer (32 kB that gets converted to 64 kB)
@@ -135,14 +140,22 @@ static void nl80211_register_eloop_read(struct nl_sock **handle,
 	 */
 	int err;
 
-	err = nl_socket_set_buffer_size(*handle, 262144, 0);
+	err = nl_socket_set_buffer_size(handle, buf_size, 0);
 	if (err < 0) {
 		wpa_printf(MSG_DEBUG,
 			   "nl80211: Could not set nl_socket RX buffer size: %s",
 			   nl_geterror(err));
 		/* continue anyway with the default (smaller) buffer */
 	}
+}
+
 
+static void nl80211_register_eloop_read(struct nl_sock **handle,
+					eloop_sock_handler handler,
+					void *eloop_data, int persist,
+					int buf_size)
+{
+	nl80211_set_event_buf_size(*handle, buf_size);
 	nl_socket_set_nonblocking(*handle);
 	eloop_register_read_sock(nl_socket_get_fd(*handle), handler,
 				 eloop_data, *handle);
@@ -152,13 +165,50 @@ static void nl80211_register_eloop_read(struct nl_sock **handle,
 }
 
 
-static void nl80211_destroy_eloop_handle(struct nl_sock **handle, int persist)
+static void nl80211_destroy_eloop_handle(struct nl80211_global *global,
+					 struct nl_sock **handle, int persist)
 {
 	if (!persist)
 		*handle = (void *) (((intptr_t) *handle) ^
 				    ELOOP_SOCKET_INVALID);
 	eloop_unregister_read_sock(nl_socket_get_fd(*handle));
 	nl_destroy_handles(handle);
+	global->event_sock_gen++;
+}
+
+
+static void nl80211_set_eloop_buf_size(struct nl_sock *handle, int persist,
+				       int buf_size)
+{
+	if (!handle)
+		return;
+	if (!persist)
+		handle = (void *) (((intptr_t) handle) ^ ELOOP_SOCKET_INVALID);
+	nl80211_set_event_buf_size(handle, buf_size);
+}
+
+
+/* Apply the configured RX buffer size to all registered event sockets; the
+ * ones created later pick it up when they are registered */
+static void nl80211_update_event_buf_size(struct nl80211_global *global)
+{
+	struct wpa_driver_nl80211_data *drv;
+	struct i802_bss *bss;
+	int size = global->event_buf_size;
+
+	nl80211_set_eloop_buf_size(global->nl_event, 0, size);
+
+	dl_list_for_each(drv, &global->interfaces,
+			 struct wpa_driver_nl80211_data, list) {
+		for (bss = drv->first_bss; bss; bss = bss->next) {
+			nl80211_set_eloop_buf_size(bss->nl_connect, 1, size);
+			nl80211_set_eloop_buf_size(bss->nl_mgmt, 0, size);
+			nl80211_set_eloop_buf_size(bss->nl_preq, 0, size);
+			if (bss->wiphy_data)
+				nl80211_set_eloop_buf_size(
+					bss->wiphy_data->nl_beacons, 0, size);
+		}
+	}
 }
 
 
@@ -967,7 +1017,8 @@ nl80211_get_wiphy_data_ap(struct i802_bss *bss)
 		}
 
 		nl80211_register_eloop_read(&w->nl_beacons,
-					    nl80211_recv_beacons, w, 0);
+					    nl80211_recv_beacons, w, 0,
+					    bss->drv->global->event_buf_size);
 	}
 
 	dl_list_add(&nl80211_wiphys, &w->list);
@@ -1016,7 +1067,8 @@ static void nl80211_put_wiphy_data_ap(struct i802_bss *bss)
 		return;
 
 	if (w->nl_beacons)
-		nl80211_destroy_eloop_handle(&w->nl_beacons, 0);
+		nl80211_destroy_eloop_handle(bss->drv->global, &w->nl_beacons,
+					     0);
 
 	nl_cb_put(w->nl_cb);
 	dl_list_del(&w->list);
@@ -1847,19 +1899,131 @@ static int nl80211_channel_info(void *priv, struct wpa_channel_info *ci)
 }
 
 
-static void wpa_driver_nl80211_event_receive(int sock, void *eloop_ctx,
-					     void *handle)
+/*
+ * Check whether a netlink datagram is queued without consuming it. Returns 1
+ * if there is one, 0 if not, or -1 if the kernel reported that events were
+ * dropped (ENOBUFS). The socket error is cleared by this call.
+ */
+static int nl80211_event_peek(struct nl_sock *handle)
 {
-	struct nl_cb *cb = eloop_ctx;
-	int res;
+	char c;
+
+	if (recv(nl_socket_get_fd(handle), &c, 1, MSG_PEEK | MSG_DONTWAIT) >= 0)
+		return 1;
+	return errno == ENOBUFS ? -1 : 0;
+}
+
+
+/*
+ * Process queued netlink datagrams (up to NL80211_EVENT_BATCH) instead of only
+ * one per wakeup to drain the socket before the kernel runs out of receive
+ * buffer space during event bursts. The event callbacks may remove the socket
+ * or deinitialize the interface that owns it and cb, so the batch is stopped
+ * without accessing handle or cb again once any event socket has been removed.
+ * Returns true if the socket overflowed and events were lost.
+ */
+static bool nl80211_event_receive_batch(struct nl80211_global *global,
+					struct nl_sock *handle,
+					struct nl_cb *cb)
+{
+	unsigned int count = 0, gen = global->event_sock_gen;
+	bool overrun = false;
+	int pending, res;
 
 	wpa_printf(MSG_MSGDUMP, "nl80211: Event message available");
 
-	res = nl_recvmsgs(handle, cb);
-	if (res < 0) {
-		wpa_printf(MSG_INFO, "nl80211: %s->nl_recvmsgs failed: %d",
-			   __func__, res);
+	while (count < NL80211_EVENT_BATCH) {
+		pending = nl80211_event_peek(handle);
+		if (pending < 0) {
+			global->event_overruns++;
+			overrun = true;
+			pending = nl80211_event_peek(handle);
+		}
+		if (pending <= 0)
+			break;
+
+		res = nl_recvmsgs(handle, cb);
+		count++;
+		if (res < 0) {
+			global->event_errors++;
+			wpa_printf(MSG_INFO,
+				   "nl80211: %s->nl_recvmsgs failed: %d",
+				   __func__, res);
+			break;
+		}
+		if (global->event_sock_gen != gen)
+			break;
 	}
+
+	global->event_wakeups++;
+	global->event_reads += count;
+	if (count > global->event_max_batch)
+		global->event_max_batch = count;
+
+	if (overrun)
+		wpa_printf(MSG_INFO,
+			   "nl80211: Event socket overrun - events lost (buffer size %d)",
+			   global->event_buf_size);
+
+	return overrun;
+}
+
+
+/*
+ * Recover from lost events by fetching the current state from the kernel
+ * instead of waiting for the next event that happens to update it.
+ */
+static void nl80211_event_resync(struct wpa_driver_nl80211_data *drv)
+{
+	wpa_printf(MSG_DEBUG, "nl80211: Resync state of %s after event loss",
+		   drv->first_bss->ifname);
+
+	if (drv->scan_state == SCAN_REQUESTED ||
+	    drv->scan_state == SCAN_STARTED) {
+		/* Scan completion may have been lost; use the scan timeout
+		 * handler to either abort the scan or fetch the results. */
+		eloop_cancel_timeout(wpa_driver_nl80211_scan_timeout, drv,
+				     drv->ctx);
+		eloop_register_timeout(5, 0, wpa_driver_nl80211_scan_timeout,
+				       drv, drv->ctx);
+	}
+
+	/* Refresh the operating channel from the scan result dump in case a
+	 * channel switch event was lost */
+	if (drv->associated && !is_ap_interface(drv->nlmode))
+		nl80211_get_assoc_freq(drv);
+}
+
+
+static void nl80211_event_resync_all(struct nl80211_global *global)
+{
+	struct wpa_driver_nl80211_data *drv;
+
+	dl_list_for_each(drv, &global->interfaces,
+			 struct wpa_driver_nl80211_data, list)
+		nl80211_event_resync(drv);
+}
+
+
+static void nl80211_global_event_receive(int sock, void *eloop_ctx,
+					 void *handle)
+{
+	struct nl80211_global *global = eloop_ctx;
+
+	if (nl80211_event_receive_batch(global, handle, global->nl_cb))
+		nl80211_event_resync_all(global);
+}
+
+
+static void nl80211_bss_event_receive(int sock, void *eloop_ctx, void *handle)
+{
+	struct i802_bss *bss = eloop_ctx;
+	struct nl80211_global *global = bss->drv->global;
+
+	/* bss may be freed by the event callbacks, so it is not accessed after
+	 * this */
+	if (nl80211_event_receive_batch(global, handle, bss->nl_cb))
+		nl80211_event_resync_all(global);
 }
 
 
@@ -2050,8 +2214,8 @@ static int wpa_driver_nl80211_init_nl_global(struct nl80211_global *global)
 		  process_global_event, global);
 
 	nl80211_register_eloop_read(&global->nl_event,
-				    wpa_driver_nl80211_event_receive,
-				    global->nl_cb, 0);
+				    nl80211_global_event_receive,
+				    global, 0, global->event_buf_size);
 
 	return 0;
 
@@ -2202,8 +2366,8 @@ static int nl80211_init_connect_handle(struct i802_bss *bss)
 	if (!bss->nl_connect)
 		return -1;
 	nl80211_register_eloop_read(&bss->nl_connect,
-				    wpa_driver_nl80211_event_receive,
-				    bss->nl_cb, 1);
+				    nl80211_bss_event_receive, bss, 1,
+				    bss->drv->global->event_buf_size);
 	return 0;
 }
 
@@ -2231,7 +2395,8 @@ static void nl80211_destroy_bss(struct i802_bss *bss)
 	bss->nl_cb = NULL;
 
 	if (bss->nl_connect)
-		nl80211_destroy_eloop_handle(&bss->nl_connect, 1);
+		nl80211_destroy_eloop_handle(bss->drv->global,
+					     &bss->nl_connect, 1);
 }
 
 
@@ -2485,8 +2650,8 @@ static int nl80211_alloc_mgmt_handle(struct i802_bss *bss)
 static void nl80211_mgmt_handle_register_eloop(struct i802_bss *bss)
 {
 	nl80211_register_eloop_read(&bss->nl_mgmt,
-				    wpa_driver_nl80211_event_receive,
-				    bss->nl_cb, 0);
+				    nl80211_bss_event_receive, bss, 0,
+				    bss->drv->global->event_buf_size);
 }
 
 
@@ -2851,7 +3016,7 @@ static void nl80211_mgmt_unsubscribe(struct i802_bss *bss, const char *reason)
 		return;
 	wpa_printf(MSG_DEBUG, "nl80211: Unsubscribe mgmt frames handle %p "
 		   "(%s)", bss->nl_mgmt, reason);
-	nl80211_destroy_eloop_handle(&bss->nl_mgmt, 0);
+	nl80211_destroy_eloop_handle(bss->drv->global, &bss->nl_mgmt, 0);
 
 	nl80211_put_wiphy_data_ap(bss);
 }
@@ -9410,7 +9575,8 @@ static int wpa_driver_nl80211_probe_req_report(struct i802_bss *bss, int report)
 		} else if (bss->nl_preq) {
 			wpa_printf(MSG_DEBUG, "nl80211: Disable Probe Request "
 				   "reporting nl_preq=%p", bss->nl_preq);
-			nl80211_destroy_eloop_handle(&bss->nl_preq, 0);
+			nl80211_destroy_eloop_handle(drv->global,
+						     &bss->nl_preq, 0);
 		}
 		return 0;
 	}
@@ -9434,8 +9600,8 @@ static int wpa_driver_nl80211_probe_req_report(struct i802_bss *bss, int report)
 		goto out_err;
 
 	nl80211_register_eloop_read(&bss->nl_preq,
-				    wpa_driver_nl80211_event_receive,
-				    bss->nl_cb, 0);
+				    nl80211_bss_event_receive, bss, 0,
+				    bss->drv->global->event_buf_size);
 
 	return 0;
 
@@ -9863,6 +10029,7 @@ static int nl80211_set_param(void *priv, const char *param)
 {
 	struct i802_bss *bss = priv;
 	struct wpa_driver_nl80211_data *drv = bss->drv;
+	const char *pos;
 
 	if (param == NULL)
 		return 0;
@@ -9928,6 +10095,19 @@ static int nl80211_set_param(void *priv, const char *param)
 			WPA_DRIVER_FLAGS2_SEC_LTF_AP;
 	}
 
+	pos = os_strstr(param, "event_buf_size=");
+	if (pos) {
+		int val = atoi(pos + 15);
+
+		if (val > 0) {
+			wpa_printf(MSG_DEBUG,
+				   "nl80211: Event socket RX buffer size %d",
+				   val);
+			drv->global->event_buf_size = val;
+			nl80211_update_event_buf_size(drv->global);
+		}
+	}
+
 	return 0;
 }
 
@@ -9951,6 +10131,7 @@ static void * nl80211_global_init(void *ctx)
 	global->ioctl_sock = -1;
 	dl_list_init(&global->interfaces);
 	global->if_add_ifindex = -1;
+	global->event_buf_size = NL80211_EVENT_BUF_SIZE;
 
 	cfg = os_zalloc(sizeof(*cfg));
 	if (cfg == NULL)
@@ -10000,7 +10181,7 @@ static void nl80211_global_deinit(void *priv)
 	nl_destroy_handles(&global->nl);
 
 	if (global->nl_event)
-		nl80211_destroy_eloop_handle(&global->nl_event, 0);
+		nl80211_destroy_eloop_handle(global, &global->nl_event, 0);
 
 	nl_cb_put(global->nl_cb);
 
@@ -11016,6 +11197,23 @@ static int wpa_driver_nl80211_status(void *priv, char *buf, size_t buflen)
 		return pos - buf;
 	pos += res;
 
+	res = os_snprintf(pos, end - pos,
+			  "event_buf_size=%d\n"
+			  "event_wakeups=%lu\n"
+			  "event_reads=%lu\n"
+			  "event_max_batch=%u\n"
+			  "event_overruns=%u\n"
+			  "event_errors=%u\n",
+			  drv->global->event_buf_size,
+			  drv->global->event_wakeups,
+			  drv->global->event_reads,
+			  drv->global->event_max_batch,
+			  drv->global->event_overruns,
+			  drv->global->event_errors);
+	if (os_snprintf_error(end - pos, res))
+		return pos - buf;
+	pos += res;
+
 	if (drv->sta_mlo_info.valid_links) {
 		int i;
 		struct driver_sta_mlo_info *mlo = &drv->sta_mlo_info;
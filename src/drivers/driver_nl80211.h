@@ -37,6 +37,16 @@ struct nl80211_global {
 	int ioctl_sock; /* socket for ioctl() use */
 
 	struct nl_sock *nl_event;
+
+	int event_buf_size; /* RX buffer size for nl80211 event sockets */
+	/* Incremented whenever an event socket is removed */
+	unsigned int event_sock_gen;
+	/* Event socket receive statistics */
+	unsigned long event_reads;
+	unsigned long event_wakeups;
+	unsigned int event_max_batch;
+	unsigned int event_overruns;
+	unsigned int event_errors;
 };
 
 struct nl80211_wiphy_data {
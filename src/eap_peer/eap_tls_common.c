@@ -510,7 +510,18 @@ static int eap_peer_tls_reassemble_fragment(struct eap_ssl_data *data,
 		return -1;
 	}
 
-	if (wpabuf_resize(&data->tls_in, in_len) < 0) {
+	if (!data->tls_in) {
+		/* Allocate the full message on the first fragment to avoid
+		 * reallocating and copying the buffer for each fragment. */
+		if (data->tls_in_left > 65536) {
+			wpa_printf(MSG_INFO,
+				   "SSL: Too long TLS message (size over 64 kB)");
+			eap_peer_tls_reset_input(data);
+			return -1;
+		}
+		data->tls_in = wpabuf_alloc(data->tls_in_left);
+	}
+	if (!data->tls_in) {
 		wpa_printf(MSG_INFO, "SSL: Could not allocate memory for TLS "
 			   "data");
 		eap_peer_tls_reset_input(data);
@@ -540,7 +551,9 @@ static int eap_peer_tls_reassemble_fragment(struct eap_ssl_data *data,
  * for the full message (in which case, *need_more_input is also set to 1).
  *
  * This function reassembles TLS fragments. Caller must not free the returned
- * data buffer since an internal pointer to it is maintained.
+ * data buffer since an internal pointer to it is maintained. An unfragmented
+ * message is returned as a reference to in_data, so the returned buffer must
+ * not be used after in_data has been freed.
  */
 static const struct wpabuf * eap_peer_tls_data_reassemble(
 	struct eap_ssl_data *data, const struct wpabuf *in_data,
@@ -559,11 +572,11 @@ static const struct wpabuf * eap_peer_tls_data_reassemble(
 
 		/* Message is now fully reassembled. */
 	} else {
-		/* No fragments in this message, so just make a copy of it. */
+		/* Wrap unfragmented messages as wpabuf without extra copy */
 		data->tls_in_left = 0;
-		data->tls_in = wpabuf_dup(in_data);
-		if (data->tls_in == NULL)
-			return NULL;
+		wpabuf_set(&data->tmpbuf, wpabuf_head(in_data),
+			   wpabuf_len(in_data));
+		data->tls_in = &data->tmpbuf;
 	}
 
 	return data->tls_in;
@@ -970,10 +983,9 @@ const u8 * eap_peer_tls_process_init(struct eap_sm *sm,
 		wpa_printf(MSG_DEBUG, "SSL: TLS Message Length: %d",
 			   tls_msg_len);
 		if (data->tls_in_left == 0) {
+			eap_peer_tls_reset_input(data);
 			data->tls_in_total = tls_msg_len;
 			data->tls_in_left = tls_msg_len;
-			wpabuf_free(data->tls_in);
-			data->tls_in = NULL;
 		}
 		pos += 4;
 		left -= 4;
@@ -1007,7 +1019,8 @@ const u8 * eap_peer_tls_process_init(struct eap_sm *sm,
 void eap_peer_tls_reset_input(struct eap_ssl_data *data)
 {
 	data->tls_in_left = data->tls_in_total = 0;
-	wpabuf_free(data->tls_in);
+	if (data->tls_in != &data->tmpbuf)
+		wpabuf_free(data->tls_in);
 	data->tls_in = NULL;
 }
 
@@ -48,6 +48,12 @@ struct eap_ssl_data {
 	 */
 	size_t tls_in_total;
 
+	/**
+	 * tmpbuf - Buffer for referencing an unfragmented message as tls_in
+	 * without copying it
+	 */
+	struct wpabuf tmpbuf;
+
 	/**
 	 * phase2 - Whether this TLS connection is used in EAP phase 2 (tunnel)
 	 */
@@ -113,6 +113,8 @@ struct eloop_data {
 };
 
 static struct eloop_data eloop;
+static struct os_pool eloop_timeout_pool =
+	OS_POOL_INIT("eloop_timeout", struct eloop_timeout);
 
 
 #ifdef WPA_TRACE
@@ -776,11 +778,11 @@ int eloop_register_timeout(unsigned int secs, unsigned int usecs,
 	struct eloop_timeout *timeout, *tmp;
 	os_time_t now_sec;
 
-	timeout = os_zalloc(sizeof(*timeout));
+	timeout = os_pool_zalloc(&eloop_timeout_pool);
 	if (timeout == NULL)
 		return -1;
 	if (os_get_reltime(&timeout->time) < 0) {
-		os_free(timeout);
+		os_pool_free(&eloop_timeout_pool, timeout);
 		return -1;
 	}
 	now_sec = timeout->time.sec;
@@ -820,7 +822,7 @@ overflow:
 	wpa_printf(MSG_DEBUG,
 		   "ELOOP: Too long timeout (secs=%u usecs=%u) to ever happen - ignore it",
 		   secs,usecs);
-	os_free(timeout);
+	os_pool_free(&eloop_timeout_pool, timeout);
 	return 0;
 }
 
@@ -830,7 +832,7 @@ static void eloop_remove_timeout(struct eloop_timeout *timeout)
 	dl_list_del(&timeout->list);
 	wpa_trace_remove_ref(timeout, eloop, timeout->eloop_data);
 	wpa_trace_remove_ref(timeout, user, timeout->user_data);
-	os_free(timeout);
+	os_pool_free(&eloop_timeout_pool, timeout);
 }
 
 
@@ -626,6 +626,88 @@ int os_memcmp_const(const void *a, const void *b, size_t len);
  */
 void * os_memdup(const void *src, size_t len);
 
+/**
+ * struct os_pool - Pool of fixed size objects
+ * @name: Name of the pool for statistics
+ * @size: Size of each object in octets
+ *
+ * With CONFIG_OS_POOL, objects are allocated from slabs with per-pool free
+ * lists to avoid heap fragmentation with frequently allocated and freed
+ * objects. Without it (or with WPA_TRACE for allocation tracking), the objects
+ * are allocated with os_zalloc(). Pools are defined statically with
+ * OS_POOL_INIT() and do not need to be initialized.
+ */
+struct os_pool {
+	const char *name;
+	size_t size;
+#ifdef CONFIG_OS_POOL
+	struct os_pool *next;
+	struct os_pool_slab *partial;
+	struct os_pool_slab *empty;
+	unsigned int in_use;
+	unsigned int peak;
+	unsigned int slabs;
+	unsigned long allocs;
+	bool registered;
+#endif /* CONFIG_OS_POOL */
+};
+
+#define OS_POOL_INIT(name, type) { (name), sizeof(type) }
+
+#ifdef CONFIG_OS_POOL
+
+/**
+ * os_pool_zalloc - Allocate and zero an object from a pool
+ * @pool: Pool to allocate from
+ * Returns: Pointer to the allocated and zeroed object or %NULL on failure
+ *
+ * Caller is responsible for freeing the returned object with os_pool_free().
+ */
+void * os_pool_zalloc(struct os_pool *pool);
+
+/**
+ * os_pool_free - Free an object allocated with os_pool_zalloc()
+ * @pool: Pool from which the object was allocated
+ * @ptr: Object to free or %NULL
+ */
+void os_pool_free(struct os_pool *pool, void *ptr);
+
+/**
+ * os_pool_stats - Get pool statistics in text format
+ * @buf: Buffer for the statistics text
+ * @buflen: Length of buf in octets
+ * Returns: Number of octets written to buf or -1 on failure
+ */
+int os_pool_stats(char *buf, size_t buflen);
+
+/**
+ * os_pool_flush - Free unused slabs from all pools
+ */
+void os_pool_flush(void);
+
+#else /* CONFIG_OS_POOL */
+
+static inline void * os_pool_zalloc(struct os_pool *pool)
+{
+	return os_zalloc(pool->size);
+}
+
+static inline void os_pool_free(struct os_pool *pool, void *ptr)
+{
+	os_free(ptr);
+}
+
+static inline int os_pool_stats(char *buf, size_t buflen)
+{
+	return -1;
+}
+
+static inline void os_pool_flush(void)
+{
+}
+
+#endif /* CONFIG_OS_POOL */
+
 /**
  * os_exec - Execute an external program
  * @program: Path to the program
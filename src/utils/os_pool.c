@@ -0,0 +1,226 @@
+/*
+ * Pool allocator for fixed size objects
+ * Copyright (c) 2026, Jouni Malinen <j@w1.fi>
+ *
+ * This software may be distributed under the terms of the BSD license.
+ * See README for more details.
+ */
+
+#include "includes.h"
+
+#include "common.h"
+
+
+/* Target slab size and minimum number of objects per slab */
+#define OS_POOL_SLAB_SIZE 4096
+#define OS_POOL_SLAB_MIN_OBJS 4
+#define OS_POOL_ALIGN(len) (((len) + 15) & ~((size_t) 15))
+
+struct os_pool_obj {
+	struct os_pool_slab *slab;
+	struct os_pool_obj *next; /* next free object in the slab */
+};
+
+struct os_pool_slab {
+	struct os_pool_slab *next; /* next slab on the partial list */
+	struct os_pool_slab *prev;
+	struct os_pool_obj *free;
+	unsigned int used;
+	unsigned int num_objs;
+};
+
+static struct os_pool *os_pools = NULL;
+
+
+static void os_pool_register(struct os_pool *pool)
+{
+	if (pool->registered)
+		return;
+	pool->next = os_pools;
+	os_pools = pool;
+	pool->registered = true;
+}
+
+
+#ifndef WPA_TRACE
+
+static void os_pool_partial_add(struct os_pool *pool,
+				struct os_pool_slab *slab)
+{
+	slab->prev = NULL;
+	slab->next = pool->partial;
+	if (pool->partial)
+		pool->partial->prev = slab;
+	pool->partial = slab;
+}
+
+
+static void os_pool_partial_del(struct os_pool *pool,
+				struct os_pool_slab *slab)
+{
+	if (slab->prev)
+		slab->prev->next = slab->next;
+	else
+		pool->partial = slab->next;
+	if (slab->next)
+		slab->next->prev = slab->prev;
+	slab->next = slab->prev = NULL;
+}
+
+
+static struct os_pool_slab * os_pool_slab_alloc(struct os_pool *pool)
+{
+	struct os_pool_slab *slab;
+	struct os_pool_obj *obj;
+	size_t stride = OS_POOL_ALIGN(sizeof(*obj)) +
+		OS_POOL_ALIGN(pool->size);
+	size_t hdr_len = OS_POOL_ALIGN(sizeof(*slab));
+	unsigned int i, num_objs;
+	u8 *pos;
+
+	num_objs = (OS_POOL_SLAB_SIZE - hdr_len) / stride;
+	if (num_objs < OS_POOL_SLAB_MIN_OBJS)
+		num_objs = OS_POOL_SLAB_MIN_OBJS;
+
+	slab = os_malloc(hdr_len + num_objs * stride);
+	if (!slab)
+		return NULL;
+	os_memset(slab, 0, sizeof(*slab));
+	slab->num_objs = num_objs;
+
+	pos = (u8 *) slab + hdr_len + (num_objs - 1) * stride;
+	for (i = 0; i < num_objs; i++) {
+		obj = (struct os_pool_obj *) pos;
+		obj->slab = slab;
+		obj->next = slab->free;
+		slab->free = obj;
+		pos -= stride;
+	}
+
+	pool->slabs++;
+	return slab;
+}
+
+
+static void os_pool_slab_free(struct os_pool *pool, struct os_pool_slab *slab)
+{
+	pool->slabs--;
+	os_free(slab);
+}
+
+#endif /* WPA_TRACE */
+
+
+void * os_pool_zalloc(struct os_pool *pool)
+{
+#ifdef WPA_TRACE
+	/* Allocate each object separately to keep allocation tracking and
+	 * use-after-free detection working for pool objects. */
+	void *ptr;
+
+	ptr = os_zalloc(pool->size);
+	if (!ptr)
+		return NULL;
+#else /* WPA_TRACE */
+	struct os_pool_slab *slab;
+	struct os_pool_obj *obj;
+	void *ptr;
+
+	slab = pool->partial;
+	if (!slab) {
+		slab = pool->empty;
+		pool->empty = NULL;
+		if (!slab)
+			slab = os_pool_slab_alloc(pool);
+		if (!slab)
+			return NULL;
+		os_pool_partial_add(pool, slab);
+	}
+
+	obj = slab->free;
+	slab->free = obj->next;
+	obj->next = NULL;
+	if (++slab->used == slab->num_objs)
+		os_pool_partial_del(pool, slab);
+
+	ptr = (u8 *) obj + OS_POOL_ALIGN(sizeof(*obj));
+	os_memset(ptr, 0, pool->size);
+#endif /* WPA_TRACE */
+
+	os_pool_register(pool);
+	pool->allocs++;
+	if (++pool->in_use > pool->peak)
+		pool->peak = pool->in_use;
+	return ptr;
+}
+
+
+void os_pool_free(struct os_pool *pool, void *ptr)
+{
+#ifndef WPA_TRACE
+	struct os_pool_slab *slab;
+	struct os_pool_obj *obj;
+#endif /* WPA_TRACE */
+
+	if (!ptr)
+		return;
+	pool->in_use--;
+
+#ifdef WPA_TRACE
+	os_free(ptr);
+#else /* WPA_TRACE */
+	obj = (struct os_pool_obj *) ((u8 *) ptr -
+				      OS_POOL_ALIGN(sizeof(*obj)));
+	slab = obj->slab;
+	obj->next = slab->free;
+	slab->free = obj;
+	if (slab->used-- == slab->num_objs)
+		os_pool_partial_add(pool, slab);
+	if (slab->used)
+		return;
+
+	/* Keep one empty slab cached to avoid allocating and freeing a slab for
+	 * each object when the number of objects stays around a slab boundary.
+	 */
+	os_pool_partial_del(pool, slab);
+	if (pool->empty)
+		os_pool_slab_free(pool, slab);
+	else
+		pool->empty = slab;
+#endif /* WPA_TRACE */
+}
+
+
+int os_pool_stats(char *buf, size_t buflen)
+{
+	struct os_pool *pool;
+	char *pos = buf, *end = buf + buflen;
+	int ret;
+
+	for (pool = os_pools; pool; pool = pool->next) {
+		ret = os_snprintf(pos, end - pos,
+				  "%s size=%zu in_use=%u peak=%u slabs=%u allocs=%lu\n",
+				  pool->name, pool->size, pool->in_use,
+				  pool->peak, pool->slabs, pool->allocs);
+		if (os_snprintf_error(end - pos, ret))
+			return pos - buf;
+		pos += ret;
+	}
+
+	return pos - buf;
+}
+
+
+void os_pool_flush(void)
+{
+#ifndef WPA_TRACE
+	struct os_pool *pool;
+
+	for (pool = os_pools; pool; pool = pool->next) {
+		if (pool->empty) {
+			os_pool_slab_free(pool, pool->empty);
+			pool->empty = NULL;
+		}
+	}
+#endif /* WPA_TRACE */
+}
@@ -549,7 +549,7 @@ int testing_test_fail(const char *tag, bool is_alloc)
 {
 	const char *ignore_list[] = {
 		"os_malloc", "os_zalloc", "os_calloc", "os_realloc",
-		"os_realloc_array", "os_strdup", "os_memdup"
+		"os_realloc_array", "os_strdup", "os_memdup", "os_pool_zalloc"
 	};
 	const char *func[WPA_TRACE_LEN];
 	size_t i, j, res, len, idx;
@@ -557,6 +557,55 @@ static int wpabuf_tests(void)
 	if (buf != NULL)
 		errors++;
 
+	/* Arena allocation, in place extension, and move to heap */
+	wpabuf_arena_begin();
+	buf = wpabuf_alloc(10);
+	if (buf) {
+		struct wpabuf *buf2, *buf3;
+		u8 *pos;
+
+		pos = wpabuf_put(buf, 10);
+		os_memset(pos, 0x11, 10);
+		if (wpabuf_resize(&buf, 100) < 0 ||
+		    wpabuf_tailroom(buf) != 100)
+			errors++;
+		else
+			os_memset(wpabuf_put(buf, 100), 0x22, 100);
+
+		buf2 = wpabuf_alloc_copy(wpabuf_head(buf), wpabuf_len(buf));
+		buf3 = wpabuf_alloc(20000);
+		if (!buf2 || !buf3 || wpabuf_cmp(buf, buf2) != 0)
+			errors++;
+		wpabuf_free(buf3);
+
+		/* Not the last allocation anymore, so this moves to heap */
+		if (wpabuf_resize(&buf, 5000) < 0 ||
+		    wpabuf_len(buf) != 110 ||
+		    wpabuf_head_u8(buf)[0] != 0x11 ||
+		    os_memcmp(wpabuf_head(buf), wpabuf_head(buf2), 110) != 0)
+			errors++;
+		else
+			wpabuf_put(buf, 5000);
+		wpabuf_free(buf);
+		wpabuf_clear_free(buf2);
+	} else {
+		errors++;
+	}
+	wpabuf_arena_end();
+
+	/* Nested scope and a buffer left in use after the scope */
+	wpabuf_arena_begin();
+	buf = wpabuf_alloc(10);
+	wpabuf_arena_end();
+	wpabuf_arena_end();
+	if (buf) {
+		wpabuf_put(buf, 10);
+		wpabuf_free(buf);
+	} else {
+		errors++;
+	}
+	wpabuf_arena_deinit();
+
 	if (errors) {
 		wpa_printf(MSG_ERROR, "%d wpabuf test(s) failed", errors);
 		return -1;
@@ -566,6 +615,129 @@ static int wpabuf_tests(void)
 }
 
 
+#ifdef CONFIG_DEBUG_RINGBUF
+static int debug_ring_tests(void)
+{
+	int errors = 0;
+	char buf[200];
+	u8 data[3000];
+	int i;
+
+	wpa_printf(MSG_INFO, "debug ring buffer tests");
+
+	if (wpa_debug_ring_status(buf, sizeof(buf)) >= 0) {
+		wpa_printf(MSG_INFO,
+			   "Debug ring buffer in use - skip debug ring buffer tests");
+		return 0;
+	}
+
+	if (wpa_debug_ring_init(100, 0) == 0)
+		errors++;
+	if (wpa_debug_ring_init(4096, 1) < 0) {
+		wpa_printf(MSG_ERROR, "Failed to enable debug ring buffer");
+		return -1;
+	}
+
+	os_memset(data, 0xa5, sizeof(data));
+	for (i = 0; i < 200; i++)
+		wpa_printf(MSG_ERROR, "debug ring test message %d", i);
+	wpa_hexdump(MSG_ERROR, "debug ring test hexdump", data, sizeof(data));
+	wpa_hexdump_key(MSG_ERROR, "debug ring test key", data, 16);
+	wpa_hexdump_ascii(MSG_ERROR, "debug ring test ascii", NULL, 0);
+
+	if (wpa_debug_ring_status(buf, sizeof(buf)) < 0 ||
+	    !os_strstr(buf, "size=4096\n") ||
+	    !os_strstr(buf, "lost=0\n") ||
+	    !os_strstr(buf, "dropped=0\n") ||
+	    !os_strstr(buf, "flight_recorder=1\n") ||
+	    os_strstr(buf, "records=0\n"))
+		errors++;
+
+	wpa_debug_ring_deinit();
+	if (wpa_debug_ring_status(buf, sizeof(buf)) >= 0)
+		errors++;
+
+	if (errors) {
+		wpa_printf(MSG_ERROR, "%d debug ring buffer test(s) failed",
+			   errors);
+		return -1;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_DEBUG_RINGBUF */
+
+
+#ifdef CONFIG_OS_POOL
+struct os_pool_test_obj {
+	u8 data[100];
+};
+
+static int os_pool_tests(void)
+{
+	static struct os_pool pool =
+		OS_POOL_INIT("module_test", struct os_pool_test_obj);
+	struct os_pool_test_obj *obj[100];
+	int errors = 0;
+	char buf[500];
+	int i, j;
+
+	wpa_printf(MSG_INFO, "os_pool tests");
+
+	for (i = 0; i < (int) ARRAY_SIZE(obj); i++) {
+		obj[i] = os_pool_zalloc(&pool);
+		if (!obj[i]) {
+			wpa_printf(MSG_ERROR, "os_pool_zalloc failed");
+			while (--i >= 0)
+				os_pool_free(&pool, obj[i]);
+			return -1;
+		}
+		for (j = 0; j < (int) sizeof(obj[i]->data); j++) {
+			if (obj[i]->data[j])
+				errors++;
+		}
+		os_memset(obj[i]->data, i, sizeof(obj[i]->data));
+	}
+
+	for (i = 0; i < (int) ARRAY_SIZE(obj); i++) {
+		for (j = 0; j < (int) sizeof(obj[i]->data); j++) {
+			if (obj[i]->data[j] != i)
+				errors++;
+		}
+	}
+
+	if (os_pool_stats(buf, sizeof(buf)) <= 0 ||
+	    !os_strstr(buf, "module_test size=100 in_use=100 peak=100 "))
+		errors++;
+
+	/* Free every other object and reallocate to exercise the free lists */
+	for (i = 0; i < (int) ARRAY_SIZE(obj); i += 2)
+		os_pool_free(&pool, obj[i]);
+	for (i = 0; i < (int) ARRAY_SIZE(obj); i += 2) {
+		obj[i] = os_pool_zalloc(&pool);
+		if (!obj[i] || obj[i]->data[0] || obj[i]->data[99])
+			errors++;
+	}
+
+	for (i = 0; i < (int) ARRAY_SIZE(obj); i++)
+		os_pool_free(&pool, obj[i]);
+	os_pool_free(&pool, NULL);
+	os_pool_flush();
+
+	if (os_pool_stats(buf, sizeof(buf)) <= 0 ||
+	    !os_strstr(buf, "module_test size=100 in_use=0 peak=100 slabs=0 allocs=150\n"))
+		errors++;
+
+	if (errors) {
+		wpa_printf(MSG_ERROR, "%d os_pool test(s) failed", errors);
+		return -1;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_OS_POOL */
+
+
 static int ip_addr_tests(void)
 {
 	int errors = 0;
@@ -1223,6 +1395,12 @@ int utils_module_tests(void)
 	    common_tests() < 0 ||
 	    os_tests() < 0 ||
 	    wpabuf_tests() < 0 ||
+#ifdef CONFIG_DEBUG_RINGBUF
+	    debug_ring_tests() < 0 ||
+#endif /* CONFIG_DEBUG_RINGBUF */
+#ifdef CONFIG_OS_POOL
+	    os_pool_tests() < 0 ||
+#endif /* CONFIG_OS_POOL */
 	    ip_addr_tests() < 0 ||
 	    eloop_tests() < 0 ||
 	    json_tests() < 0 ||
@@ -31,8 +31,19 @@ int wpa_debug_level = MSG_INFO;
 int wpa_debug_show_keys = 0;
 int wpa_debug_timestamp = 0;
 int wpa_debug_syslog = 0;
+#ifdef CONFIG_DEBUG_LINUX_TRACING
+int wpa_debug_tracing = 0;
+#endif /* CONFIG_DEBUG_LINUX_TRACING */
 #ifndef CONFIG_NO_STDOUT_DEBUG
 static FILE *out_file = NULL;
+
+/* The functions below implement the wpa_printf() and wpa_hexdump*() wrapper
+ * macros from wpa_debug.h. */
+#undef wpa_printf
+#undef wpa_hexdump
+#undef wpa_hexdump_key
+#undef wpa_hexdump_ascii
+#undef wpa_hexdump_ascii_key
 #endif /* CONFIG_NO_STDOUT_DEBUG */
 
 
@@ -65,6 +76,438 @@ static int wpa_to_android_level(int level)
 #include <fcntl.h>
 #endif /* CONFIG_DEBUG_FILE */
 
+#ifdef CONFIG_DEBUG_RINGBUF
+
+/*
+ * In-memory debug log ring buffer
+ *
+ * When enabled, debug messages that would otherwise be written to stdout or
+ * the debug file are stored as binary records in a ring buffer instead. Text
+ * messages are formatted into the record, but hexdumps are stored as raw
+ * bytes and formatted only when the record is flushed. Records are written
+ * out either periodically with wpa_debug_ring_flush() (called from the
+ * eloop) or, in flight recorder mode, only on request with
+ * wpa_debug_ring_dump(). In flight recorder mode, messages below the debug
+ * level are stored in the ring as well so that a dump shows the full details
+ * leading to a problem, but they are never written out by themselves. The ring
+ * is owned by the single eloop thread, so no locking is needed.
+ */
+
+#define WPA_DEBUG_RING_MAX_TEXT 2048
+#define WPA_DEBUG_RING_MAX_TITLE 200
+#define WPA_DEBUG_RING_ALIGN(len) (((len) + 7) & ~((size_t) 7))
+
+enum wpa_debug_ring_type {
+	WPA_DEBUG_RING_PAD,
+	WPA_DEBUG_RING_TEXT,
+	WPA_DEBUG_RING_HEXDUMP,
+	WPA_DEBUG_RING_HEXDUMP_ASCII,
+};
+
+#define WPA_DEBUG_RING_FLAG_NULL BIT(0)
+#define WPA_DEBUG_RING_FLAG_REMOVED BIT(1)
+
+struct wpa_debug_ring_rec {
+	u32 len; /* total record length, including this header */
+	u8 type; /* enum wpa_debug_ring_type */
+	u8 flags; /* WPA_DEBUG_RING_FLAG_* */
+	u16 title_len;
+	u32 data_len; /* original length of hexdump data */
+	u32 usec;
+	os_time_t sec;
+};
+
+struct wpa_debug_ring {
+	u8 *buf;
+	size_t size;
+	size_t head; /* offset for the next record */
+	size_t tail; /* offset of the oldest record */
+	size_t used; /* bytes in use from tail to head */
+	size_t flush; /* offset of the oldest record not yet flushed */
+	size_t unflushed; /* bytes in use from flush to head */
+	int flight_recorder;
+	unsigned int records;
+	unsigned long lost;
+	unsigned long dropped;
+};
+
+static struct wpa_debug_ring *wpa_debug_ring = NULL;
+int wpa_debug_flight_recorder = 0;
+
+
+static struct wpa_debug_ring_rec *
+wpa_debug_ring_rec_at(struct wpa_debug_ring *ring, size_t pos)
+{
+	if (ring->size - pos < sizeof(struct wpa_debug_ring_rec))
+		return NULL; /* implicit padding at the end of the buffer */
+	return (struct wpa_debug_ring_rec *) (ring->buf + pos);
+}
+
+
+/* Returns the length of the record at pos, including any padding */
+static size_t wpa_debug_ring_rec_len(struct wpa_debug_ring *ring, size_t pos)
+{
+	struct wpa_debug_ring_rec *rec = wpa_debug_ring_rec_at(ring, pos);
+
+	return rec ? rec->len : ring->size - pos;
+}
+
+
+static void wpa_debug_ring_drop_oldest(struct wpa_debug_ring *ring)
+{
+	struct wpa_debug_ring_rec *rec;
+	size_t len;
+
+	rec = wpa_debug_ring_rec_at(ring, ring->tail);
+	len = wpa_debug_ring_rec_len(ring, ring->tail);
+	if (rec && rec->type != WPA_DEBUG_RING_PAD)
+		ring->records--;
+	if (ring->unflushed && ring->flush == ring->tail) {
+		if (rec && rec->type != WPA_DEBUG_RING_PAD &&
+		    !ring->flight_recorder)
+			ring->lost++;
+		ring->unflushed -= len;
+		ring->flush = (ring->flush + len) % ring->size;
+	}
+	ring->used -= len;
+	ring->tail = (ring->tail + len) % ring->size;
+}
+
+
+static struct wpa_debug_ring_rec *
+wpa_debug_ring_reserve(struct wpa_debug_ring *ring, size_t len)
+{
+	struct wpa_debug_ring_rec *rec;
+	size_t waste = 0;
+
+	len = WPA_DEBUG_RING_ALIGN(len);
+	if (len > ring->size / 2) {
+		ring->dropped++;
+		return NULL;
+	}
+
+	if (!ring->used)
+		ring->head = ring->tail = ring->flush = 0;
+	if (ring->size - ring->head < len)
+		waste = ring->size - ring->head;
+	while (ring->used && ring->size - ring->used < waste + len)
+		wpa_debug_ring_drop_oldest(ring);
+
+	if (waste) {
+		rec = wpa_debug_ring_rec_at(ring, ring->head);
+		if (rec) {
+			os_memset(rec, 0, sizeof(*rec));
+			rec->len = waste;
+			rec->type = WPA_DEBUG_RING_PAD;
+		}
+		ring->used += waste;
+		ring->unflushed += waste;
+		ring->head = 0;
+	}
+
+	rec = (struct wpa_debug_ring_rec *) (ring->buf + ring->head);
+	os_memset(rec, 0, sizeof(*rec));
+	rec->len = len;
+	ring->head = (ring->head + len) % ring->size;
+	ring->used += len;
+	ring->unflushed += len;
+	ring->records++;
+	return rec;
+}
+
+
+static void wpa_debug_ring_add_text(const char *fmt, va_list ap)
+{
+	struct wpa_debug_ring_rec *rec;
+	struct os_time tv;
+	char txt[WPA_DEBUG_RING_MAX_TEXT];
+	int res;
+
+	res = vsnprintf(txt, sizeof(txt), fmt, ap);
+	if (res < 0)
+		return;
+	if ((size_t) res >= sizeof(txt))
+		res = sizeof(txt) - 1;
+
+	rec = wpa_debug_ring_reserve(wpa_debug_ring, sizeof(*rec) + res);
+	if (!rec)
+		return;
+	os_get_time(&tv);
+	rec->type = WPA_DEBUG_RING_TEXT;
+	rec->data_len = res;
+	rec->sec = tv.sec;
+	rec->usec = tv.usec;
+	os_memcpy(rec + 1, txt, res);
+}
+
+
+static void wpa_debug_ring_add_hexdump(int type, const char *title,
+				       const u8 *buf, size_t len, int show)
+{
+	struct wpa_debug_ring_rec *rec;
+	struct os_time tv;
+	size_t title_len, data_len = 0, max_len;
+
+	title_len = os_strlen(title);
+	if (title_len > WPA_DEBUG_RING_MAX_TITLE)
+		title_len = WPA_DEBUG_RING_MAX_TITLE;
+	if (buf && show) {
+		/* Store as much of the data as fits in a single record */
+		max_len = wpa_debug_ring->size / 2 - sizeof(*rec) - title_len;
+		data_len = len > max_len ? max_len : len;
+	}
+
+	rec = wpa_debug_ring_reserve(wpa_debug_ring,
+				     sizeof(*rec) + title_len + data_len);
+	if (!rec)
+		return;
+	os_get_time(&tv);
+	rec->type = type;
+	if (!buf)
+		rec->flags |= WPA_DEBUG_RING_FLAG_NULL;
+	else if (!show)
+		rec->flags |= WPA_DEBUG_RING_FLAG_REMOVED;
+	rec->title_len = title_len;
+	rec->data_len = len;
+	rec->sec = tv.sec;
+	rec->usec = tv.usec;
+	os_memcpy(rec + 1, title, title_len);
+	if (data_len)
+		os_memcpy((u8 *) (rec + 1) + title_len, buf, data_len);
+}
+
+
+static void wpa_debug_ring_print_rec(FILE *f, struct wpa_debug_ring_rec *rec)
+{
+	const char *title = (const char *) (rec + 1);
+	const u8 *pos = (const u8 *) (rec + 1) + rec->title_len;
+	size_t len, llen, i;
+	const size_t line_len = 16;
+
+	if (wpa_debug_timestamp)
+		fprintf(f, "%ld.%06u: ", (long) rec->sec, rec->usec);
+
+	if (rec->type == WPA_DEBUG_RING_TEXT) {
+		fprintf(f, "%.*s\n", (int) rec->data_len, title);
+		return;
+	}
+
+	len = rec->len - sizeof(*rec) - rec->title_len;
+	if (len > rec->data_len)
+		len = rec->data_len; /* alignment padding */
+
+	if (rec->type == WPA_DEBUG_RING_HEXDUMP) {
+		fprintf(f, "%.*s - hexdump(len=%lu):", (int) rec->title_len,
+			title, (unsigned long) rec->data_len);
+		if (rec->flags & WPA_DEBUG_RING_FLAG_NULL) {
+			fprintf(f, " [NULL]");
+		} else if (rec->flags & WPA_DEBUG_RING_FLAG_REMOVED) {
+			fprintf(f, " [REMOVED]");
+		} else {
+			for (i = 0; i < len; i++)
+				fprintf(f, " %02x", pos[i]);
+			if (len < rec->data_len)
+				fprintf(f, " [TRUNCATED]");
+		}
+		fprintf(f, "\n");
+		return;
+	}
+
+	fprintf(f, "%.*s - hexdump_ascii(len=%lu):", (int) rec->title_len,
+		title, (unsigned long) rec->data_len);
+	if (rec->flags & WPA_DEBUG_RING_FLAG_REMOVED) {
+		fprintf(f, " [REMOVED]\n");
+		return;
+	}
+	if (rec->flags & WPA_DEBUG_RING_FLAG_NULL) {
+		fprintf(f, " [NULL]\n");
+		return;
+	}
+	fprintf(f, "%s\n", len < rec->data_len ? " [TRUNCATED]" : "");
+	while (len) {
+		llen = len > line_len ? line_len : len;
+		fprintf(f, "    ");
+		for (i = 0; i < llen; i++)
+			fprintf(f, " %02x", pos[i]);
+		for (i = llen; i < line_len; i++)
+			fprintf(f, "   ");
+		fprintf(f, "   ");
+		for (i = 0; i < llen; i++) {
+			if (isprint(pos[i]))
+				fprintf(f, "%c", pos[i]);
+			else
+				fprintf(f, "_");
+		}
+		for (i = llen; i < line_len; i++)
+			fprintf(f, " ");
+		fprintf(f, "\n");
+		pos += llen;
+		len -= llen;
+	}
+}
+
+
+static FILE * wpa_debug_ring_out(void)
+{
+#ifdef CONFIG_DEBUG_FILE
+	if (out_file)
+		return out_file;
+#endif /* CONFIG_DEBUG_FILE */
+	return stdout;
+}
+
+
+static void wpa_debug_ring_print(size_t pos, size_t len)
+{
+	struct wpa_debug_ring *ring = wpa_debug_ring;
+	struct wpa_debug_ring_rec *rec;
+	FILE *f = wpa_debug_ring_out();
+	size_t rlen;
+
+	while (len) {
+		rec = wpa_debug_ring_rec_at(ring, pos);
+		rlen = wpa_debug_ring_rec_len(ring, pos);
+		if (rec && rec->type != WPA_DEBUG_RING_PAD)
+			wpa_debug_ring_print_rec(f, rec);
+		pos = (pos + rlen) % ring->size;
+		len -= rlen;
+	}
+	fflush(f);
+}
+
+
+/**
+ * wpa_debug_ring_init - Start logging into an in-memory ring buffer
+ * @size: Size of the ring buffer in octets
+ * @flight_recorder: Whether to keep records in the ring buffer until
+ *	explicitly dumped instead of flushing them to the log output
+ * Returns: 0 on success, -1 on failure
+ */
+int wpa_debug_ring_init(size_t size, int flight_recorder)
+{
+	struct wpa_debug_ring *ring;
+
+	size = WPA_DEBUG_RING_ALIGN(size);
+	if (size < 4096)
+		return -1;
+
+	wpa_debug_ring_deinit();
+	ring = os_zalloc(sizeof(*ring));
+	if (!ring)
+		return -1;
+	ring->buf = os_malloc(size);
+	if (!ring->buf) {
+		os_free(ring);
+		return -1;
+	}
+	ring->size = size;
+	ring->flight_recorder = flight_recorder;
+	wpa_debug_ring = ring;
+	wpa_debug_flight_recorder = flight_recorder;
+	return 0;
+}
+
+
+/**
+ * wpa_debug_ring_deinit - Stop logging into the ring buffer
+ *
+ * Any records that have not yet been flushed are written to the log output
+ * unless the ring buffer is used in flight recorder mode.
+ */
+void wpa_debug_ring_deinit(void)
+{
+	struct wpa_debug_ring *ring = wpa_debug_ring;
+
+	if (!ring)
+		return;
+	if (!ring->flight_recorder)
+		wpa_debug_ring_flush();
+	wpa_debug_ring = NULL;
+	wpa_debug_flight_recorder = 0;
+	bin_clear_free(ring->buf, ring->size);
+	os_free(ring);
+}
+
+
+/**
+ * wpa_debug_ring_flush - Write pending ring buffer records to the log output
+ *
+ * This is expected to be called periodically from the event loop. Nothing is
+ * written in flight recorder mode.
+ */
+void wpa_debug_ring_flush(void)
+{
+	struct wpa_debug_ring *ring = wpa_debug_ring;
+
+	if (!ring || ring->flight_recorder || !ring->unflushed)
+		return;
+	wpa_debug_ring_print(ring->flush, ring->unflushed);
+	ring->flush = ring->head;
+	ring->unflushed = 0;
+}
+
+
+/**
+ * wpa_debug_ring_dump - Write all records in the ring buffer to the log output
+ * Returns: 0 on success, -1 if the ring buffer is not in use
+ *
+ * This writes out all records that are still stored in the ring buffer,
+ * including the ones that have already been flushed.
+ */
+int wpa_debug_ring_dump(void)
+{
+	struct wpa_debug_ring *ring = wpa_debug_ring;
+	FILE *f;
+
+	if (!ring)
+		return -1;
+	f = wpa_debug_ring_out();
+	fprintf(f, "---- debug ring buffer dump start (%u records) ----\n",
+		ring->records);
+	wpa_debug_ring_print(ring->tail, ring->used);
+	fprintf(f, "---- debug ring buffer dump end ----\n");
+	fflush(f);
+	if (!ring->flight_recorder) {
+		ring->flush = ring->head;
+		ring->unflushed = 0;
+	}
+	return 0;
+}
+
+
+/**
+ * wpa_debug_ring_status - Get ring buffer status in text format
+ * @buf: Buffer for the status text
+ * @buflen: Length of buf in octets
+ * Returns: Number of octets written to buf or -1 if the ring buffer is not in
+ *	use
+ */
+int wpa_debug_ring_status(char *buf, size_t buflen)
+{
+	struct wpa_debug_ring *ring = wpa_debug_ring;
+	int ret;
+
+	if (!ring)
+		return -1;
+	ret = os_snprintf(buf, buflen,
+			  "size=%zu\n"
+			  "used=%zu\n"
+			  "unflushed=%zu\n"
+			  "records=%u\n"
+			  "lost=%lu\n"
+			  "dropped=%lu\n"
+			  "flight_recorder=%d\n",
+			  ring->size, ring->used,
+			  ring->flight_recorder ? 0 : ring->unflushed,
+			  ring->records, ring->lost, ring->dropped,
+			  ring->flight_recorder);
+	if (os_snprintf_error(buflen, ret))
+		return -1;
+	return ret;
+}
+
+#endif /* CONFIG_DEBUG_RINGBUF */
+
 
 void wpa_debug_print_timestamp(void)
 {
@@ -73,6 +516,10 @@ void wpa_debug_print_timestamp(void)
 
 	if (!wpa_debug_timestamp)
 		return;
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (wpa_debug_ring)
+		return; /* records carry their own timestamps */
+#endif /* CONFIG_DEBUG_RINGBUF */
 
 	os_get_time(&tv);
 #ifdef CONFIG_DEBUG_FILE
@@ -179,6 +626,7 @@ int wpa_debug_open_linux_tracing(void)
 		printf("failed to fdopen()\n");
 		return -1;
 	}
+	wpa_debug_tracing = 1;
 
 	return 0;
 }
@@ -190,6 +638,7 @@ void wpa_debug_close_linux_tracing(void)
 		return;
 	fclose(wpa_debug_tracing_file);
 	wpa_debug_tracing_file = NULL;
+	wpa_debug_tracing = 0;
 }
 
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
@@ -202,7 +651,10 @@ void wpa_debug_close_linux_tracing(void)
  *
  * This function is used to print conditional debugging and error messages. The
  * output may be directed to stdout, stderr, and/or syslog based on
- * configuration.
+ * configuration. When the in-memory ring buffer is enabled, it replaces stdout
+ * and the debug file. In flight recorder mode, messages below the debug level
+ * still go to the ring buffer and are written out only with
+ * wpa_debug_ring_dump().
  *
  * Note: New line '\n' is added to the end of the text when printing to stdout.
  */
@@ -210,6 +662,26 @@ void wpa_printf(int level, const char *fmt, ...)
 {
 	va_list ap;
 
+#ifdef CONFIG_DEBUG_LINUX_TRACING
+	if (wpa_debug_tracing_file != NULL) {
+		va_start(ap, fmt);
+		fprintf(wpa_debug_tracing_file, WPAS_TRACE_PFX, level);
+		vfprintf(wpa_debug_tracing_file, fmt, ap);
+		fprintf(wpa_debug_tracing_file, "\n");
+		fflush(wpa_debug_tracing_file);
+		va_end(ap);
+	}
+#endif /* CONFIG_DEBUG_LINUX_TRACING */
+
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (level < wpa_debug_level && wpa_debug_flight_recorder) {
+		va_start(ap, fmt);
+		wpa_debug_ring_add_text(fmt, ap);
+		va_end(ap);
+		return;
+	}
+#endif /* CONFIG_DEBUG_RINGBUF */
+
 	if (level >= wpa_debug_level) {
 #ifdef CONFIG_ANDROID_LOG
 		va_start(ap, fmt);
@@ -224,6 +696,14 @@ void wpa_printf(int level, const char *fmt, ...)
 			va_end(ap);
 		}
 #endif /* CONFIG_DEBUG_SYSLOG */
+#ifdef CONFIG_DEBUG_RINGBUF
+		if (wpa_debug_ring) {
+			va_start(ap, fmt);
+			wpa_debug_ring_add_text(fmt, ap);
+			va_end(ap);
+			return;
+		}
+#endif /* CONFIG_DEBUG_RINGBUF */
 		wpa_debug_print_timestamp();
 #ifdef CONFIG_DEBUG_FILE
 		if (out_file) {
@@ -241,17 +721,6 @@ void wpa_printf(int level, const char *fmt, ...)
 		}
 #endif /* CONFIG_ANDROID_LOG */
 	}
-
-#ifdef CONFIG_DEBUG_LINUX_TRACING
-	if (wpa_debug_tracing_file != NULL) {
-		va_start(ap, fmt);
-		fprintf(wpa_debug_tracing_file, WPAS_TRACE_PFX, level);
-		vfprintf(wpa_debug_tracing_file, fmt, ap);
-		fprintf(wpa_debug_tracing_file, "\n");
-		fflush(wpa_debug_tracing_file);
-		va_end(ap);
-	}
-#endif /* CONFIG_DEBUG_LINUX_TRACING */
 }
 
 
@@ -278,6 +747,14 @@ static void _wpa_hexdump(int level, const char *title, const u8 *buf,
 	}
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
 
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (level < wpa_debug_level && wpa_debug_flight_recorder) {
+		wpa_debug_ring_add_hexdump(WPA_DEBUG_RING_HEXDUMP, title, buf,
+					   len, show);
+		return;
+	}
+#endif /* CONFIG_DEBUG_RINGBUF */
+
 	if (level < wpa_debug_level)
 		return;
 #ifdef CONFIG_ANDROID_LOG
@@ -351,6 +828,13 @@ static void _wpa_hexdump(int level, const char *title, const u8 *buf,
 			return;
 	}
 #endif /* CONFIG_DEBUG_SYSLOG */
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (wpa_debug_ring) {
+		wpa_debug_ring_add_hexdump(WPA_DEBUG_RING_HEXDUMP, title, buf,
+					   len, show);
+		return;
+	}
+#endif /* CONFIG_DEBUG_RINGBUF */
 	wpa_debug_print_timestamp();
 #ifdef CONFIG_DEBUG_FILE
 	if (out_file) {
@@ -420,6 +904,14 @@ static void _wpa_hexdump_ascii(int level, const char *title, const void *buf,
 	}
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
 
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (level < wpa_debug_level && wpa_debug_flight_recorder) {
+		wpa_debug_ring_add_hexdump(WPA_DEBUG_RING_HEXDUMP_ASCII, title,
+					   buf, len, show);
+		return;
+	}
+#endif /* CONFIG_DEBUG_RINGBUF */
+
 	if (level < wpa_debug_level)
 		return;
 #ifdef CONFIG_ANDROID_LOG
@@ -429,6 +921,13 @@ static void _wpa_hexdump_ascii(int level, const char *title, const void *buf,
 	if (wpa_debug_syslog)
 		_wpa_hexdump(level, title, buf, len, show, 1);
 #endif /* CONFIG_DEBUG_SYSLOG */
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (wpa_debug_ring) {
+		wpa_debug_ring_add_hexdump(WPA_DEBUG_RING_HEXDUMP_ASCII, title,
+					   buf, len, show);
+		return;
+	}
+#endif /* CONFIG_DEBUG_RINGBUF */
 	wpa_debug_print_timestamp();
 #ifdef CONFIG_DEBUG_FILE
 	if (out_file) {
@@ -15,6 +15,12 @@ extern int wpa_debug_level;
 extern int wpa_debug_show_keys;
 extern int wpa_debug_timestamp;
 extern int wpa_debug_syslog;
+#ifdef CONFIG_DEBUG_LINUX_TRACING
+extern int wpa_debug_tracing;
+#endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RINGBUF
+extern int wpa_debug_flight_recorder;
+#endif /* CONFIG_DEBUG_RINGBUF */
 
 /* Debugging function - conditional printf and hex dump. Driver wrappers can
  * use these for debugging purposes. */
@@ -45,12 +51,52 @@ static inline int wpa_debug_reopen_file(void)
 
 #else /* CONFIG_NO_STDOUT_DEBUG */
 
+/**
+ * wpa_debug_enabled - Check whether debug messages of a level may be printed
+ * @level: priority level (MSG_*) of the message
+ * Returns: 0 if messages of this level are dropped, 1 if they may be printed
+ *
+ * This is used to skip the call (and the evaluation of its arguments) for
+ * wpa_printf() and wpa_hexdump*() when the message would not be printed. With
+ * CONFIG_DEBUG_MIN_LEVEL, messages below the minimum level are removed from
+ * the build. Messages at MSG_INFO and above are normally printed, so their
+ * runtime level check is left to the called function to keep the call sites
+ * small. In ring buffer flight recorder mode, messages of all levels are
+ * recorded.
+ */
+static inline int wpa_debug_enabled(int level)
+{
+#ifdef CONFIG_DEBUG_MIN_LEVEL
+	if (level < CONFIG_DEBUG_MIN_LEVEL)
+		return 0;
+#endif /* CONFIG_DEBUG_MIN_LEVEL */
+	if (level >= MSG_INFO)
+		return 1;
+#ifdef CONFIG_DEBUG_LINUX_TRACING
+	if (wpa_debug_tracing)
+		return 1;
+#endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (wpa_debug_flight_recorder)
+		return 1;
+#endif /* CONFIG_DEBUG_RINGBUF */
+	return level >= wpa_debug_level;
+}
+
 int wpa_debug_open_file(const char *path);
 int wpa_debug_reopen_file(void);
 void wpa_debug_close_file(void);
 void wpa_debug_setup_stdout(void);
 void wpa_debug_stop_log(void);
 
+#ifdef CONFIG_DEBUG_RINGBUF
+int wpa_debug_ring_init(size_t size, int flight_recorder);
+void wpa_debug_ring_deinit(void);
+void wpa_debug_ring_flush(void);
+int wpa_debug_ring_dump(void);
+int wpa_debug_ring_status(char *buf, size_t buflen);
+#endif /* CONFIG_DEBUG_RINGBUF */
+
 /**
  * wpa_debug_printf_timestamp - Print timestamp for debug output
  *
@@ -73,6 +119,11 @@ void wpa_debug_print_timestamp(void);
  */
 void wpa_printf(int level, const char *fmt, ...)
 PRINTF_FORMAT(2, 3);
+#define wpa_printf(level, args...)					\
+	do {								\
+		if (wpa_debug_enabled(level))				\
+			wpa_printf((level), args);			\
+	} while (0)
 
 /**
  * wpa_hexdump - conditional hex dump
@@ -86,6 +137,11 @@ PRINTF_FORMAT(2, 3);
  * configuration. The contents of buf is printed out has hex dump.
  */
 void wpa_hexdump(int level, const char *title, const void *buf, size_t len);
+#define wpa_hexdump(level, args...)					\
+	do {								\
+		if (wpa_debug_enabled(level))				\
+			wpa_hexdump((level), args);			\
+	} while (0)
 
 static inline void wpa_hexdump_buf(int level, const char *title,
 				   const struct wpabuf *buf)
@@ -108,6 +164,11 @@ static inline void wpa_hexdump_buf(int level, const char *title,
  * etc.) in debug output.
  */
 void wpa_hexdump_key(int level, const char *title, const void *buf, size_t len);
+#define wpa_hexdump_key(level, args...)					\
+	do {								\
+		if (wpa_debug_enabled(level))				\
+			wpa_hexdump_key((level), args);			\
+	} while (0)
 
 static inline void wpa_hexdump_buf_key(int level, const char *title,
 				       const struct wpabuf *buf)
@@ -131,6 +192,11 @@ static inline void wpa_hexdump_buf_key(int level, const char *title,
  */
 void wpa_hexdump_ascii(int level, const char *title, const void *buf,
 		       size_t len);
+#define wpa_hexdump_ascii(level, args...)				\
+	do {								\
+		if (wpa_debug_enabled(level))				\
+			wpa_hexdump_ascii((level), args);		\
+	} while (0)
 
 /**
  * wpa_hexdump_ascii_key - conditional hex dump, hide keys
@@ -148,6 +214,11 @@ void wpa_hexdump_ascii(int level, const char *title, const void *buf,
  */
 void wpa_hexdump_ascii_key(int level, const char *title, const void *buf,
 			   size_t len);
+#define wpa_hexdump_ascii_key(level, args...)				\
+	do {								\
+		if (wpa_debug_enabled(level))				\
+			wpa_hexdump_ascii_key((level), args);		\
+	} while (0)
 
 /*
  * wpa_dbg() behaves like wpa_msg(), but it can be removed from build to reduce
@@ -27,6 +27,108 @@ static struct wpabuf_trace * wpabuf_get_trace(const struct wpabuf *buf)
 #endif /* WPA_TRACE */
 
 
+/*
+ * Arena for transient buffers. While an arena scope is open, wpabuf_alloc()
+ * allocates buffers from a single preallocated memory area. Each allocation is
+ * prefixed with struct wpabuf_arena_hdr (and struct wpabuf_trace with
+ * WPA_TRACE) to find the arena on free. The memory is reused once all buffers
+ * allocated from it have been freed.
+ */
+#define WPABUF_ARENA_SIZE 4096
+
+struct wpabuf_arena {
+	size_t used; /* octets allocated from the arena */
+	unsigned int live; /* number of buffers not yet freed */
+	bool detached; /* arena replaced due to buffers left in use */
+	/* followed by WPABUF_ARENA_SIZE octets of memory for buffers */
+} __attribute__((aligned(8)));
+
+struct wpabuf_arena_hdr {
+	struct wpabuf_arena *arena;
+} __attribute__((aligned(8)));
+
+static struct wpabuf_arena *wpabuf_arena = NULL;
+static unsigned int wpabuf_arena_depth = 0;
+
+
+static u8 * wpabuf_arena_mem(struct wpabuf_arena *arena)
+{
+	return (u8 *) (arena + 1);
+}
+
+
+static size_t wpabuf_arena_alloc_len(size_t len)
+{
+	len += sizeof(struct wpabuf_arena_hdr) + sizeof(struct wpabuf);
+#ifdef WPA_TRACE
+	len += sizeof(struct wpabuf_trace);
+#endif /* WPA_TRACE */
+	return (len + 7) & ~((size_t) 7);
+}
+
+
+static struct wpabuf_arena_hdr * wpabuf_get_arena_hdr(const struct wpabuf *buf)
+{
+#ifdef WPA_TRACE
+	return (struct wpabuf_arena_hdr *)
+		((u8 *) wpabuf_get_trace(buf) -
+		 sizeof(struct wpabuf_arena_hdr));
+#else /* WPA_TRACE */
+	return (struct wpabuf_arena_hdr *)
+		((const u8 *) buf - sizeof(struct wpabuf_arena_hdr));
+#endif /* WPA_TRACE */
+}
+
+
+static struct wpabuf * wpabuf_arena_alloc(size_t len)
+{
+	struct wpabuf_arena *arena = wpabuf_arena;
+	struct wpabuf_arena_hdr *hdr;
+	struct wpabuf *buf;
+	size_t alloc_len;
+	u8 *pos;
+
+	if (!arena || !wpabuf_arena_depth || len > WPABUF_ARENA_SIZE)
+		return NULL;
+	alloc_len = wpabuf_arena_alloc_len(len);
+	if (alloc_len > WPABUF_ARENA_SIZE - arena->used)
+		return NULL;
+
+	pos = wpabuf_arena_mem(arena) + arena->used;
+	os_memset(pos, 0, alloc_len);
+	arena->used += alloc_len;
+	arena->live++;
+
+	hdr = (struct wpabuf_arena_hdr *) pos;
+	hdr->arena = arena;
+	pos += sizeof(*hdr);
+#ifdef WPA_TRACE
+	((struct wpabuf_trace *) pos)->magic = WPABUF_MAGIC;
+	pos += sizeof(struct wpabuf_trace);
+#endif /* WPA_TRACE */
+	buf = (struct wpabuf *) pos;
+	buf->size = len;
+	buf->buf = (u8 *) (buf + 1);
+	buf->flags = WPABUF_FLAG_ARENA;
+	return buf;
+}
+
+
+static void wpabuf_arena_free(struct wpabuf *buf)
+{
+	struct wpabuf_arena_hdr *hdr = wpabuf_get_arena_hdr(buf);
+	struct wpabuf_arena *arena = hdr->arena;
+	size_t start = (u8 *) hdr - wpabuf_arena_mem(arena);
+
+	/* Return the memory immediately if this was the last allocation */
+	if (start + wpabuf_arena_alloc_len(buf->size) == arena->used)
+		arena->used = start;
+	arena->live--;
+	if (arena->detached && !arena->live)
+		os_free(arena);
+}
+
+
 static void wpabuf_overflow(const struct wpabuf *buf, size_t len)
 {
 #ifdef WPA_TRACE
@@ -44,6 +146,39 @@ static void wpabuf_overflow(const struct wpabuf *buf, size_t len)
 }
 
 
+static struct wpabuf * wpabuf_heap_alloc(size_t len);
+
+
+static int wpabuf_arena_resize(struct wpabuf **_buf, size_t add_len)
+{
+	struct wpabuf *buf = *_buf, *nbuf;
+	struct wpabuf_arena_hdr *hdr = wpabuf_get_arena_hdr(buf);
+	struct wpabuf_arena *arena = hdr->arena;
+	size_t start = (u8 *) hdr - wpabuf_arena_mem(arena);
+	size_t len = buf->used + add_len;
+
+	/* Extend in place if this is the last allocation in the current arena
+	 * and there is enough room left. Otherwise, move the data to the heap.
+	 */
+	if (arena == wpabuf_arena && len <= WPABUF_ARENA_SIZE &&
+	    start + wpabuf_arena_alloc_len(buf->size) == arena->used &&
+	    start + wpabuf_arena_alloc_len(len) <= WPABUF_ARENA_SIZE) {
+		arena->used = start + wpabuf_arena_alloc_len(len);
+		os_memset(buf->buf + buf->used, 0, add_len);
+		buf->size = len;
+		return 0;
+	}
+
+	nbuf = wpabuf_heap_alloc(len);
+	if (!nbuf)
+		return -1;
+	wpabuf_put_buf(nbuf, buf);
+	wpabuf_arena_free(buf);
+	*_buf = nbuf;
+	return 0;
+}
+
+
 int wpabuf_resize(struct wpabuf **_buf, size_t add_len)
 {
 	struct wpabuf *buf = *_buf;
@@ -68,6 +203,8 @@ int wpabuf_resize(struct wpabuf **_buf, size_t add_len)
 
 	if (buf->used + add_len > buf->size) {
 		unsigned char *nbuf;
+		if (buf->flags & WPABUF_FLAG_ARENA)
+			return wpabuf_arena_resize(_buf, add_len);
 		if (buf->flags & WPABUF_FLAG_EXT_DATA) {
 			nbuf = os_realloc(buf->buf, buf->used + add_len);
 			if (nbuf == NULL)
@@ -105,12 +242,7 @@ int wpabuf_resize(struct wpabuf **_buf, size_t add_len)
 }
 
 
-/**
- * wpabuf_alloc - Allocate a wpabuf of the given size
- * @len: Length for the allocated buffer
- * Returns: Buffer to the allocated wpabuf or %NULL on failure
- */
-struct wpabuf * wpabuf_alloc(size_t len)
+static struct wpabuf * wpabuf_heap_alloc(size_t len)
 {
 #ifdef WPA_TRACE
 	struct wpabuf_trace *trace = os_zalloc(sizeof(struct wpabuf_trace) +
@@ -132,6 +264,25 @@ struct wpabuf * wpabuf_alloc(size_t len)
 }
 
 
+/**
+ * wpabuf_alloc - Allocate a wpabuf of the given size
+ * @len: Length for the allocated buffer
+ * Returns: Buffer to the allocated wpabuf or %NULL on failure
+ *
+ * Within a wpabuf_arena_begin()/wpabuf_arena_end() scope, the buffer is
+ * allocated from the arena if there is room for it.
+ */
+struct wpabuf * wpabuf_alloc(size_t len)
+{
+	struct wpabuf *buf;
+
+	buf = wpabuf_arena_alloc(len);
+	if (buf)
+		return buf;
+	return wpabuf_heap_alloc(len);
+}
+
+
 struct wpabuf * wpabuf_alloc_ext_data(u8 *data, size_t len)
 {
 #ifdef WPA_TRACE
@@ -192,12 +343,20 @@ void wpabuf_free(struct wpabuf *buf)
 		wpa_trace_show("wpabuf_free magic mismatch");
 		abort();
 	}
+	if (buf->flags & WPABUF_FLAG_ARENA) {
+		wpabuf_arena_free(buf);
+		return;
+	}
 	if (buf->flags & WPABUF_FLAG_EXT_DATA)
 		os_free(buf->buf);
 	os_free(trace);
 #else /* WPA_TRACE */
 	if (buf == NULL)
 		return;
+	if (buf->flags & WPABUF_FLAG_ARENA) {
+		wpabuf_arena_free(buf);
+		return;
+	}
 	if (buf->flags & WPABUF_FLAG_EXT_DATA)
 		os_free(buf->buf);
 	os_free(buf);
@@ -338,3 +497,62 @@ struct wpabuf * wpabuf_parse_bin(const char *buf)
 
 	return ret;
 }
+
+
+/**
+ * wpabuf_arena_begin - Start allocating transient buffers from the arena
+ *
+ * Until the matching wpabuf_arena_end() call, wpabuf_alloc() allocates the
+ * buffers from a preallocated memory arena instead of the heap. This is meant
+ * for the temporary buffers used while processing a single frame. The buffers
+ * are freed with wpabuf_free() as usual, but that only returns the memory to
+ * the arena. Buffers that do not fit in the arena are allocated from the heap.
+ * Calls can be nested; the arena memory is reused once the outermost scope
+ * ends. A buffer left in use at that point remains valid, but a new arena is
+ * allocated for the following scopes.
+ */
+void wpabuf_arena_begin(void)
+{
+	if (wpabuf_arena_depth++ > 0 || wpabuf_arena)
+		return;
+	wpabuf_arena = os_zalloc(sizeof(struct wpabuf_arena) +
+				 WPABUF_ARENA_SIZE);
+}
+
+
+/**
+ * wpabuf_arena_end - End a scope started with wpabuf_arena_begin()
+ */
+void wpabuf_arena_end(void)
+{
+	struct wpabuf_arena *arena = wpabuf_arena;
+
+	if (!wpabuf_arena_depth || --wpabuf_arena_depth > 0 || !arena)
+		return;
+
+	if (arena->live) {
+		wpa_printf(MSG_DEBUG,
+			   "wpabuf: %u arena buffer(s) still in use - detach arena",
+			   arena->live);
+		arena->detached = true;
+		wpabuf_arena = NULL;
+		return;
+	}
+
+	arena->used = 0;
+}
+
+
+/**
+ * wpabuf_arena_deinit - Free the arena memory
+ *
+ * This is called when deinitializing the program to free the arena memory that
+ * is kept allocated between wpabuf_arena_begin() scopes.
+ */
+void wpabuf_arena_deinit(void)
+{
+	if (wpabuf_arena && !wpabuf_arena_depth && !wpabuf_arena->live) {
+		os_free(wpabuf_arena);
+		wpabuf_arena = NULL;
+	}
+}
@@ -11,6 +11,8 @@
 
 /* wpabuf::buf is a pointer to external data */
 #define WPABUF_FLAG_EXT_DATA BIT(0)
+/* wpabuf is allocated from the wpabuf arena */
+#define WPABUF_FLAG_ARENA BIT(1)
 
 /*
  * Internal data structure for wpabuf. Please do not touch this directly from
@@ -38,6 +40,9 @@ struct wpabuf * wpabuf_concat(struct wpabuf *a, struct wpabuf *b);
 struct wpabuf * wpabuf_zeropad(struct wpabuf *buf, size_t len);
 void wpabuf_printf(struct wpabuf *buf, char *fmt, ...) PRINTF_FORMAT(2, 3);
 struct wpabuf * wpabuf_parse_bin(const char *buf);
+void wpabuf_arena_begin(void);
+void wpabuf_arena_end(void);
+void wpabuf_arena_deinit(void);
 
 
 /**
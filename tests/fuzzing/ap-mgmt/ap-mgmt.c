@@ -161,6 +161,7 @@ fail:
 	hostapd_config_free(ctx.hapd.iconf);
 	ap_list_deinit(&ctx.iface);
 	eloop_destroy();
+	wpabuf_arena_deinit();
 	os_program_deinit();
 
 	return 0;
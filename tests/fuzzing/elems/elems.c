@@ -0,0 +1,114 @@
+/*
+ * IEEE 802.11 element parser fuzzer
+ * Copyright (c) 2026, Jouni Malinen <j@w1.fi>
+ *
+ * This software may be distributed under the terms of the BSD license.
+ * See README for more details.
+ */
+
+#include "utils/includes.h"
+
+#include "utils/common.h"
+#include "common/ieee802_11_defs.h"
+#include "common/ieee802_11_common.h"
+#include "../fuzzer-common.h"
+
+
+static void check_index(const u8 *data, size_t len)
+{
+	struct ieee802_11_elem_index idx;
+	u8 ids[IEEE802_11_ELEM_INDEX_MAX];
+	const u8 vendor_id = WLAN_EID_VENDOR_SPECIFIC;
+	unsigned int id, i;
+
+	for (id = 0; id < 256; id += ARRAY_SIZE(ids)) {
+		for (i = 0; i < ARRAY_SIZE(ids); i++)
+			ids[i] = id + i;
+		if (ieee802_11_elem_index_build(data, len, ids,
+						ARRAY_SIZE(ids), ids,
+						ARRAY_SIZE(ids), &idx) == 0 &&
+		    (int) idx.count != ieee802_11_ie_count(data, len))
+			abort();
+
+		for (i = 0; i < ARRAY_SIZE(ids); i++) {
+			if (ieee802_11_elem_index_get(&idx, ids[i]) !=
+			    get_ie(data, len, ids[i]) ||
+			    ieee802_11_elem_index_get_ext(&idx, ids[i]) !=
+			    get_ie_ext(data, len, ids[i]))
+				abort();
+		}
+	}
+
+	ieee802_11_elem_index_build(data, len, &vendor_id, 1, NULL, 0, &idx);
+	if (ieee802_11_elem_index_get_vendor(&idx, WMM_IE_VENDOR_TYPE) !=
+	    get_vendor_ie(data, len, WMM_IE_VENDOR_TYPE) ||
+	    ieee802_11_elem_index_get_vendor(&idx, WPA_IE_VENDOR_TYPE) !=
+	    get_vendor_ie(data, len, WPA_IE_VENDOR_TYPE))
+		abort();
+}
+
+
+/* Measure the frame rate with ELEMS_BENCH=<iterations> when running the
+ * standalone tool on a corpus file */
+static void bench(const u8 *data, size_t len, unsigned int iter)
+{
+	struct ieee802_11_elems elems;
+	struct ieee802_11_elem_index idx;
+	static const u8 ids[] = { WLAN_EID_SSID, WLAN_EID_RSN };
+	struct os_reltime start, end, diff;
+	unsigned int i;
+	unsigned long found = 0;
+	double sec;
+
+	os_get_reltime(&start);
+	for (i = 0; i < iter; i++) {
+		ieee802_11_parse_elems(data, len, &elems, 0);
+		if (elems.ssid && elems.rsn_ie)
+			found++;
+	}
+	os_get_reltime(&end);
+	os_reltime_sub(&end, &start, &diff);
+	sec = diff.sec + diff.usec / 1000000.0;
+	printf("ieee802_11_parse_elems: %u frames in %.3f sec (%.0f frames/sec)\n",
+	       iter, sec, sec > 0 ? iter / sec : 0);
+
+	os_get_reltime(&start);
+	for (i = 0; i < iter; i++) {
+		ieee802_11_elem_index_build(data, len, ids, ARRAY_SIZE(ids),
+					    NULL, 0, &idx);
+		if (ieee802_11_elem_index_get(&idx, WLAN_EID_SSID) &&
+		    ieee802_11_elem_index_get(&idx, WLAN_EID_RSN))
+			found++;
+	}
+	os_get_reltime(&end);
+	os_reltime_sub(&end, &start, &diff);
+	sec = diff.sec + diff.usec / 1000000.0;
+	printf("ieee802_11_elem_index_build: %u frames in %.3f sec (%.0f frames/sec)\n",
+	       iter, sec, sec > 0 ? iter / sec : 0);
+
+	if (found == 1)
+		printf("\n"); /* prevent the loops from being optimized out */
+}
+
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	struct ieee802_11_elems elems;
+	const char *env;
+
+	wpa_fuzzer_set_debug_level();
+
+	if (os_program_init())
+		return 0;
+
+	ieee802_11_parse_elems(data, size, &elems, 1);
+	check_index(data, size);
+
+	env = getenv("ELEMS_BENCH");
+	if (env && atoi(env) > 0)
+		bench(data, size, atoi(env));
+
+	os_program_deinit();
+
+	return 0;
+}
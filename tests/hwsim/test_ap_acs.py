@@ -426,6 +426,29 @@ def test_ap_acs_survey(dev, apdev):
 
     dev[0].connect("test-acs", psk="12345678", scan_freq=freq)
 
+def test_ap_acs_scores(dev, apdev):
+    """Automatic channel selection scores with multiple scans"""
+    force_prev_ap_on_24g(apdev[0])
+    params = hostapd.wpa2_params(ssid="test-acs", passphrase="12345678")
+    params['channel'] = '0'
+    params['acs_num_scans'] = '3'
+    hapd = hostapd.add_ap(apdev[0], params, wait_enabled=False)
+    wait_acs(hapd)
+
+    freq = int(hapd.get_status_field("freq"))
+    res = hapd.request("MIB acs")
+    logger.info("ACS scores:\n" + res)
+    scores = {}
+    for line in res.splitlines():
+        vals = dict(v.split('=') for v in line.split(' '))
+        scores[int(vals['freq'])] = float(vals['interference_factor'])
+    if freq not in scores:
+        raise Exception("No ACS score for the selected channel")
+    if len(scores) < 2:
+        raise Exception("Too few ACS scores: " + res)
+
+    dev[0].connect("test-acs", psk="12345678", scan_freq=str(freq))
+
 def test_ap_acs_errors(dev, apdev):
     """Automatic channel selection failures"""
     clear_scan_cache(apdev[0])
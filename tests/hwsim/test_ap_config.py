@@ -310,6 +310,80 @@ def test_ap_config_reload_on_sighup_config_id(dev, apdev, params):
 
     term_hostapd_pid(pid, pidfile)
 
+def test_ap_config_reload_on_sighup_hot_params(dev, apdev, params):
+    """hostapd configuration reload with only hot-apply and side file changes"""
+    pidfile = params['prefix'] + ".hostapd.pid"
+    logfile = params['prefix'] + ".hostapd.log"
+    conffile = os.path.abspath(params['prefix'] + ".hostapd.conf")
+    denyfile = os.path.abspath(params['prefix'] + ".deny")
+    prg = os.path.join(params['logdir'], 'alt-hostapd/hostapd/hostapd')
+    if not os.path.exists(prg):
+        prg = '../../hostapd/hostapd'
+    with open(denyfile, "w") as f:
+        f.write("02:00:00:00:00:00\n")
+    write_hostapd_config(conffile, apdev[0]['ifname'], "test",
+                         iface_params=["deny_mac_file=" + denyfile])
+    cmd = [prg, '-B', '-dddt', '-P', pidfile, '-f', logfile, conffile]
+    res = subprocess.check_call(cmd)
+    if res != 0:
+        raise Exception("Could not start hostapd: %s" % str(res))
+    dev[0].connect("test", key_mgmt="NONE", scan_freq="2412")
+    dev[1].connect("test", key_mgmt="NONE", scan_freq="2412")
+
+    with open(denyfile, "w") as f:
+        f.write(dev[1].own_addr() + "\n")
+    write_hostapd_config(conffile, apdev[0]['ifname'], "test",
+                         iface_params=["deny_mac_file=" + denyfile,
+                                       "max_num_sta=10"])
+
+    with open(pidfile, "r") as f:
+        pid = int(f.read())
+    os.kill(pid, signal.SIGHUP)
+    dev[1].wait_disconnected(timeout=5)
+    ev = dev[0].wait_event(["CTRL-EVENT-DISCONNECTED"], timeout=1)
+    if ev is not None:
+        raise Exception("Unexpected disconnection on hot-apply reload")
+
+    write_hostapd_config(conffile, apdev[0]['ifname'], "test",
+                         iface_params=["deny_mac_file=" + denyfile,
+                                       "max_num_sta=10", "beacon_int=200"])
+    os.kill(pid, signal.SIGHUP)
+    dev[0].wait_disconnected(timeout=5)
+
+    term_hostapd_pid(pid, pidfile)
+
+def test_ap_config_reload_on_sighup_radio_params(dev, apdev, params):
+    """hostapd configuration reload with radio changes and a secondary BSS"""
+    pidfile = params['prefix'] + ".hostapd.pid"
+    logfile = params['prefix'] + ".hostapd.log"
+    conffile = os.path.abspath(params['prefix'] + ".hostapd.conf")
+    prg = os.path.join(params['logdir'], 'alt-hostapd/hostapd/hostapd')
+    if not os.path.exists(prg):
+        prg = '../../hostapd/hostapd'
+    write_hostapd_config(conffile, apdev[0]['ifname'], "test", bss2=True)
+    cmd = [prg, '-B', '-dddt', '-P', pidfile, '-f', logfile, conffile]
+    res = subprocess.check_call(cmd)
+    if res != 0:
+        raise Exception("Could not start hostapd: %s" % str(res))
+    dev[0].connect("test-2", key_mgmt="NONE", scan_freq="2412")
+
+    with open(pidfile, "r") as f:
+        pid = int(f.read())
+    write_hostapd_config(conffile, apdev[0]['ifname'], "test", bss2=True,
+                         bss_params=["max_num_sta=10"])
+    os.kill(pid, signal.SIGHUP)
+    ev = dev[0].wait_event(["CTRL-EVENT-DISCONNECTED"], timeout=2)
+    if ev is not None:
+        raise Exception("Unexpected disconnection on hot-apply reload")
+
+    write_hostapd_config(conffile, apdev[0]['ifname'], "test", bss2=True,
+                         iface_params=["beacon_int=200"],
+                         bss_params=["max_num_sta=10"])
+    os.kill(pid, signal.SIGHUP)
+    dev[0].wait_disconnected(timeout=5)
+
+    term_hostapd_pid(pid, pidfile)
+
 def test_ap_config_reload_before_enable(dev, apdev, params):
     """hostapd configuration reload before enable"""
     hapd = hostapd.add_iface(apdev[0], "bss-1.conf")
@@ -187,3 +187,57 @@ def test_ap_csa_disable(dev, apdev):
     ap.enable()
     dev[0].wait_disconnected()
     dev[0].wait_connected()
+
+def get_radio_elems_mib(hapd):
+    res = hapd.request("MIB radio_elems")
+    if "FAIL" in res:
+        raise HwsimSkip("Radio level element cache not supported")
+    vals = {}
+    for line in res.splitlines():
+        name, val = line.split('=', 1)
+        vals[name] = int(val)
+    return vals
+
+def check_ht_oper_chan(dev, bssid, freq, chan):
+    dev.scan_for_bss(bssid, freq=freq, force_scan=True)
+    bss = dev.get_bss(bssid)
+    if bss is None or int(bss['freq']) != freq:
+        raise Exception("BSS %s not found on %d MHz" % (bssid, freq))
+    ies = parse_ie(bss['ie'])
+    if 61 not in ies or ies[61][0] != chan:
+        raise Exception("Unexpected HT Operation element for %s" % bssid)
+
+def test_ap_csa_multi_bss(dev, apdev):
+    """AP Channel Switch with multiple BSSs sharing radio level elements"""
+    csa_supported(dev[0])
+    for i in range(2):
+        dev[i].flush_scan_cache()
+    ifname1 = apdev[0]['ifname']
+    ifname2 = apdev[0]['ifname'] + '-2'
+    ifname3 = apdev[0]['ifname'] + '-3'
+    hapd = hostapd.add_iface(apdev[0], 'multi-bss.conf')
+    try:
+        hapd.enable()
+        hapd3 = hostapd.Hostapd(ifname3)
+        bssid3 = hapd3.own_addr()
+
+        mib = get_radio_elems_mib(hapd)
+        if mib["hits"] == 0:
+            raise Exception("Radio level elements not shared between BSSs")
+
+        dev[0].connect("bss-1", key_mgmt="NONE", scan_freq="2412")
+        check_ht_oper_chan(dev[1], bssid3, 2412, 1)
+
+        switch_channel(hapd, 2, 2462)
+        wait_channel_switch(dev[0], 2462)
+        hwsim_utils.test_connectivity(dev[0], hapd)
+
+        # Elements of all BSSs need to be rebuilt for the new channel
+        check_ht_oper_chan(dev[1], bssid3, 2462, 11)
+        res = get_radio_elems_mib(hapd)
+        if res["misses"] <= mib["misses"]:
+            raise Exception("Radio level elements not rebuilt on channel switch")
+    finally:
+        dev[0].request("DISCONNECT")
+        for ifname in [ifname3, ifname2, ifname1]:
+            hostapd.remove_bss(apdev[0], ifname)
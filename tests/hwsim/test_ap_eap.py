@@ -4623,6 +4623,68 @@ def test_ap_wpa2_eap_tls_ocsp_ca_signed_good(dev, apdev, params):
                    private_key_passwd="whatever", ocsp=2,
                    scan_freq="2412")
 
+def get_ocsp_stapling_status(hapd):
+    res = hapd.request("MIB tls_ocsp_stapling")
+    if "FAIL" in res:
+        raise HwsimSkip("OCSP stapling status not supported")
+    vals = {}
+    for line in res.splitlines():
+        name, val = line.split('=', 1)
+        vals[name] = int(val)
+    return vals
+
+def test_ap_wpa2_eap_tls_ocsp_cache_refresh(dev, apdev, params):
+    """EAP-TLS and OCSP stapling response refreshed from the updated file"""
+    check_ocsp_support(dev[0])
+    check_pkcs12_support(dev[0])
+    req = os.path.join(params['logdir'], "ocsp-req.der")
+    good = os.path.join(params['logdir'], "ocsp-resp-ca-signed.der")
+    revoked = os.path.join(params['logdir'], "ocsp-resp-ca-signed-revoked.der")
+    ocsp_resp_ca_signed(req, good, "")
+    ocsp_resp_ca_signed(req, revoked, "-revoked")
+    ocsp = os.path.join(params['logdir'], "ocsp-resp-cache-refresh.der")
+    with open(good, "rb") as f:
+        good_data = f.read()
+    with open(ocsp, "wb") as f:
+        f.write(good_data)
+    params = int_eap_server_params()
+    params["ocsp_stapling_response"] = ocsp
+    hapd = hostapd.add_ap(apdev[0], params)
+    dev[0].connect("test-wpa2-eap", key_mgmt="WPA-EAP", eap="TLS",
+                   identity="tls user", ca_cert="auth_serv/ca.pem",
+                   private_key="auth_serv/user.pkcs12",
+                   private_key_passwd="whatever", ocsp=2,
+                   scan_freq="2412")
+    status = get_ocsp_stapling_status(hapd)
+    if status['ocsp_stapling_loaded'] != 1 or \
+       status['ocsp_stapling_reloads'] != 1 or \
+       status['ocsp_stapling_sent'] < 1:
+        raise Exception("Unexpected OCSP stapling status: " + str(status))
+    if 'ocsp_stapling_expires_in' not in status or \
+       status['ocsp_stapling_expires_in'] <= 0:
+        raise Exception("OCSP stapling response validity not reported")
+
+    dev[0].request("REMOVE_NETWORK all")
+    dev[0].wait_disconnected()
+    with open(revoked, "rb") as f:
+        data = f.read()
+    with open(ocsp, "wb") as f:
+        f.write(data)
+    # Wait for the check interval to expire before the next handshake
+    time.sleep(6)
+    dev[0].connect("test-wpa2-eap", key_mgmt="WPA-EAP", eap="TLS",
+                   identity="tls user", ca_cert="auth_serv/ca.pem",
+                   private_key="auth_serv/user.pkcs12",
+                   private_key_passwd="whatever", ocsp=2,
+                   wait_connect=False, scan_freq="2412")
+    ev = dev[0].wait_event(["CTRL-EVENT-EAP-FAILURE"])
+    if ev is None:
+        raise Exception("Timeout on EAP failure report")
+    status = get_ocsp_stapling_status(hapd)
+    if status['ocsp_stapling_reloads'] != 2:
+        raise Exception("Updated OCSP stapling response not loaded: " +
+                        str(status))
+
 def test_ap_wpa2_eap_tls_ocsp_ca_signed_revoked(dev, apdev, params):
     """EAP-TLS and CA signed OCSP response (revoked)"""
     check_ocsp_support(dev[0])
@@ -6807,6 +6869,59 @@ def test_eap_tls_session_resumption_expiration(dev, apdev):
     if dev[0].get_status_field("tls_session_reused") != '0':
         raise Exception("Session resumption used after lifetime expiration")
 
+def test_eap_tls_session_resumption_cache(dev, apdev):
+    """EAP-TLS session resumption from external cache after AP restart"""
+    cache_dir = tempfile.mkdtemp()
+    try:
+        run_eap_tls_session_resumption_cache(dev, apdev, cache_dir)
+    finally:
+        for f in os.listdir(cache_dir):
+            os.unlink(os.path.join(cache_dir, f))
+        os.rmdir(cache_dir)
+
+def get_tls_session_cache_mib(hapd):
+    res = hapd.request("MIB tls_session_cache")
+    if "FAIL" in res:
+        raise HwsimSkip("TLS session cache statistics not supported")
+    vals = {}
+    for line in res.splitlines():
+        name, val = line.split('=', 1)
+        vals[name] = int(val)
+    return vals
+
+def run_eap_tls_session_resumption_cache(dev, apdev, cache_dir):
+    params = int_eap_server_params()
+    params['tls_session_lifetime'] = '60'
+    params['tls_session_cache'] = cache_dir
+    hapd = hostapd.add_ap(apdev[0], params)
+    check_tls_session_resumption_capa(dev[0], hapd)
+    eap_connect(dev[0], hapd, "TLS", "tls user", ca_cert="auth_serv/ca.pem",
+                client_cert="auth_serv/user.pem",
+                private_key="auth_serv/user.key",
+                phase1="tls_disable_tlsv1_3=1")
+    if dev[0].get_status_field("tls_session_reused") != '0':
+        raise Exception("Unexpected session resumption on the first connection")
+    mib = get_tls_session_cache_mib(hapd)
+    if mib['tls_session_cache_ext_stores'] < 1:
+        raise Exception("Session not stored to external cache")
+    if len(os.listdir(cache_dir)) != 1:
+        raise Exception("Unexpected cache directory contents: " +
+                        str(os.listdir(cache_dir)))
+
+    # Restarting hostapd flushes the in-memory session cache, so a resumed
+    # session has to be loaded from the external cache.
+    hapd.disable()
+    dev[0].wait_disconnected()
+    dev[0].dump_monitor()
+    hapd.enable()
+    dev[0].wait_connected()
+    if dev[0].get_status_field("tls_session_reused") != '1':
+        raise Exception("Session resumption not used after AP restart")
+    mib = get_tls_session_cache_mib(hapd)
+    if mib['tls_session_cache_ext_hits'] != 1:
+        raise Exception("Session not loaded from external cache")
+    hwsim_utils.test_connectivity(dev[0], hapd)
+
 def test_eap_tls_no_session_resumption(dev, apdev):
     """EAP-TLS session resumption disabled on server"""
     params = int_eap_server_params()
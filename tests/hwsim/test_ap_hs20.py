@@ -221,6 +221,54 @@ def test_ap_anqp_sharing(dev, apdev):
     if res1['anqp_nai_realm'] == res2['anqp_nai_realm']:
         raise Exception("ANQP results were not unshared")
 
+def test_ap_anqp_fetch_multiple(dev, apdev):
+    """ANQP fetch with multiple pending queries and ANQP sharing"""
+    check_eap_capa(dev[0], "MSCHAPV2")
+    dev[0].flush_scan_cache()
+
+    bssid = apdev[0]['bssid']
+    params = hs20_ap_params()
+    params['hessid'] = bssid
+    hostapd.add_ap(apdev[0], params)
+
+    bssid2 = apdev[1]['bssid']
+    params = hs20_ap_params()
+    params['hessid'] = bssid
+    hostapd.add_ap(apdev[1], params)
+
+    bssid3 = apdev[2]['bssid']
+    params = hs20_ap_params(ssid="test-hs20-another")
+    params['hessid'] = bssid3
+    params['channel'] = "6"
+    hostapd.add_ap(apdev[2], params)
+
+    dev[0].hs20_enable()
+    dev[0].scan_for_bss(bssid, freq="2412")
+    dev[0].scan_for_bss(bssid2, freq="2412")
+    dev[0].scan_for_bss(bssid3, freq="2437")
+    dev[0].dump_monitor()
+
+    if "OK" not in dev[0].request("FETCH_ANQP"):
+        raise Exception("FETCH_ANQP failed")
+    fetched = []
+    while True:
+        ev = dev[0].wait_event(["Starting ANQP fetch", "ANQP fetch completed"],
+                               timeout=15)
+        if ev is None:
+            raise Exception("ANQP fetch timed out")
+        if "ANQP fetch completed" in ev:
+            break
+        fetched.append(ev.split(' ')[4])
+    logger.info("ANQP fetch order: " + str(fetched))
+    if bssid3 not in fetched:
+        raise Exception("No ANQP fetch for the other ESS")
+    if len(fetched) != 2:
+        raise Exception("ANQP data not shared within the ESS")
+
+    for b in [bssid, bssid2, bssid3]:
+        if 'anqp_nai_realm' not in dev[0].get_bss(b):
+            raise Exception("anqp_nai_realm not found for " + b)
+
 def test_ap_anqp_domain_id(dev, apdev):
     """ANQP Domain ID"""
     check_eap_capa(dev[0], "MSCHAPV2")
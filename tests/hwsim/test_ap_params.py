@@ -7,6 +7,7 @@
 from remotehost import remote_compatible
 import logging
 logger = logging.getLogger()
+import binascii
 import os
 import struct
 import subprocess
@@ -865,6 +866,94 @@ def test_ap_no_probe_resp(dev, apdev):
        len(bss['ie']) != len(bss['beacon_ie']):
         raise Exception("Probe Response frames seen")
 
+def probe_resp_tmpl_send(hapd, bssid, ssid, addrs):
+    bssid = bssid.replace(':', '')
+    ies = "00" + "%02x" % len(ssid) + ssid.encode().hex()
+    ies += "010802040b160c12182432043048606c"
+    for addr in addrs:
+        frame = "40000000" + bssid + addr.replace(':', '') + bssid + "1000"
+        frame += ies
+        if "OK" not in hapd.request("MGMT_RX_PROCESS freq=2412 datarate=0 ssi_signal=-30 frame=" + frame):
+            raise Exception("MGMT_RX_PROCESS failed")
+
+def probe_resp_tmpl_recv(hapd, addrs):
+    resp = []
+    for addr in addrs:
+        ev = hapd.wait_event(["MGMT-TX-STATUS stype=5"], timeout=5)
+        if ev is None:
+            raise Exception("Probe Response frame not reported")
+        buf = ev.split(' buf=')[1]
+        da = ':'.join([buf[i:i + 2] for i in range(8, 20, 2)])
+        if da != addr:
+            raise Exception("Unexpected Probe Response DA %s (expected %s)" %
+                            (da, addr))
+        resp.append(buf[20:])
+    return resp
+
+def test_ap_probe_resp_template(dev, apdev):
+    """Probe Response frame template reuse and invalidation"""
+    ssid = "probe-resp-tmpl"
+    hapd = hostapd.add_ap(apdev[0], {'ssid': ssid, 'interworking': '1'})
+    bssid = hapd.own_addr()
+    hapd.set("ext_mgmt_frame_handling", "1")
+
+    addrs = ["02:00:00:00:01:%02x" % i for i in range(5)]
+    probe_resp_tmpl_send(hapd, bssid, ssid, addrs)
+    resp = probe_resp_tmpl_recv(hapd, addrs)
+    for r in resp[1:]:
+        if r != resp[0]:
+            raise Exception("Probe Response frames differ")
+
+    # Configuration change needs to be reflected without a Beacon update
+    hapd.set("vendor_elements", "dd0411223344")
+    probe_resp_tmpl_send(hapd, bssid, ssid, addrs[0:2])
+    resp = probe_resp_tmpl_recv(hapd, addrs[0:2])
+    if "dd0411223344" not in resp[0] or resp[0] != resp[1]:
+        raise Exception("Vendor element not included in Probe Response")
+
+    hapd.set("vendor_elements", "")
+    if "OK" not in hapd.request("UPDATE_BEACON"):
+        raise Exception("UPDATE_BEACON failed")
+    probe_resp_tmpl_send(hapd, bssid, ssid, addrs[0:1])
+    resp = probe_resp_tmpl_recv(hapd, addrs[0:1])
+    if "dd0411223344" in resp[0]:
+        raise Exception("Vendor element not removed from Probe Response")
+
+def test_ap_probe_resp_flood(dev, apdev):
+    """Probe Request flood processing time"""
+    ssid = "probe-resp-flood"
+    params = {'ssid': ssid, 'ieee80211n': '1', 'ieee80211ax': '1',
+              'interworking': '1', 'hs20': '1', 'mbo': '1',
+              'rrm_neighbor_report': '1'}
+    hapd = hostapd.add_ap(apdev[0], params)
+    bssid = hapd.own_addr()
+    hapd.set("ext_mgmt_frame_handling", "1")
+
+    num = 1000
+    addrs = ["02:00:00:%02x:%02x:%02x" % (i >> 16, (i >> 8) & 0xff, i & 0xff)
+             for i in range(num)]
+    before = get_probe_req_filter_mib(hapd)
+    resp = []
+    start = time.time()
+    # Drain the TX status events between small batches so that the control
+    # interface monitor socket does not overflow and get detached.
+    for i in range(0, num, 10):
+        probe_resp_tmpl_send(hapd, bssid, ssid, addrs[i:i + 10])
+        resp += probe_resp_tmpl_recv(hapd, addrs[i:i + 10])
+    end = time.time()
+    after = get_probe_req_filter_mib(hapd)
+    logger.info("%d Probe Request frames processed in %.3f s (%.1f us/frame)" %
+                (num, end - start, (end - start) * 1000000 / num))
+    if after["passed"] - before["passed"] < num:
+        raise Exception("Not all Probe Request frames were processed: %d/%d" %
+                        (after["passed"] - before["passed"], num))
+    if len(resp) != num:
+        raise Exception("Unexpected number of Probe Response frames: %d" %
+                        len(resp))
+    for r in resp[1:]:
+        if r != resp[0]:
+            raise Exception("Probe Response frames differ")
+
 def test_ap_long_preamble(dev, apdev):
     """AP with long preamble"""
     ssid = "long-preamble"
@@ -983,3 +1072,115 @@ def test_ap_airtime_policy_per_bss_limit_invalid(dev, apdev):
     dev[0].connect(ssid, psk=passphrase, scan_freq="2412")
     dev[1].connect(ssid, psk=passphrase, scan_freq="2412")
     time.sleep(1)
+
+def test_ap_nl80211_event_burst(dev, apdev):
+    """nl80211 event socket batch processing with a burst of frames"""
+    params = {"ssid": "open",
+              "driver_params": "event_buf_size=16384"}
+    hapd = hostapd.add_ap(apdev[0], params)
+    bssid = apdev[0]['bssid']
+    dev[0].connect("open", key_mgmt="NONE", scan_freq="2412")
+
+    drv = hapd.get_driver_status()
+    if "event_buf_size" not in drv:
+        raise Exception("Event socket statistics not reported")
+    if drv["event_buf_size"] != "16384":
+        raise Exception("Unexpected event_buf_size: " + drv["event_buf_size"])
+    reads = int(drv["event_reads"])
+
+    # Burst of unknown Public Action frames to generate a synthetic stream of
+    # NL80211_CMD_FRAME events for hostapd
+    count = 500
+    req = "MGMT_TX {} {} freq=2412 action=04ff".format(bssid, bssid)
+    start = time.time()
+    for i in range(count):
+        if "OK" not in dev[0].request(req):
+            raise Exception("Could not send management frame")
+    time.sleep(1)
+    hapd.ping()
+    end = time.time()
+
+    drv = hapd.get_driver_status()
+    logger.info("Event burst: %d frames in %.3f s; wakeups=%s reads=%s max_batch=%s overruns=%s errors=%s" %
+                (count, end - start, drv["event_wakeups"], drv["event_reads"],
+                 drv["event_max_batch"], drv["event_overruns"],
+                 drv["event_errors"]))
+    if int(drv["event_reads"]) <= reads:
+        raise Exception("Event reads not counted")
+
+    # Verify that the AP is still functional after the burst
+    dev[0].request("DISCONNECT")
+    dev[0].wait_disconnected()
+    dev[0].request("RECONNECT")
+    dev[0].wait_connected()
+    hwsim_utils.test_connectivity(dev[0], hapd)
+
+def get_probe_req_filter_mib(hapd):
+    res = hapd.request("MIB probe_req_filter")
+    if "FAIL" in res:
+        raise HwsimSkip("Probe Request filter not supported")
+    vals = {}
+    for line in res.splitlines():
+        name, val = line.split('=', 1)
+        vals[name] = int(val)
+    return vals
+
+def test_ap_probe_req_filter(dev, apdev):
+    """Radio level Probe Request prefilter"""
+    ssid = "probe-filter"
+    hapd = hostapd.add_ap(apdev[0], {"ssid": ssid})
+    bssid = hapd.own_addr()
+    dev[0].scan_for_bss(bssid, freq=2412, force_scan=True)
+    dev[0].connect(ssid, key_mgmt="NONE", scan_freq="2412")
+
+    start = get_probe_req_filter_mib(hapd)
+    if start["passed"] == 0:
+        raise Exception("Probe Request frames not passed through")
+
+    hdr = "40000000" + 6*"ff" + "020304050607" + 6*"ff" + "1000"
+    rates = "010802040b160c121824"
+    frames = [("foreign_ssid", "000a" + b"other-ssid".hex() + rates),
+              ("foreign_ssid", "0003" + b"abc".hex() + rates + "030101"),
+              ("no_ssid", rates),
+              ("no_ssid", "0000"),
+              ("ds_mismatch", "0000" + rates + "030106"),
+              ("malformed", "0000" + rates + "0305"),
+              ("passed", "0000" + rates),
+              ("passed", "000c" + ssid.encode().hex() + rates + "030101"),
+              # Short SSID List element with the Short SSID of the BSS
+              ("passed", "000a" + b"other-ssid".hex() + rates + "ff053a" +
+               struct.pack('<L', binascii.crc32(ssid.encode())).hex())]
+    expected = dict(start)
+    hapd.set("ext_mgmt_frame_handling", "1")
+    for reason, elems in frames:
+        if "OK" not in hapd.request("MGMT_RX_PROCESS freq=2412 datarate=0 ssi_signal=-30 frame=" + hdr + elems):
+            raise Exception("MGMT_RX_PROCESS failed")
+        expected[reason] += 1
+    hapd.set("ext_mgmt_frame_handling", "0")
+
+    res = get_probe_req_filter_mib(hapd)
+    for reason in ["foreign_ssid", "no_ssid", "ds_mismatch", "malformed",
+                   "broadcast"]:
+        if res[reason] != expected[reason]:
+            raise Exception("Unexpected %s counter: %d (expected %d)" %
+                            (reason, res[reason], expected[reason]))
+    # Scans by the connected station may add more passed frames
+    if res["passed"] < expected["passed"]:
+        raise Exception("Unexpected passed counter: %d (expected >= %d)" %
+                        (res["passed"], expected["passed"]))
+
+    # Wildcard SSID is dropped when the only BSS ignores it
+    hapd.set("ignore_broadcast_ssid", "1")
+    hapd.set("ext_mgmt_frame_handling", "1")
+    if "OK" not in hapd.request("MGMT_RX_PROCESS freq=2412 datarate=0 ssi_signal=-30 frame=" + hdr + "0000" + rates):
+        raise Exception("MGMT_RX_PROCESS failed")
+    hapd.set("ext_mgmt_frame_handling", "0")
+    res = get_probe_req_filter_mib(hapd)
+    if res["broadcast"] != expected["broadcast"] + 1:
+        raise Exception("Wildcard SSID Probe Request not dropped")
+    hapd.set("ignore_broadcast_ssid", "0")
+
+    dev[0].request("DISCONNECT")
+    dev[0].wait_disconnected()
+    dev[0].request("RECONNECT")
+    dev[0].wait_connected()
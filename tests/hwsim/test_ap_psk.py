@@ -76,6 +76,85 @@ def test_ap_wpa2_psk_file(dev, apdev):
         raise Exception("Timed out while waiting for failure report")
     dev[1].request("REMOVE_NETWORK all")
 
+def test_ap_wpa2_psk_file_cache(dev, apdev):
+    """WPA2-PSK AP with PSK from a file and persistent PSK cache"""
+    ssid = "test-wpa2-psk"
+    passphrase = 'qwertyuiop'
+    cache = "/tmp/hostapd-test-wpa_psk_cache"
+    target = cache + ".target"
+    psk_file = "/tmp/hostapd-test-wpa_psk_cache.wpa_psk"
+    for fname in [cache, target]:
+        if os.path.lexists(fname):
+            os.remove(fname)
+    try:
+        params = hostapd.wpa2_params(ssid=ssid, passphrase=passphrase)
+        params['wpa_psk_file'] = 'hostapd.wpa_psk'
+        params['wpa_psk_cache'] = cache
+        hapd = hostapd.add_ap(apdev[0], params)
+        if not os.path.exists(cache):
+            raise Exception("PSK cache file not created")
+        if os.stat(cache).st_mode & 0o077:
+            raise Exception("PSK cache file accessible by others")
+        with open(cache, "r") as f:
+            entries = f.read().splitlines()
+        # Passphrase + four passphrases from wpa_psk_file
+        if len(entries) != 5:
+            raise Exception("Unexpected number of PSK cache entries: %d" % len(entries))
+        psk = '602e323e077bc63bd80307ef4745b754b0ae0a925c2638ecd13a794b9527b9e6'
+        if not any(e.endswith(" " + psk) for e in entries):
+            raise Exception("Passphrase PSK not found in the cache")
+        hapd.disable()
+
+        # Restart using the cached PSKs
+        hapd.enable()
+        with open(cache, "r") as f:
+            if len(f.read().splitlines()) != 5:
+                raise Exception("PSK cache entries added on restart")
+        dev[0].connect(ssid, psk="very secret", scan_freq="2412")
+        dev[1].connect(ssid, psk=passphrase, scan_freq="2412")
+        dev[2].connect(ssid, psk="another passphrase for all STAs",
+                       scan_freq="2412")
+        hapd.disable()
+        dev[0].request("REMOVE_NETWORK all")
+        dev[1].request("REMOVE_NETWORK all")
+        dev[2].request("REMOVE_NETWORK all")
+
+        # Entries that are not used anymore are removed from the cache
+        with open(psk_file, "w") as f:
+            f.write("02:00:00:00:00:00 very secret\n")
+        hapd.set("wpa_psk_file", psk_file)
+        hapd.enable()
+        with open(cache, "r") as f:
+            if len(f.read().splitlines()) != 2:
+                raise Exception("Unused PSK cache entries not removed")
+        if os.stat(cache).st_mode & 0o077:
+            raise Exception("Rewritten PSK cache file accessible by others")
+        dev[0].connect(ssid, psk="very secret", scan_freq="2412")
+        hapd.disable()
+        dev[0].request("REMOVE_NETWORK all")
+
+        # Cache behind a symbolic link is ignored and not written through
+        os.rename(cache, target)
+        os.symlink(target, cache)
+        hapd.enable()
+        if not os.path.islink(cache):
+            raise Exception("PSK cache symbolic link replaced")
+        with open(target, "r") as f:
+            if len(f.read().splitlines()) != 2:
+                raise Exception("PSK cache written through a symbolic link")
+        hapd.disable()
+        os.remove(cache)
+        os.rename(target, cache)
+
+        # Cache with unsafe permissions is ignored
+        os.chmod(cache, 0o644)
+        hapd.enable()
+        dev[0].connect(ssid, psk="very secret", scan_freq="2412")
+    finally:
+        for fname in [cache, target, psk_file]:
+            if os.path.lexists(fname):
+                os.remove(fname)
+
 def check_no_keyid(hapd, dev):
     addr = dev.own_addr()
     ev = hapd.wait_event(["AP-STA-CONNECTED"], timeout=1)
@@ -176,6 +255,37 @@ def test_ap_wpa2_psk_file_keyid(dev, apdev, params):
     if "FAIL" not in hapd.request("RELOAD_WPA_PSK"):
         raise Exception("RELOAD_WPA_PSK succeeded with invalid file")
 
+def test_ap_wpa2_psk_file_reload_error(dev, apdev, params):
+    """WPA2-PSK AP and PSK file reload with an invalid line after a passphrase"""
+    psk_file = os.path.join(params['logdir'],
+                            'ap_wpa2_psk_file_reload_error.wpa_psk')
+    with open(psk_file, 'w') as f:
+        f.write('00:00:00:00:00:00 secret passphrase\n')
+    ssid = "test-wpa2-psk"
+    params = hostapd.wpa2_params(ssid=ssid, passphrase='qwertyuiop')
+    params['wpa_psk_file'] = psk_file
+    hapd = hostapd.add_ap(apdev[0], params)
+
+    with open(psk_file, 'w') as f:
+        f.write('00:00:00:00:00:00 changed passphrase\n')
+        f.write('broken\n')
+    if "FAIL" not in hapd.request("RELOAD_WPA_PSK"):
+        raise Exception("RELOAD_WPA_PSK succeeded with invalid file")
+
+    # The passphrase entry before the invalid line must not be left in use
+    # without a derived PSK
+    dev[0].connect(ssid, raw_psk=32 * "00", scan_freq="2412",
+                   wait_connect=False)
+    ev = dev[0].wait_event(["WPA: 4-Way Handshake failed",
+                            "CTRL-EVENT-CONNECTED"], timeout=10)
+    if ev is None:
+        raise Exception("Timed out while waiting for failure report")
+    if "CTRL-EVENT-CONNECTED" in ev:
+        raise Exception("Connected with an all-zero PSK")
+    dev[0].request("REMOVE_NETWORK all")
+
+    dev[1].connect(ssid, psk="qwertyuiop", scan_freq="2412")
+
 @remote_compatible
 def test_ap_wpa2_psk_mem(dev, apdev):
     """WPA2-PSK AP with passphrase only in memory"""
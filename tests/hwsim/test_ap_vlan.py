@@ -180,6 +180,53 @@ def test_ap_vlan_wpa2_radius_2(dev, apdev):
     hapd.wait_sta()
     hwsim_utils.test_connectivity_iface(dev[0], hapd, "brvlan1")
 
+def test_ap_vlan_wpa2_radius_prewarm(dev, apdev):
+    """AP VLAN with WPA2-Enterprise, prewarmed VLANs, and removal grace period"""
+    params = hostapd.wpa2_eap_params(ssid="test-vlan")
+    params['dynamic_vlan'] = "1"
+    params['vlan_prewarm'] = "1"
+    params['vlan_remove_grace'] = "2"
+    hapd = hostapd.add_ap(apdev[0], params)
+
+    if not os.path.exists("/sys/class/net/brvlan1"):
+        raise Exception("Prewarmed VLAN bridge not created")
+    if os.path.exists("/sys/class/net/brvlan2"):
+        raise Exception("Unexpected VLAN bridge created")
+
+    dev[0].connect("test-vlan", key_mgmt="WPA-EAP", eap="PAX",
+                   identity="vlan1",
+                   password_hex="0123456789abcdef0123456789abcdef",
+                   scan_freq="2412")
+    dev[1].connect("test-vlan", key_mgmt="WPA-EAP", eap="PAX",
+                   identity="vlan2",
+                   password_hex="0123456789abcdef0123456789abcdef",
+                   scan_freq="2412")
+    hapd.wait_sta()
+    hapd.wait_sta()
+    hwsim_utils.test_connectivity_iface(dev[0], hapd, "brvlan1")
+    hwsim_utils.test_connectivity_iface(dev[1], hapd, "brvlan2")
+
+    dev[0].request("DISCONNECT")
+    dev[1].request("DISCONNECT")
+    dev[0].wait_disconnected()
+    dev[1].wait_disconnected()
+    time.sleep(0.5)
+    if not os.path.exists("/sys/class/net/brvlan2"):
+        raise Exception("VLAN bridge removed before grace period")
+
+    dev[1].request("RECONNECT")
+    dev[1].wait_connected()
+    hapd.wait_sta()
+    hwsim_utils.test_connectivity_iface(dev[1], hapd, "brvlan2")
+    dev[1].request("DISCONNECT")
+    dev[1].wait_disconnected()
+
+    time.sleep(3)
+    if os.path.exists("/sys/class/net/brvlan2"):
+        raise Exception("Unused VLAN bridge not removed after grace period")
+    if not os.path.exists("/sys/class/net/brvlan1"):
+        raise Exception("Prewarmed VLAN bridge removed")
+
 def test_ap_vlan_wpa2_radius_local(dev, apdev):
     """AP VLAN with WPA2-Enterprise and local file setting VLAN IDs"""
     filename = hostapd.acl_file(dev, apdev, 'hostapd.accept')
@@ -324,6 +324,47 @@ def test_dpp_qr_code_auth_broadcast(dev, apdev):
     dev[1].dpp_auth_init(uri=uri0)
     wait_auth_success(dev[0], dev[1], stop_responder=True, timeout=20)
 
+def test_dpp_bootstrap_import(dev, apdev, params):
+    """DPP bootstrapping URI list import and authentication"""
+    check_dpp_capab(dev[0])
+    check_dpp_capab(dev[1])
+    uris = []
+    for i in range(20):
+        id0 = dev[0].dpp_bootstrap_gen(chan="81/1")
+        uris.append(dev[0].request("DPP_BOOTSTRAP_GET_URI %d" % id0))
+    res = dev[0].request("DPP_BOOTSTRAP_INFO %d" % id0)
+    pkhash = None
+    for line in res.splitlines():
+        name, value = line.split('=')
+        if name == "pkhash":
+            pkhash = value
+            break
+
+    fname = params['prefix'] + ".uris"
+    with open(fname, "w") as f:
+        f.write("# pre-provisioned devices\n\n")
+        f.write("DPP:invalid;;\n")
+        for uri in uris:
+            f.write(uri + "\n")
+    res = dev[1].request("DPP_BOOTSTRAP_IMPORT " + fname)
+    if "FAIL" in res or int(res) != len(uris):
+        raise Exception("Unexpected DPP_BOOTSTRAP_IMPORT result: " + res)
+    if "FAIL" not in dev[1].request("DPP_BOOTSTRAP_IMPORT /does/not/exist"):
+        raise Exception("Import of a missing file accepted")
+
+    peer = None
+    for i in range(1, 100):
+        res = dev[1].request("DPP_BOOTSTRAP_INFO %d" % i)
+        if "pkhash=" + pkhash in res:
+            peer = i
+            break
+    if peer is None:
+        raise Exception("Imported bootstrapping information not found")
+
+    dev[0].dpp_listen(2412)
+    dev[1].dpp_auth_init(peer=peer)
+    wait_auth_success(dev[0], dev[1], stop_responder=True)
+
 def test_dpp_qr_code_auth_unicast(dev, apdev):
     """DPP QR Code and authentication exchange (unicast)"""
     run_dpp_qr_code_auth_unicast(dev, apdev, None)
@@ -6277,6 +6318,74 @@ def test_dpp_tcp_init_failure(dev, apdev, params):
             if "FAIL" not in dev[0].request(cmd):
                 raise Exception("DPP_AUTH_INIT accepted during OOM")
 
+def test_dpp_tcp_controller_load(dev, apdev, params):
+    """DPP Controller with concurrent TCP connections and connection limit"""
+    check_dpp_capab(dev[0], min_ver=2)
+    check_dpp_capab(dev[1], min_ver=2)
+    check_dpp_capab(dev[2], min_ver=2)
+    try:
+        run_dpp_tcp_controller_load(dev, apdev)
+    finally:
+        dev[1].request("DPP_CONTROLLER_STOP")
+
+def run_dpp_tcp_controller_load(dev, apdev):
+    conf_id = dev[1].dpp_configurator_add()
+    dev[1].set("dpp_configurator_params",
+               " conf=sta-dpp configurator=%d" % conf_id)
+    id_c = dev[1].dpp_bootstrap_gen()
+    uri_c = dev[1].request("DPP_BOOTSTRAP_GET_URI %d" % id_c)
+    if "OK" not in dev[1].request("DPP_CONTROLLER_START max_conn=4"):
+        raise Exception("Failed to start Controller")
+
+    addr = ("127.0.0.1", 8908)
+    idle = []
+    for i in range(4):
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM,
+                             socket.IPPROTO_TCP)
+        sock.connect(addr)
+        idle.append(sock)
+    time.sleep(0.2)
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM,
+                         socket.IPPROTO_TCP)
+    sock.settimeout(2)
+    sock.connect(addr)
+    try:
+        if sock.recv(10) != b'':
+            raise Exception("Unexpected data on rejected connection")
+    except ConnectionResetError:
+        pass
+    except socket.timeout:
+        raise Exception("Connection beyond max_conn not rejected")
+    sock.close()
+
+    for sock in idle[0:2]:
+        sock.close()
+    time.sleep(0.2)
+
+    rounds = 3
+    start = time.time()
+    for i in range(rounds):
+        for d in [dev[0], dev[2]]:
+            d.dpp_auth_init(uri=uri_c, role="enrollee", tcp_addr="127.0.0.1")
+        for d in [dev[0], dev[2]]:
+            ev = d.wait_event(["DPP-CONF-RECEIVED", "DPP-CONF-FAILED"],
+                              timeout=10)
+            if ev is None or "DPP-CONF-RECEIVED" not in ev:
+                raise Exception("Enrollee did not receive configuration")
+        for j in range(2):
+            ev = dev[1].wait_event(["DPP-CONF-SENT"], timeout=5)
+            if ev is None:
+                raise Exception("Configurator did not report completion")
+        dev[0].dump_monitor()
+        dev[2].dump_monitor()
+    diff = time.time() - start
+    logger.info("%d concurrent onboardings in %.3f seconds (%.1f/s)" %
+                (2 * rounds, diff, 2 * rounds / diff))
+
+    for sock in idle[2:]:
+        sock.close()
+
 def test_dpp_controller_rx_failure(dev, apdev, params):
     """DPP Controller RX failure"""
     check_dpp_capab(dev[0])
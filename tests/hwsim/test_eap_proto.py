@@ -9332,6 +9332,104 @@ def test_eap_proto_tls(dev, apdev):
     finally:
         stop_radius_server(srv)
 
+def test_eap_proto_tls_reassembly(dev, apdev):
+    """EAP-TLS peer reassembly of fragmented and unfragmented messages"""
+    check_eap_capa(dev[0], "TLS")
+    # TLS Alert record: fatal, handshake_failure
+    alert = binascii.unhexlify("15030300020228")
+    reqs = []
+
+    def tls_handler(ctx, req):
+        logger.info("tls_handler - RX " + binascii.hexlify(req).decode())
+        if 'id' not in ctx:
+            ctx['id'] = 1
+        ctx['id'] = (ctx['id'] + 1) % 256
+        if not reqs:
+            logger.info("Test: EAP-Failure")
+            return struct.pack(">BBH", EAP_CODE_FAILURE, ctx['id'], 4)
+        flags, tls_len, payload = reqs.pop(0)
+        logger.info("Test: TLS message flags=0x%02x len=%d" % (flags,
+                                                              len(payload)))
+        if flags & 0x80:
+            return struct.pack(">BBHBBL", EAP_CODE_REQUEST, ctx['id'],
+                               4 + 1 + 1 + 4 + len(payload),
+                               EAP_TYPE_TLS, flags, tls_len) + payload
+        return struct.pack(">BBHBB", EAP_CODE_REQUEST, ctx['id'],
+                           4 + 1 + 1 + len(payload),
+                           EAP_TYPE_TLS, flags) + payload
+
+    def run(msgs, alloc_fail_count=0, expect_alert=True):
+        reqs[:] = [(0x20, 0, b'')] + msgs
+        pattern = "wpabuf_alloc;eap_peer_tls_reassemble_fragment"
+        if alloc_fail_count:
+            dev[0].request("TEST_ALLOC_FAIL %d:%s" % (alloc_fail_count,
+                                                      pattern))
+        dev[0].connect("eap-test", key_mgmt="WPA-EAP", scan_freq="2412",
+                       eap="TLS", identity="tls user",
+                       ca_cert="auth_serv/ca.pem",
+                       client_cert="auth_serv/user.pem",
+                       private_key="auth_serv/user.key",
+                       wait_connect=False)
+        if expect_alert:
+            ev = dev[0].wait_event(["CTRL-EVENT-EAP-STATUS status='remote TLS alert'"],
+                                   timeout=5)
+            if ev is None:
+                raise Exception("TLS Alert not delivered to the TLS library")
+        ev = dev[0].wait_event(["CTRL-EVENT-EAP-FAILURE"], timeout=5)
+        if ev is None:
+            raise Exception("EAP-Failure not reported")
+        res = None
+        if alloc_fail_count:
+            res = dev[0].request("GET_ALLOC_FAIL")
+            dev[0].request("TEST_ALLOC_FAIL 0:")
+        dev[0].request("REMOVE_NETWORK all")
+        dev[0].wait_disconnected(timeout=1)
+        dev[0].dump_monitor()
+        if reqs:
+            raise Exception("Not all TLS messages were processed")
+        return res
+
+    srv = start_radius_server(tls_handler)
+
+    try:
+        hapd = start_ap(apdev[0])
+        dev[0].scan_for_bss(hapd.own_addr(), freq=2412)
+
+        # Unfragmented message without and with the TLS Message Length field
+        # is passed to the TLS library without reassembly
+        res = run([(0x00, 0, alert)], alloc_fail_count=1)
+        if not res.startswith("1:"):
+            raise Exception("Reassembly buffer allocated for an unfragmented message: " + res)
+        res = run([(0x80, len(alert), alert)], alloc_fail_count=1)
+        if not res.startswith("1:"):
+            raise Exception("Reassembly buffer allocated for an unfragmented message: " + res)
+
+        # Fragmented message is reassembled into a single buffer allocated
+        # for the full TLS Message Length
+        frags = [(0xc0, len(alert), alert[0:3]),
+                 (0x40, 0, alert[3:5]),
+                 (0x00, 0, alert[5:])]
+        res = run(frags, alloc_fail_count=2)
+        if not res.startswith("1:"):
+            raise Exception("Unexpected number of reassembly buffer allocations: " + res)
+
+        # Reassembly buffer allocation failure
+        res = run(frags[0:1], alloc_fail_count=1, expect_alert=False)
+        if not res.startswith("0:"):
+            raise Exception("Reassembly buffer not allocated on the first fragment: " + res)
+
+        # 64 kB limit for the TLS Message Length
+        res = run([(0xc0, 65536, alert[0:3])], alloc_fail_count=1,
+                  expect_alert=False)
+        if not res.startswith("0:"):
+            raise Exception("64 kB TLS message rejected: " + res)
+        res = run([(0xc0, 65537, alert[0:3])], alloc_fail_count=1,
+                  expect_alert=False)
+        if not res.startswith("1:"):
+            raise Exception("Reassembly buffer allocated for over 64 kB TLS message: " + res)
+    finally:
+        stop_radius_server(srv)
+
 def test_eap_proto_tnc(dev, apdev):
     """EAP-TNC protocol tests"""
     check_eap_capa(dev[0], "TNC")
@@ -2081,3 +2081,59 @@ def test_gas_vendor_spec_errors(dev, apdev):
         ev = wpas.wait_event(["MGMT-TX-STATUS"], timeout=5)
         if ev is None:
             raise Exception("No ACK frame seen")
+
+def anqp_query_send(hapd, bssid, addrs, anqp_query):
+    bssid = bssid.replace(':', '')
+    gas = struct.pack('<H', len(anqp_query)) + anqp_query
+    for addr in addrs:
+        msg = struct.pack('<BBB', ACTION_CATEG_PUBLIC, GAS_INITIAL_REQUEST,
+                          1) + anqp_adv_proto() + gas
+        frame = "d0000000" + bssid + addr.replace(':', '') + bssid + "1000"
+        frame += binascii.hexlify(msg).decode()
+        if "OK" not in hapd.request("MGMT_RX_PROCESS freq=2412 datarate=0 ssi_signal=-30 frame=" + frame):
+            raise Exception("MGMT_RX_PROCESS failed")
+
+def anqp_query_recv(hapd, num):
+    resp = []
+    for i in range(num):
+        ev = hapd.wait_event(["MGMT-TX-STATUS stype=13"], timeout=5)
+        if ev is None:
+            raise Exception("GAS Initial Response frame not reported")
+        # Skip the IEEE 802.11 header (24 octets)
+        resp.append(binascii.unhexlify(ev.split(' buf=')[1])[24:])
+    return resp
+
+def test_gas_anqp_cache(dev, apdev):
+    """GAS/ANQP response cache and query throughput"""
+    hapd = start_ap(apdev[0])
+    bssid = apdev[0]['bssid']
+    hapd.set("ext_mgmt_frame_handling", "1")
+
+    ids = [257, 258, 260, 261, 262, 263, 264, 268]
+    anqp_query = struct.pack('<HH', 256, 2 * len(ids)) + \
+        struct.pack('<%dH' % len(ids), *ids)
+
+    anqp_query_send(hapd, bssid, ["02:00:00:00:00:01"], anqp_query)
+    first = anqp_query_recv(hapd, 1)[0]
+    if b"Example venue" not in first or b"another.example.com" not in first:
+        raise Exception("Expected ANQP-elements not in the response")
+
+    num = 500
+    addrs = ["02:00:00:%02x:%02x:%02x" % (i >> 16, (i >> 8) & 0xff, i & 0xff)
+             for i in range(num)]
+    start = time.time()
+    anqp_query_send(hapd, bssid, addrs, anqp_query)
+    end = time.time()
+    resp = anqp_query_recv(hapd, num)
+    logger.info("%d ANQP queries processed in %.3f s (%.1f queries/s)" %
+                (num, end - start, num / (end - start)))
+    for r in resp:
+        if r != first:
+            raise Exception("ANQP responses differ")
+
+    # Configuration change needs to invalidate the cached ANQP-elements
+    hapd.set("venue_name", "eng:Changed venue")
+    anqp_query_send(hapd, bssid, ["02:00:00:00:00:01"], anqp_query)
+    resp = anqp_query_recv(hapd, 1)[0]
+    if b"Changed venue" not in resp:
+        raise Exception("Updated Venue Name not in the response")
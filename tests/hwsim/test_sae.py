@@ -2069,6 +2069,116 @@ def run_sae_anti_clogging_during_attack(dev, apdev):
     if count < 1:
         raise Exception("Too few token responses in third round: %d" % count)
 
+def sae_connect_time(dev, ssid, freq):
+    start = time.time()
+    dev.connect(ssid, psk="12345678", key_mgmt="SAE", scan_freq=freq)
+    t = time.time() - start
+    dev.request("REMOVE_NETWORK all")
+    dev.wait_disconnected()
+    dev.dump_monitor()
+    return t
+
+def test_sae_commit_queue_multi_radio(dev, apdev):
+    """SAE commit flood on one radio and queue fairness between two radios"""
+    check_sae_capab(dev[0])
+    params = hostapd.wpa2_params(ssid="test-sae-flood", passphrase="12345678")
+    params['wpa_key_mgmt'] = 'SAE'
+    params['sae_groups'] = '21'
+    params['sae_anti_clogging_threshold'] = '100'
+    hapd = hostapd.add_ap(apdev[0], params)
+
+    params = hostapd.wpa2_params(ssid="test-sae", passphrase="12345678")
+    params['wpa_key_mgmt'] = 'SAE'
+    params['sae_groups'] = '19 21'
+    params['sae_anti_clogging_threshold'] = '100'
+    params['channel'] = '6'
+    hapd2 = hostapd.add_ap(apdev[1], params)
+
+    dev[0].scan_for_bss(hapd2.own_addr(), freq=2437)
+    base = sae_connect_time(dev[0], "test-sae", "2437")
+
+    # Report the SAE commit messages sent by the flooded AP as TX status
+    # events
+    hapd.set("ext_mgmt_frame_handling", "1")
+    bssid = binascii.unhexlify(hapd.own_addr().replace(':', ''))
+    for i in range(15):
+        addr = binascii.unhexlify("f203%08x" % i)
+        frame = build_sae_commit(bssid, addr)
+        hapd.request("MGMT_RX_PROCESS freq=2412 datarate=0 ssi_signal=-30 frame=" + binascii.hexlify(frame).decode())
+    flood = sae_connect_time(dev[0], "test-sae", "2437")
+
+    logger.info("Connection time: %.3f s without and %.3f s with SAE commit flood on the other radio" % (base, flood))
+
+    # All queued commit messages need to get processed and answered
+    seen = set()
+    while len(seen) < 15:
+        ev = hapd.wait_event(["MGMT-TX-STATUS stype=11"], timeout=5)
+        if ev is None:
+            raise Exception("Queued SAE commit messages not processed (%d/15)" %
+                            len(seen))
+        buf = ev.split(' buf=')[1]
+        if buf[8:12] == "f203":
+            seen.add(buf[8:20])
+
+    if flood > base + 2:
+        raise Exception("SAE commit flood delayed connection on the other radio: %.3f s (%.3f s without flood)" % (flood, base))
+
+    # Flood both radios at the same time. The second radio needs to get its
+    # queued commit messages served while the first radio still has a
+    # non-empty queue instead of waiting for that queue to be drained.
+    hapd2.set("ext_mgmt_frame_handling", "1")
+    bssid2 = binascii.unhexlify(hapd2.own_addr().replace(':', ''))
+    for i in range(15):
+        addr = binascii.unhexlify("f204%08x" % i)
+        frame = build_sae_commit(bssid, addr)
+        hapd.request("MGMT_RX_PROCESS freq=2412 datarate=0 ssi_signal=-30 frame=" + binascii.hexlify(frame).decode())
+    for i in range(15):
+        addr = binascii.unhexlify("f205%08x" % i)
+        frame = build_sae_commit(bssid2, addr)
+        hapd2.request("MGMT_RX_PROCESS freq=2437 datarate=0 ssi_signal=-30 frame=" + binascii.hexlify(frame).decode())
+
+    ev = hapd2.wait_event(["MGMT-TX-STATUS stype=11"], timeout=5)
+    if ev is None:
+        raise Exception("Queued SAE commit messages on the second radio not processed")
+
+    seen2 = set()
+    buf = ev.split(' buf=')[1]
+    if buf[8:12] == "f205":
+        seen2.add(buf[8:20])
+
+    # No more commit messages are added to the first radio's queue, so if at
+    # least two of them are still unanswered (at most one may be waiting for
+    # its TX status), that queue was non-empty when the second radio was
+    # served.
+    seen = set()
+    while True:
+        ev = hapd.wait_event(["MGMT-TX-STATUS stype=11"], timeout=0.01)
+        if ev is None:
+            break
+        buf = ev.split(' buf=')[1]
+        if buf[8:12] == "f204":
+            seen.add(buf[8:20])
+    logger.info("First radio answered %d/15 commits when the second radio was served" % len(seen))
+    if len(seen) > 13:
+        raise Exception("Second radio not served before the first radio queue was drained")
+
+    while len(seen) < 15:
+        ev = hapd.wait_event(["MGMT-TX-STATUS stype=11"], timeout=5)
+        if ev is None:
+            raise Exception("Queued SAE commit messages not processed on the first radio (%d/15)" %
+                            len(seen))
+        buf = ev.split(' buf=')[1]
+        if buf[8:12] == "f204":
+            seen.add(buf[8:20])
+    while len(seen2) < 15:
+        ev = hapd2.wait_event(["MGMT-TX-STATUS stype=11"], timeout=5)
+        if ev is None:
+            raise Exception("Queued SAE commit messages not processed on the second radio (%d/15)" %
+                            len(seen2))
+        buf = ev.split(' buf=')[1]
+        if buf[8:12] == "f205":
+            seen2.add(buf[8:20])
+
 def test_sae_sync(dev, apdev):
     """SAE dot11RSNASAESync"""
     check_sae_capab(dev[0])
@@ -2328,6 +2438,44 @@ def test_sae_h2e_password_id(dev, apdev):
         dev[0].set("sae_groups", "")
         dev[0].set("sae_pwe", "0")
 
+def test_sae_h2e_pt_table_failure(dev, apdev):
+    """SAE H2E and PT precomputation failures"""
+    check_sae_capab(dev[0])
+    params = hostapd.wpa2_params(ssid="test-sae", passphrase="12345678")
+    params['wpa_key_mgmt'] = 'SAE'
+    params['sae_pwe'] = '1'
+    hapd = hostapd.add_ap(apdev[0], params)
+
+    try:
+        dev[0].request("SET sae_groups ")
+        dev[0].set("sae_pwe", "1")
+
+        # The table is built when PT is used for the second time and the
+        # generic point multiplication is used if that fails
+        with fail_test(hapd, 1, "crypto_ec_point_table_init;sae_pt_mul_ecc"):
+            for i in range(2):
+                dev[0].connect("test-sae", psk="12345678", key_mgmt="SAE",
+                               scan_freq="2412")
+                dev[0].request("REMOVE_NETWORK all")
+                dev[0].wait_disconnected()
+                dev[0].dump_monitor()
+
+        # Reconnect with the same network to reuse the PT of the station
+        dev[0].connect("test-sae", psk="12345678", key_mgmt="SAE",
+                       scan_freq="2412")
+        dev[0].request("DISCONNECT")
+        dev[0].wait_disconnected()
+        dev[0].dump_monitor()
+        with fail_test(dev[0], 1,
+                       "crypto_ec_point_mul_table;sae_derive_commit_element_ecc"):
+            dev[0].request("RECONNECT")
+            wait_fail_trigger(dev[0], "GET_FAIL")
+        dev[0].request("REMOVE_NETWORK all")
+        dev[0].dump_monitor()
+    finally:
+        dev[0].set("sae_groups", "")
+        dev[0].set("sae_pwe", "0")
+
 def test_sae_pwe_in_psk_ap(dev, apdev):
     """sae_pwe parameter in PSK-only-AP"""
     params = hostapd.wpa2_params(ssid="test-psk", passphrase="12345678")
@@ -10,6 +10,7 @@
 
 #include "common.h"
 #include "crypto/crypto.h"
+#include "crypto/sha1.h"
 
 
 static int cavp_shavs(const char *fname)
@@ -106,6 +107,151 @@ static int cavp_shavs(const char *fname)
 }
 
 
+struct passphrase_test {
+	const char *passphrase;
+	const char *ssid;
+	const char *psk;
+};
+
+static const struct passphrase_test passphrase_tests[] = {
+	{
+		"password",
+		"IEEE",
+		"f42c6fc52df0ebef9ebb4b90b38a5f90"
+		"2e83fe1b135a70e23aed762e9710a12e"
+	},
+	{
+		"ThisIsAPassword",
+		"ThisIsASSID",
+		"0dc0d6eb90555ed6419756b9a15ec3e3"
+		"209b63df707dd508d14581f8982721af"
+	},
+	{
+		"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+		"ZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZ",
+		"2d43d0dabfdd635377172efa1fc4b4b8"
+		"7dbfc4219193909ded9a7cfb89a3097b"
+	},
+};
+
+
+static int test_pbkdf2_sha1(void)
+{
+	unsigned int i;
+	u8 psk[32], expected[32];
+	int ret = 0;
+
+	printf("PBKDF2-SHA1 Passphrase test cases\n");
+	for (i = 0; i < ARRAY_SIZE(passphrase_tests); i++) {
+		const struct passphrase_test *test = &passphrase_tests[i];
+
+		if (hexstr2bin(test->psk, expected, sizeof(expected)) < 0 ||
+		    pbkdf2_sha1(test->passphrase, (const u8 *) test->ssid,
+				os_strlen(test->ssid), 4096, psk,
+				sizeof(psk)) < 0 ||
+		    os_memcmp(psk, expected, sizeof(psk)) != 0) {
+			printf("Test case %u failed\n", i);
+			ret++;
+		}
+	}
+
+	if (!ret)
+		printf("%u test vectors OK\n", i);
+
+	return ret;
+}
+
+
+static int test_pbkdf2_sha1_mb(void)
+{
+	const char *passphrase[7];
+	u8 psk[7][32], expected[32];
+	u8 *buf[7];
+	unsigned int i, num;
+	int ret = 0;
+
+	printf("PBKDF2-SHA1 multi-buffer test cases\n");
+	/* Use the same SSID for all passphrases and more passphrases than there
+	 * are parallel lanes */
+	for (i = 0; i < ARRAY_SIZE(passphrase); i++) {
+		passphrase[i] = passphrase_tests[i % 2].passphrase;
+		buf[i] = psk[i];
+	}
+	for (num = 1; num <= ARRAY_SIZE(passphrase); num++) {
+		os_memset(psk, 0, sizeof(psk));
+		if (pbkdf2_sha1_mb(num, passphrase,
+				   (const u8 *) passphrase_tests[0].ssid,
+				   os_strlen(passphrase_tests[0].ssid), 4096,
+				   buf, sizeof(psk[0])) < 0) {
+			printf("pbkdf2_sha1_mb(%u) failed\n", num);
+			ret++;
+			continue;
+		}
+		for (i = 0; i < num; i++) {
+			if (pbkdf2_sha1(passphrase[i],
+					(const u8 *) passphrase_tests[0].ssid,
+					os_strlen(passphrase_tests[0].ssid),
+					4096, expected, sizeof(expected)) < 0 ||
+			    os_memcmp(psk[i], expected, sizeof(expected)) != 0) {
+				printf("Test case %u/%u failed\n", num, i);
+				ret++;
+			}
+		}
+	}
+
+	if (!ret)
+		printf("%u test cases OK\n", num - 1);
+
+	return ret;
+}
+
+
+static void bench_sha1(void)
+{
+	const char *passphrase[16];
+	u8 psk[16][32];
+	u8 *buf[16];
+	u8 data[1024], hash[SHA1_MAC_LEN];
+	const u8 *addr[1];
+	size_t len[1];
+	struct os_reltime start, end, diff;
+	unsigned int i;
+
+	os_memset(data, 0xa5, sizeof(data));
+	addr[0] = data;
+	len[0] = sizeof(data);
+	os_get_reltime(&start);
+	for (i = 0; i < 100000; i++)
+		sha1_vector(1, addr, len, hash);
+	os_get_reltime(&end);
+	os_reltime_sub(&end, &start, &diff);
+	printf("SHA1: %u x %zu octets in %ld.%06ld sec\n",
+	       i, sizeof(data), (long) diff.sec, (long) diff.usec);
+
+	for (i = 0; i < ARRAY_SIZE(passphrase); i++) {
+		passphrase[i] = passphrase_tests[0].passphrase;
+		buf[i] = psk[i];
+	}
+
+	os_get_reltime(&start);
+	for (i = 0; i < ARRAY_SIZE(passphrase); i++)
+		pbkdf2_sha1(passphrase[i], (const u8 *) "IEEE", 4, 4096,
+			    psk[i], sizeof(psk[i]));
+	os_get_reltime(&end);
+	os_reltime_sub(&end, &start, &diff);
+	printf("PBKDF2-SHA1: %zu passphrases in %ld.%06ld sec\n",
+	       ARRAY_SIZE(passphrase), (long) diff.sec, (long) diff.usec);
+
+	os_get_reltime(&start);
+	pbkdf2_sha1_mb(ARRAY_SIZE(passphrase), passphrase, (const u8 *) "IEEE",
+		       4, 4096, buf, sizeof(psk[0]));
+	os_get_reltime(&end);
+	os_reltime_sub(&end, &start, &diff);
+	printf("PBKDF2-SHA1 multi-buffer: %zu passphrases in %ld.%06ld sec\n",
+	       ARRAY_SIZE(passphrase), (long) diff.sec, (long) diff.usec);
+}
+
+
 int main(int argc, char *argv[])
 {
 	int ret = 0;
@@ -114,6 +260,13 @@ int main(int argc, char *argv[])
 		ret++;
 	if (cavp_shavs("CAVP/SHA1LongMsg.rsp"))
 		ret++;
+	if (test_pbkdf2_sha1())
+		ret++;
+	if (test_pbkdf2_sha1_mb())
+		ret++;
+
+	if (argc > 1 && os_strcmp(argv[1], "bench") == 0)
+		bench_sha1();
 
 	return ret;
 }
@@ -10,6 +10,7 @@
 
 #include "common.h"
 #include "crypto/crypto.h"
+#include "crypto/sha256.h"
 
 
 static int cavp_shavs(const char *fname)
@@ -106,6 +107,35 @@ static int cavp_shavs(const char *fname)
 }
 
 
+static void bench_sha256(void)
+{
+	u8 data[1024], hash[32];
+	const u8 *addr[1];
+	size_t len[1];
+	struct os_reltime start, end, diff;
+	unsigned int i;
+
+	os_memset(data, 0xa5, sizeof(data));
+	addr[0] = data;
+	len[0] = sizeof(data);
+	os_get_reltime(&start);
+	for (i = 0; i < 100000; i++)
+		sha256_vector(1, addr, len, hash);
+	os_get_reltime(&end);
+	os_reltime_sub(&end, &start, &diff);
+	printf("SHA256: %u x %zu octets in %ld.%06ld sec\n",
+	       i, sizeof(data), (long) diff.sec, (long) diff.usec);
+
+	os_get_reltime(&start);
+	for (i = 0; i < 100000; i++)
+		hmac_sha256(data, 32, data, 64, hash);
+	os_get_reltime(&end);
+	os_reltime_sub(&end, &start, &diff);
+	printf("HMAC-SHA256: %u x 64 octets in %ld.%06ld sec\n",
+	       i, (long) diff.sec, (long) diff.usec);
+}
+
+
 int main(int argc, char *argv[])
 {
 	int errors = 0;
@@ -115,5 +145,8 @@ int main(int argc, char *argv[])
 	if (cavp_shavs("CAVP/SHA256LongMsg.rsp"))
 		errors++;
 
+	if (argc > 1 && os_strcmp(argv[1], "bench") == 0)
+		bench_sha256();
+
 	return errors;
 }
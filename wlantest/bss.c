@@ -128,6 +128,19 @@ int bss_add_pmk_from_passphrase(struct wlantest_bss *bss,
 static void bss_add_pmk(struct wlantest *wt, struct wlantest_bss *bss)
 {
 	struct wlantest_passphrase *p;
+	struct wlantest_pmk **pmk = NULL;
+	const char **passphrase = NULL;
+	u8 **buf = NULL;
+	size_t i, num = 0, max;
+
+	max = dl_list_len(&wt->passphrase);
+	if (!max)
+		return;
+	pmk = os_calloc(max, sizeof(*pmk));
+	passphrase = os_calloc(max, sizeof(*passphrase));
+	buf = os_calloc(max, sizeof(*buf));
+	if (!pmk || !passphrase || !buf)
+		goto fail;
 
 	dl_list_for_each(p, &wt->passphrase, struct wlantest_passphrase, list)
 	{
@@ -139,9 +152,38 @@ static void bss_add_pmk(struct wlantest *wt, struct wlantest_bss *bss)
 		     os_memcmp(p->ssid, bss->ssid, p->ssid_len) != 0))
 			continue;
 
-		if (bss_add_pmk_from_passphrase(bss, p->passphrase) < 0)
+		pmk[num] = os_zalloc(sizeof(**pmk));
+		if (!pmk[num])
 			break;
+		passphrase[num] = p->passphrase;
+		buf[num] = pmk[num]->pmk;
+		num++;
+	}
+
+	/* Derive the PMKs for all matching passphrases at once to allow them
+	 * to be processed in parallel */
+	if (!num || pbkdf2_sha1_mb(num, passphrase, bss->ssid, bss->ssid_len,
+				   4096, buf, PMK_LEN) < 0)
+		goto fail;
+
+	for (i = 0; i < num; i++) {
+		wpa_printf(MSG_INFO, "Add possible PMK for BSSID " MACSTR
+			   " based on passphrase '%s'",
+			   MAC2STR(bss->bssid), passphrase[i]);
+		wpa_hexdump(MSG_DEBUG, "Possible PMK", pmk[i]->pmk, PMK_LEN);
+		pmk[i]->pmk_len = PMK_LEN;
+		dl_list_add(&bss->pmk, &pmk[i]->list);
+		pmk[i] = NULL;
 	}
+
+fail:
+	if (pmk) {
+		for (i = 0; i < num; i++)
+			os_free(pmk[i]);
+	}
+	os_free(pmk);
+	os_free(passphrase);
+	os_free(buf);
 }
 
 
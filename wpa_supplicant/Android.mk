@@ -157,6 +157,13 @@ ifdef CONFIG_ELOOP_EPOLL
 L_CFLAGS += -DCONFIG_ELOOP_EPOLL
 endif
 
+ifdef CONFIG_OS_POOL
+L_CFLAGS += -DCONFIG_OS_POOL
+OBJS += src/utils/os_pool.c
+OBJS_c += src/utils/os_pool.c
+OBJS_priv += src/utils/os_pool.c
+endif
+
 ifdef CONFIG_EAPOL_TEST
 L_CFLAGS += -Werror -DEAPOL_TEST
 endif
@@ -1618,6 +1625,16 @@ ifdef CONFIG_DEBUG_FILE
 L_CFLAGS += -DCONFIG_DEBUG_FILE
 endif
 
+ifdef CONFIG_DEBUG_MIN_LEVEL
+L_CFLAGS += -DCONFIG_DEBUG_MIN_LEVEL=MSG_$(CONFIG_DEBUG_MIN_LEVEL)
+endif
+
+ifdef CONFIG_DEBUG_RINGBUF
+ifndef CONFIG_NO_STDOUT_DEBUG
+L_CFLAGS += -DCONFIG_DEBUG_RINGBUF
+endif
+endif
+
 ifdef CONFIG_DELAYED_MIC_ERROR_REPORT
 L_CFLAGS += -DCONFIG_DELAYED_MIC_ERROR_REPORT
 endif
@@ -1756,6 +1773,9 @@ PASNOBJS += src/utils/wpabuf.c
 PASNOBJS += src/utils/os_$(CONFIG_OS).c
 PASNOBJS += src/utils/config.c
 PASNOBJS += src/utils/common.c
+ifdef CONFIG_OS_POOL
+PASNOBJS += src/utils/os_pool.c
+endif
 
 ifdef NEED_BASE64
 PASNOBJS += src/utils/base64.c
@@ -20,6 +20,7 @@
 #include "scan.h"
 #include "bssid_ignore.h"
 #include "bss.h"
+#include "interworking.h"
 
 static void wpa_bss_set_hessid(struct wpa_bss *bss)
 {
@@ -159,6 +160,7 @@ static void wpa_bss_anqp_free(struct wpa_bss_anqp *anqp)
 	wpabuf_free(anqp->roaming_consortium);
 	wpabuf_free(anqp->ip_addr_type_availability);
 	wpabuf_free(anqp->nai_realm);
+	interworking_nai_realm_flush(anqp);
 	wpabuf_free(anqp->anqp_3gpp);
 	wpabuf_free(anqp->domain_name);
 	wpabuf_free(anqp->fils_realm_info);
@@ -37,6 +37,8 @@ struct wpa_bss_anqp_elem {
 	struct wpabuf *payload;
 };
 
+struct nai_realm;
+
 /**
  * struct wpa_bss_anqp - ANQP data for a BSS entry (struct wpa_bss)
  */
@@ -50,6 +52,9 @@ struct wpa_bss_anqp {
 	struct wpabuf *roaming_consortium;
 	struct wpabuf *ip_addr_type_availability;
 	struct wpabuf *nai_realm;
+	/* Parsed nai_realm; built on first use by interworking.c */
+	struct nai_realm *nai_realm_parsed;
+	u16 nai_realm_count;
 	struct wpabuf *anqp_3gpp;
 	struct wpabuf *domain_name;
 	struct wpabuf *fils_realm_info;
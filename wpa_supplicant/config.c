@@ -2751,6 +2751,103 @@ static const struct parse_data ssid_fields[] = {
 #define NUM_SSID_FIELDS ARRAY_SIZE(ssid_fields)
 
 
+/* Hash index for looking up configuration fields by name. Each slot stores the
+ * table index + 1 of a field with 0 marking an unused slot. The index is built
+ * on first use and uses open addressing; the size needs to be clearly larger
+ * than the number of fields in ssid_fields[] and global_fields[]. */
+#define CONFIG_FIELD_INDEX_SIZE 1024
+
+struct config_field_index {
+	const void *table;
+	size_t entry_len;
+	size_t num;
+	bool built;
+	u16 slot[CONFIG_FIELD_INDEX_SIZE];
+};
+
+
+static unsigned int config_field_hash(const char *name, size_t len)
+{
+	u32 hash = 2166136261U;
+
+	/* FNV-1a */
+	while (len--) {
+		hash ^= (u8) *name++;
+		hash *= 16777619U;
+	}
+
+	return hash & (CONFIG_FIELD_INDEX_SIZE - 1);
+}
+
+
+static const char * config_field_name(const struct config_field_index *idx,
+				      size_t i)
+{
+	/* All field tables start with the name of the variable */
+	return *(char * const *) ((const u8 *) idx->table +
+				  i * idx->entry_len);
+}
+
+
+static void config_field_index_build(struct config_field_index *idx)
+{
+	size_t i;
+	unsigned int h;
+	const char *name;
+
+	for (i = 0; i < idx->num; i++) {
+		name = config_field_name(idx, i);
+		h = config_field_hash(name, os_strlen(name));
+		while (idx->slot[h]) {
+			/* Keep the first entry for duplicate names */
+			if (os_strcmp(config_field_name(idx,
+							idx->slot[h] - 1),
+				      name) == 0)
+				break;
+			h = (h + 1) & (CONFIG_FIELD_INDEX_SIZE - 1);
+		}
+		if (!idx->slot[h])
+			idx->slot[h] = i + 1;
+	}
+	idx->built = true;
+}
+
+
+static int config_field_index_get(struct config_field_index *idx,
+				  const char *name, size_t len)
+{
+	unsigned int h;
+	const char *fname;
+
+	if (!idx->built)
+		config_field_index_build(idx);
+
+	h = config_field_hash(name, len);
+	while (idx->slot[h]) {
+		fname = config_field_name(idx, idx->slot[h] - 1);
+		if (os_strncmp(fname, name, len) == 0 && fname[len] == '\0')
+			return idx->slot[h] - 1;
+		h = (h + 1) & (CONFIG_FIELD_INDEX_SIZE - 1);
+	}
+
+	return -1;
+}
+
+
+static struct config_field_index ssid_field_index = {
+	ssid_fields, sizeof(ssid_fields[0]), NUM_SSID_FIELDS, false, { 0 }
+};
+
+
+static const struct parse_data * ssid_field_get(const char *name)
+{
+	int i;
+
+	i = config_field_index_get(&ssid_field_index, name, os_strlen(name));
+	return i < 0 ? NULL : &ssid_fields[i];
+}
+
+
 /**
  * wpa_config_add_prio_network - Add a network to priority lists
  * @config: Configuration data from wpa_config_read()
@@ -3294,17 +3391,14 @@ static bool removed_field(const char *field)
 int wpa_config_set(struct wpa_ssid *ssid, const char *var, const char *value,
 		   int line)
 {
-	size_t i;
+	const struct parse_data *field;
 	int ret = 0;
 
 	if (ssid == NULL || var == NULL || value == NULL)
 		return -1;
 
-	for (i = 0; i < NUM_SSID_FIELDS; i++) {
-		const struct parse_data *field = &ssid_fields[i];
-		if (os_strcmp(var, field->name) != 0)
-			continue;
-
+	field = ssid_field_get(var);
+	if (field) {
 		ret = field->parser(field, ssid, line, value);
 		if (ret < 0) {
 			if (line) {
@@ -3322,9 +3416,7 @@ int wpa_config_set(struct wpa_ssid *ssid, const char *var, const char *value,
 			ssid->pt = NULL;
 		}
 #endif /* CONFIG_SAE */
-		break;
-	}
-	if (i == NUM_SSID_FIELDS) {
+	} else {
 		if (removed_field(var)) {
 			wpa_printf(MSG_INFO,
 				   "Line %d: Ignore removed configuration field '%s'",
@@ -3444,29 +3536,26 @@ err:
  */
 char * wpa_config_get(struct wpa_ssid *ssid, const char *var)
 {
-	size_t i;
+	const struct parse_data *field;
+	char *ret;
 
 	if (ssid == NULL || var == NULL)
 		return NULL;
 
-	for (i = 0; i < NUM_SSID_FIELDS; i++) {
-		const struct parse_data *field = &ssid_fields[i];
-		if (os_strcmp(var, field->name) == 0) {
-			char *ret = field->writer(field, ssid);
-
-			if (ret && has_newline(ret)) {
-				wpa_printf(MSG_ERROR,
-					   "Found newline in value for %s; not returning it",
-					   var);
-				os_free(ret);
-				ret = NULL;
-			}
+	field = ssid_field_get(var);
+	if (!field)
+		return NULL;
 
-			return ret;
-		}
+	ret = field->writer(field, ssid);
+	if (ret && has_newline(ret)) {
+		wpa_printf(MSG_ERROR,
+			   "Found newline in value for %s; not returning it",
+			   var);
+		os_free(ret);
+		ret = NULL;
 	}
 
-	return NULL;
+	return ret;
 }
 
 
@@ -3488,32 +3577,29 @@ char * wpa_config_get(struct wpa_ssid *ssid, const char *var)
  */
 char * wpa_config_get_no_key(struct wpa_ssid *ssid, const char *var)
 {
-	size_t i;
+	const struct parse_data *field;
+	char *res;
 
 	if (ssid == NULL || var == NULL)
 		return NULL;
 
-	for (i = 0; i < NUM_SSID_FIELDS; i++) {
-		const struct parse_data *field = &ssid_fields[i];
-		if (os_strcmp(var, field->name) == 0) {
-			char *res = field->writer(field, ssid);
-			if (field->key_data) {
-				if (res && res[0]) {
-					wpa_printf(MSG_DEBUG, "Do not allow "
-						   "key_data field to be "
-						   "exposed");
-					str_clear_free(res);
-					return os_strdup("*");
-				}
+	field = ssid_field_get(var);
+	if (!field)
+		return NULL;
 
-				os_free(res);
-				return NULL;
-			}
-			return res;
+	res = field->writer(field, ssid);
+	if (field->key_data) {
+		if (res && res[0]) {
+			wpa_printf(MSG_DEBUG, "Do not allow key_data field to be exposed");
+			str_clear_free(res);
+			return os_strdup("*");
 		}
+
+		os_free(res);
+		return NULL;
 	}
 
-	return NULL;
+	return res;
 }
 #endif /* NO_CONFIG_WRITE */
 
@@ -3527,6 +3613,7 @@ char * wpa_config_get_no_key(struct wpa_ssid *ssid, const char *var)
  */
 void wpa_config_update_psk(struct wpa_ssid *ssid)
 {
+	ssid->psk_pending = false;
 #ifndef CONFIG_NO_PBKDF2
 	if (pbkdf2_sha1(ssid->passphrase, ssid->ssid, ssid->ssid_len, 4096,
 			ssid->psk, PMK_LEN) != 0) {
@@ -3540,6 +3627,23 @@ void wpa_config_update_psk(struct wpa_ssid *ssid)
 }
 
 
+/**
+ * wpa_config_ensure_psk - Derive a postponed WPA PSK
+ * @ssid: Pointer to network configuration data
+ *
+ * This function derives the PSK from the passphrase if that was postponed when
+ * reading the configuration (ssid->psk_pending).
+ */
+void wpa_config_ensure_psk(struct wpa_ssid *ssid)
+{
+	if (!ssid->psk_pending)
+		return;
+	if (ssid->passphrase && !ssid->psk_set)
+		wpa_config_update_psk(ssid);
+	ssid->psk_pending = false;
+}
+
+
 static int wpa_config_set_cred_req_conn_capab(struct wpa_cred *cred,
 					      const char *value)
 {
@@ -5563,6 +5667,12 @@ static const struct global_parse_data global_fields[] = {
 #define NUM_GLOBAL_FIELDS ARRAY_SIZE(global_fields)
 
 
+static struct config_field_index global_field_index = {
+	global_fields, sizeof(global_fields[0]), NUM_GLOBAL_FIELDS, false,
+	{ 0 }
+};
+
+
 int wpa_config_dump_values(struct wpa_config *config, char *buf, size_t buflen)
 {
 	int result = 0;
@@ -5590,20 +5700,16 @@ int wpa_config_dump_values(struct wpa_config *config, char *buf, size_t buflen)
 int wpa_config_get_value(const char *name, struct wpa_config *config,
 			 char *buf, size_t buflen)
 {
-	size_t i;
-
-	for (i = 0; i < NUM_GLOBAL_FIELDS; i++) {
-		const struct global_parse_data *field = &global_fields[i];
-
-		if (os_strcmp(name, field->name) != 0)
-			continue;
-		if (!field->get)
-			break;
-		return field->get(name, config, (long) field->param1,
-				  buf, buflen, 0);
-	}
+	const struct global_parse_data *field;
+	int i;
 
-	return -1;
+	i = config_field_index_get(&global_field_index, name, os_strlen(name));
+	if (i < 0)
+		return -1;
+	field = &global_fields[i];
+	if (!field->get)
+		return -1;
+	return field->get(name, config, (long) field->param1, buf, buflen, 0);
 }
 
 
@@ -5639,30 +5745,29 @@ const char * wpa_config_get_global_field_name(unsigned int i, int *no_var)
  */
 int wpa_config_process_global(struct wpa_config *config, char *pos, int line)
 {
-	size_t i;
+	const char *eq;
+	int i = -1;
 	int ret = 0;
 
-	for (i = 0; i < NUM_GLOBAL_FIELDS; i++) {
+	eq = os_strchr(pos, '=');
+	if (eq)
+		i = config_field_index_get(&global_field_index, pos, eq - pos);
+	if (i >= 0) {
 		const struct global_parse_data *field = &global_fields[i];
-		size_t flen = os_strlen(field->name);
-		if (os_strncmp(pos, field->name, flen) != 0 ||
-		    pos[flen] != '=')
-			continue;
 
-		ret = field->parser(field, config, line, pos + flen + 1);
+		ret = field->parser(field, config, line, eq + 1);
 		if (ret < 0) {
 			wpa_printf(MSG_ERROR, "Line %d: failed to "
 				   "parse '%s'.", line, pos);
 			ret = -1;
 		}
-		if (ret == 1)
-			break;
-		if (field->changed_flag == CFG_CHANGED_NFC_PASSWORD_TOKEN)
-			config->wps_nfc_pw_from_config = 1;
-		config->changed_parameters |= field->changed_flag;
-		break;
-	}
-	if (i == NUM_GLOBAL_FIELDS) {
+		if (ret != 1) {
+			if (field->changed_flag ==
+			    CFG_CHANGED_NFC_PASSWORD_TOKEN)
+				config->wps_nfc_pw_from_config = 1;
+			config->changed_parameters |= field->changed_flag;
+		}
+	} else {
 #ifdef CONFIG_AP
 		if (os_strncmp(pos, "tx_queue_", 9) == 0) {
 			char *tmp = os_strchr(pos, '=');
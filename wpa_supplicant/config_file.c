@@ -36,7 +36,9 @@ static int wpa_config_validate_network(struct wpa_ssid *ssid, int line)
 				   "passphrase configured.", line);
 			errors++;
 		}
-		wpa_config_update_psk(ssid);
+		/* PSK is derived on first use or in the background after
+		 * startup */
+		ssid->psk_pending = true;
 	}
 
 	if (ssid->disabled == 2)
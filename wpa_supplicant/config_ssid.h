@@ -223,6 +223,15 @@ struct wpa_ssid {
 	 */
 	int psk_set;
 
+	/**
+	 * psk_pending - Whether PSK is still to be derived from passphrase
+	 *
+	 * PBKDF2 derivation for networks read from the configuration file is
+	 * postponed to avoid delaying startup. wpa_config_ensure_psk() needs
+	 * to be called before using psk or psk_set when this is set.
+	 */
+	bool psk_pending;
+
 	/**
 	 * passphrase - WPA ASCII passphrase
 	 *
@@ -12534,6 +12534,17 @@ char * wpa_supplicant_ctrl_iface_process(struct wpa_supplicant *wpa_s,
 	} else if (os_strncmp(buf, "RELOG", 5) == 0) {
 		if (wpa_debug_reopen_file() < 0)
 			reply_len = -1;
+#ifdef CONFIG_DEBUG_RINGBUF
+	} else if (os_strcmp(buf, "DEBUG_RING_DUMP") == 0) {
+		if (wpa_debug_ring_dump() < 0)
+			reply_len = -1;
+	} else if (os_strcmp(buf, "DEBUG_RING_STATUS") == 0) {
+		reply_len = wpa_debug_ring_status(reply, reply_size);
+#endif /* CONFIG_DEBUG_RINGBUF */
+#ifdef CONFIG_OS_POOL
+	} else if (os_strcmp(buf, "MEMPOOL_STATS") == 0) {
+		reply_len = os_pool_stats(reply, reply_size);
+#endif /* CONFIG_OS_POOL */
 	} else if (os_strncmp(buf, "NOTE ", 5) == 0) {
 		wpa_printf(MSG_INFO, "NOTE: %s", buf + 5);
 	} else if (os_strcmp(buf, "MIB") == 0) {
@@ -13396,6 +13407,17 @@ char * wpa_supplicant_ctrl_iface_process(struct wpa_supplicant *wpa_s,
 			if (os_snprintf_error(reply_size, reply_len))
 				reply_len = -1;
 		}
+	} else if (os_strncmp(buf, "DPP_BOOTSTRAP_IMPORT ", 21) == 0) {
+		int res;
+
+		res = dpp_bootstrap_import(wpa_s->dpp, buf + 21);
+		if (res < 0) {
+			reply_len = -1;
+		} else {
+			reply_len = os_snprintf(reply, reply_size, "%d", res);
+			if (os_snprintf_error(reply_size, reply_len))
+				reply_len = -1;
+		}
 	} else if (os_strncmp(buf, "DPP_BOOTSTRAP_REMOVE ", 21) == 0) {
 		if (dpp_bootstrap_remove(wpa_s->dpp, buf + 21) < 0)
 			reply_len = -1;
@@ -14262,6 +14284,17 @@ char * wpa_supplicant_global_ctrl_iface_process(struct wpa_global *global,
 	} else if (os_strncmp(buf, "RELOG", 5) == 0) {
 		if (wpa_debug_reopen_file() < 0)
 			reply_len = -1;
+#ifdef CONFIG_DEBUG_RINGBUF
+	} else if (os_strcmp(buf, "DEBUG_RING_DUMP") == 0) {
+		if (wpa_debug_ring_dump() < 0)
+			reply_len = -1;
+	} else if (os_strcmp(buf, "DEBUG_RING_STATUS") == 0) {
+		reply_len = wpa_debug_ring_status(reply, reply_size);
+#endif /* CONFIG_DEBUG_RINGBUF */
+#ifdef CONFIG_OS_POOL
+	} else if (os_strcmp(buf, "MEMPOOL_STATS") == 0) {
+		reply_len = os_pool_stats(reply, reply_size);
+#endif /* CONFIG_OS_POOL */
 	} else {
 		os_memcpy(reply, "UNKNOWN COMMAND\n", 16);
 		reply_len = 16;
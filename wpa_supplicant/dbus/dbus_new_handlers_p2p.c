@@ -2529,6 +2529,7 @@ dbus_bool_t wpas_dbus_getter_p2p_group_psk(
 	if (ssid == NULL)
 		return FALSE;
 
+	wpa_config_ensure_psk(ssid);
 	if (ssid->psk_set) {
 		p_psk = ssid->psk;
 		psk_len = sizeof(ssid->psk);
@@ -148,7 +148,7 @@ int wpas_dpp_nfc_handover_req(struct wpa_supplicant *wpa_s, const char *cmd)
 		return -1;
 	}
 
-	if (dpp_nfc_update_bi(own_bi, peer_bi) < 0)
+	if (dpp_nfc_update_bi(wpa_s->dpp, own_bi, peer_bi) < 0)
 		return -1;
 
 	return peer_bi->id;
@@ -4909,6 +4909,12 @@ int wpas_dpp_controller_start(struct wpa_supplicant *wpa_s, const char *cmd)
 			config.tcp_port = atoi(pos);
 		}
 
+		pos = os_strstr(cmd, " max_conn=");
+		if (pos) {
+			pos += 10;
+			config.max_conn = atoi(pos);
+		}
+
 		pos = os_strstr(cmd, " role=");
 		if (pos) {
 			pos += 6;
@@ -3176,6 +3176,7 @@ static int wpa_supplicant_use_own_rsne_params(struct wpa_supplicant *wpa_s,
 	 */
 	if (wpa_s->key_mgmt != ie.key_mgmt &&
 	    wpa_key_mgmt_wpa_psk_no_sae(ie.key_mgmt)) {
+		wpa_config_ensure_psk(ssid);
 		if (!ssid->psk_set) {
 			wpa_dbg(wpa_s, MSG_INFO,
 				"No PSK available for association");
@@ -4196,6 +4197,7 @@ static void wpa_supplicant_event_assoc(struct wpa_supplicant *wpa_s,
 				"WPA/RSN IEs not updated");
 	}
 	if (data && data->assoc_info.roam_indication) {
+		wpa_config_ensure_psk(wpa_s->current_ssid);
 		if (wpa_s->current_ssid->psk_set) {
 			if (wpa_s->key_mgmt == WPA_KEY_MGMT_SAE) {
 				wpa_hexdump_key(MSG_MSGDUMP, "reset SAE PMK",
@@ -4395,6 +4397,7 @@ static void wpa_supplicant_event_assoc(struct wpa_supplicant *wpa_s,
 			return;
 		}
 
+		wpa_config_ensure_psk(wpa_s->current_ssid);
 		ibss_rsn_set_psk(wpa_s->ibss_rsn, wpa_s->current_ssid->psk);
 	}
 #endif /* CONFIG_IBSS_RSN */
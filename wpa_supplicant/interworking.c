@@ -121,6 +121,36 @@ static struct wpabuf * anqp_build_req(u16 info_ids[], size_t num_ids,
 }
 
 
+static int interworking_anqp_pending_idx(struct wpa_supplicant *wpa_s,
+					 const struct wpa_bss *bss)
+{
+	unsigned int i;
+
+	for (i = 0; i < INTERWORKING_MAX_PENDING_ANQP; i++) {
+		if (wpa_s->interworking_gas_bss[i] == bss)
+			return i;
+	}
+
+	return -1;
+}
+
+
+static void interworking_anqp_pending_del(struct wpa_supplicant *wpa_s,
+					  const u8 *dst)
+{
+	unsigned int i;
+
+	for (i = 0; i < INTERWORKING_MAX_PENDING_ANQP; i++) {
+		if (wpa_s->interworking_gas_bss[i] &&
+		    ether_addr_equal(wpa_s->interworking_gas_bssid[i], dst)) {
+			wpa_s->interworking_gas_bss[i] = NULL;
+			wpa_s->interworking_gas_pending--;
+			return;
+		}
+	}
+}
+
+
 static void interworking_anqp_resp_cb(void *ctx, const u8 *dst,
 				      u8 dialog_token,
 				      enum gas_query_result result,
@@ -135,6 +165,7 @@ static void interworking_anqp_resp_cb(void *ctx, const u8 *dst,
 		   MAC2STR(dst), dialog_token, result, status_code);
 	anqp_resp_cb(wpa_s, dst, dialog_token, result, adv_proto, resp,
 		     status_code);
+	interworking_anqp_pending_del(wpa_s, dst);
 	interworking_next_anqp_fetch(wpa_s);
 }
 
@@ -257,7 +288,6 @@ static int interworking_anqp_send_req(struct wpa_supplicant *wpa_s,
 
 	wpa_msg(wpa_s, MSG_DEBUG, "Interworking: ANQP Query Request to " MACSTR,
 		MAC2STR(bss->bssid));
-	wpa_s->interworking_gas_bss = bss;
 
 	info_ids[num_info_ids++] = ANQP_CAPABILITY_LIST;
 	if (all) {
@@ -322,11 +352,19 @@ static int interworking_anqp_send_req(struct wpa_supplicant *wpa_s,
 		wpa_msg(wpa_s, MSG_DEBUG, "ANQP: Failed to send Query Request");
 		wpabuf_free(buf);
 		ret = -1;
-		eloop_register_timeout(0, 0, interworking_continue_anqp, wpa_s,
-				       NULL);
-	} else
+	} else {
+		int idx = interworking_anqp_pending_idx(wpa_s, NULL);
+
 		wpa_msg(wpa_s, MSG_DEBUG,
 			"ANQP: Query started with dialog token %u", res);
+		if (idx >= 0) {
+			wpa_s->interworking_gas_bss[idx] = bss;
+			os_memcpy(wpa_s->interworking_gas_bssid[idx],
+				  bss->bssid, ETH_ALEN);
+			wpa_s->interworking_gas_pending++;
+		}
+		wpa_s->interworking_gas_freq = bss->freq;
+	}
 
 	return ret;
 }
@@ -569,38 +607,62 @@ static struct nai_realm * nai_realm_parse(struct wpabuf *anqp, u16 *count)
 }
 
 
-static int nai_realm_match(struct nai_realm *realm, const char *home_realm)
+/**
+ * interworking_nai_realm_flush - Free the parsed NAI Realm list of ANQP data
+ * @anqp: ANQP data of a BSS entry
+ *
+ * This needs to be called whenever anqp->nai_realm is replaced.
+ */
+void interworking_nai_realm_flush(struct wpa_bss_anqp *anqp)
 {
-	char *tmp, *pos, *end;
-	int match = 0;
+	nai_realm_free(anqp->nai_realm_parsed, anqp->nai_realm_count);
+	anqp->nai_realm_parsed = NULL;
+	anqp->nai_realm_count = 0;
+}
 
-	if (realm->realm == NULL || home_realm == NULL)
-		return 0;
 
-	if (os_strchr(realm->realm, ';') == NULL)
-		return os_strcasecmp(realm->realm, home_realm) == 0;
+/* Returns the parsed NAI Realm list of a BSS. The list is parsed only once and
+ * remains owned by the ANQP data of the BSS. */
+static struct nai_realm * nai_realm_get(struct wpa_bss *bss, u16 *count)
+{
+	struct wpa_bss_anqp *anqp = bss->anqp;
+
+	if (!anqp || !anqp->nai_realm)
+		return NULL;
+
+	if (!anqp->nai_realm_parsed)
+		anqp->nai_realm_parsed = nai_realm_parse(anqp->nai_realm,
+							 &anqp->nai_realm_count);
+	*count = anqp->nai_realm_count;
+	return anqp->nai_realm_parsed;
+}
+
 
-	tmp = os_strdup(realm->realm);
-	if (tmp == NULL)
+static int nai_realm_match(struct nai_realm *realm, const char *home_realm)
+{
+	const char *pos, *end;
+	size_t len;
+
+	if (realm->realm == NULL || home_realm == NULL)
 		return 0;
 
-	pos = tmp;
-	while (*pos) {
+	/* Compare against each entry of the semicolon separated list in place
+	 * to avoid copying the realm for every credential */
+	len = os_strlen(home_realm);
+	pos = realm->realm;
+	for (;;) {
 		end = os_strchr(pos, ';');
-		if (end)
-			*end = '\0';
-		if (os_strcasecmp(pos, home_realm) == 0) {
-			match = 1;
-			break;
-		}
-		if (end == NULL)
+		if (!end)
+			end = pos + os_strlen(pos);
+		if ((size_t) (end - pos) == len &&
+		    os_strncasecmp(pos, home_realm, len) == 0)
+			return 1;
+		if (*end == '\0')
 			break;
 		pos = end + 1;
 	}
 
-	os_free(tmp);
-
-	return match;
+	return 0;
 }
 
 
@@ -1818,8 +1880,7 @@ int interworking_connect(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 		return -1;
 	}
 
-	realm = nai_realm_parse(bss->anqp ? bss->anqp->nai_realm : NULL,
-				&count);
+	realm = nai_realm_get(bss, &count);
 	if (realm == NULL) {
 		wpa_msg(wpa_s, MSG_DEBUG,
 			"Interworking: Could not parse NAI Realm list from "
@@ -1839,7 +1900,6 @@ int interworking_connect(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 		wpa_msg(wpa_s, MSG_DEBUG,
 			"Interworking: No matching credentials and EAP method found for "
 			MACSTR, MAC2STR(bss->bssid));
-		nai_realm_free(realm, count);
 		return -1;
 	}
 
@@ -1849,17 +1909,14 @@ int interworking_connect(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 	if (already_connected(wpa_s, cred, bss)) {
 		wpa_msg(wpa_s, MSG_INFO, INTERWORKING_ALREADY_CONNECTED MACSTR,
 			MAC2STR(bss->bssid));
-		nai_realm_free(realm, count);
 		return 0;
 	}
 
 	remove_duplicate_network(wpa_s, cred, bss);
 
 	ssid = wpa_config_add_network(wpa_s->conf);
-	if (ssid == NULL) {
-		nai_realm_free(realm, count);
+	if (ssid == NULL)
 		return -1;
-	}
 	ssid->parent_cred = cred;
 	wpas_notify_network_added(wpa_s, ssid);
 	wpa_config_set_network_defaults(ssid);
@@ -1943,8 +2000,6 @@ int interworking_connect(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 					eap->method == EAP_TYPE_TTLS) < 0)
 		goto fail;
 
-	nai_realm_free(realm, count);
-
 	wpa_s->next_ssid = ssid;
 	wpa_config_update_prio_list(wpa_s->conf);
 	if (!only_add)
@@ -1955,7 +2010,6 @@ int interworking_connect(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 fail:
 	wpas_notify_network_removed(wpa_s, ssid);
 	wpa_config_remove_network(wpa_s->conf, ssid->id);
-	nai_realm_free(realm, count);
 	return -1;
 }
 
@@ -2127,7 +2181,7 @@ static struct wpa_cred * interworking_credentials_available_realm(
 
 	wpa_msg(wpa_s, MSG_DEBUG, "Interworking: Parsing NAI Realm list from "
 		MACSTR, MAC2STR(bss->bssid));
-	realm = nai_realm_parse(bss->anqp->nai_realm, &count);
+	realm = nai_realm_get(bss, &count);
 	if (realm == NULL) {
 		wpa_msg(wpa_s, MSG_DEBUG,
 			"Interworking: Could not parse NAI Realm list from "
@@ -2177,8 +2231,6 @@ static struct wpa_cred * interworking_credentials_available_realm(
 		}
 	}
 
-	nai_realm_free(realm, count);
-
 	if (excluded)
 		*excluded = is_excluded;
 
@@ -2684,15 +2736,73 @@ interworking_match_anqp_info(struct wpa_supplicant *wpa_s, struct wpa_bss *bss)
 }
 
 
+static bool interworking_anqp_fetch_needed(struct wpa_supplicant *wpa_s,
+					   struct wpa_bss *bss)
+{
+	if (!(bss->caps & IEEE80211_CAP_ESS))
+		return false;
+	if (!wpa_bss_ext_capab(bss, WLAN_EXT_CAPAB_INTERWORKING))
+		return false; /* AP does not support Interworking */
+	if (disallowed_bssid(wpa_s, bss->bssid) ||
+	    disallowed_ssid(wpa_s, bss->ssid, bss->ssid_len))
+		return false; /* Disallowed BSS */
+	return !(bss->flags & WPA_BSS_ANQP_FETCH_TRIED);
+}
+
+
+static bool interworking_anqp_hessid_pending(struct wpa_supplicant *wpa_s,
+					     struct wpa_bss *bss)
+{
+	struct wpa_bss *other;
+
+	if (!wpa_s->interworking_gas_pending || is_zero_ether_addr(bss->hessid))
+		return false;
+
+	dl_list_for_each(other, &wpa_s->bss, struct wpa_bss, list) {
+		if (other != bss &&
+		    interworking_anqp_pending_idx(wpa_s, other) >= 0 &&
+		    ether_addr_equal(bss->hessid, other->hessid) &&
+		    bss->ssid_len == other->ssid_len &&
+		    os_memcmp(bss->ssid, other->ssid, bss->ssid_len) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+
+/*
+ * Select the next BSS to query. BSSs on the channel of the previous query are
+ * preferred to minimize channel switches and BSSs in the same homogeneous ESS
+ * as a pending query are postponed to be able to share the ANQP data.
+ */
+static struct wpa_bss * interworking_anqp_next_bss(struct wpa_supplicant *wpa_s)
+{
+	struct wpa_bss *bss, *first = NULL;
+
+	dl_list_for_each(bss, &wpa_s->bss, struct wpa_bss, list) {
+		if (!interworking_anqp_fetch_needed(wpa_s, bss) ||
+		    interworking_anqp_hessid_pending(wpa_s, bss))
+			continue;
+		if (bss->freq == wpa_s->interworking_gas_freq)
+			return bss;
+		if (!first)
+			first = bss;
+	}
+
+	return first;
+}
+
+
 static void interworking_next_anqp_fetch(struct wpa_supplicant *wpa_s)
 {
 	struct wpa_bss *bss;
-	int found = 0;
 
 	wpa_printf(MSG_DEBUG, "Interworking: next_anqp_fetch - "
-		   "fetch_anqp_in_progress=%d fetch_osu_icon_in_progress=%d",
+		   "fetch_anqp_in_progress=%d fetch_osu_icon_in_progress=%d pending=%u",
 		   wpa_s->fetch_anqp_in_progress,
-		   wpa_s->fetch_osu_icon_in_progress);
+		   wpa_s->fetch_osu_icon_in_progress,
+		   wpa_s->interworking_gas_pending);
 
 	if (eloop_terminated() || !wpa_s->fetch_anqp_in_progress) {
 		wpa_printf(MSG_DEBUG, "Interworking: Stop next-ANQP-fetch");
@@ -2707,57 +2817,53 @@ static void interworking_next_anqp_fetch(struct wpa_supplicant *wpa_s)
 	}
 #endif /* CONFIG_HS20 */
 
-	dl_list_for_each(bss, &wpa_s->bss, struct wpa_bss, list) {
-		if (!(bss->caps & IEEE80211_CAP_ESS))
-			continue;
-		if (!wpa_bss_ext_capab(bss, WLAN_EXT_CAPAB_INTERWORKING))
-			continue; /* AP does not support Interworking */
-		if (disallowed_bssid(wpa_s, bss->bssid) ||
-		    disallowed_ssid(wpa_s, bss->ssid, bss->ssid_len))
-			continue; /* Disallowed BSS */
-
-		if (!(bss->flags & WPA_BSS_ANQP_FETCH_TRIED)) {
-			if (bss->anqp == NULL) {
-				bss->anqp = interworking_match_anqp_info(wpa_s,
-									 bss);
-				if (bss->anqp) {
-					/* Shared data already fetched */
-					continue;
-				}
-				bss->anqp = wpa_bss_anqp_alloc();
-				if (bss->anqp == NULL)
-					break;
-			}
-			found++;
-			bss->flags |= WPA_BSS_ANQP_FETCH_TRIED;
-			wpa_msg(wpa_s, MSG_INFO, "Starting ANQP fetch for "
-				MACSTR " (HESSID " MACSTR ")",
-				MAC2STR(bss->bssid), MAC2STR(bss->hessid));
-			interworking_anqp_send_req(wpa_s, bss);
+	/* Keep multiple queries queued so that the next query can be sent
+	 * as soon as the previous one completes. */
+	while (wpa_s->interworking_gas_pending <
+	       INTERWORKING_MAX_PENDING_ANQP) {
+		bss = interworking_anqp_next_bss(wpa_s);
+		if (!bss)
 			break;
+
+		if (bss->anqp == NULL) {
+			bss->anqp = interworking_match_anqp_info(wpa_s, bss);
+			if (bss->anqp) {
+				/* Shared data already fetched */
+				bss->flags |= WPA_BSS_ANQP_FETCH_TRIED;
+				continue;
+			}
+			bss->anqp = wpa_bss_anqp_alloc();
+			if (bss->anqp == NULL)
+				break;
 		}
+		bss->flags |= WPA_BSS_ANQP_FETCH_TRIED;
+		wpa_msg(wpa_s, MSG_INFO, "Starting ANQP fetch for "
+			MACSTR " (HESSID " MACSTR ")",
+			MAC2STR(bss->bssid), MAC2STR(bss->hessid));
+		interworking_anqp_send_req(wpa_s, bss);
 	}
 
-	if (found == 0) {
+	if (wpa_s->interworking_gas_pending)
+		return; /* Wait for the pending queries to complete */
+
 #ifdef CONFIG_HS20
-		if (wpa_s->fetch_osu_info) {
-			if (wpa_s->num_prov_found == 0 &&
-			    wpa_s->fetch_osu_waiting_scan &&
-			    wpa_s->num_osu_scans < 3) {
-				wpa_printf(MSG_DEBUG, "HS 2.0: No OSU providers seen - try to scan again");
-				hs20_start_osu_scan(wpa_s);
-				return;
-			}
-			wpa_printf(MSG_DEBUG, "Interworking: Next icon");
-			hs20_osu_icon_fetch(wpa_s);
+	if (wpa_s->fetch_osu_info) {
+		if (wpa_s->num_prov_found == 0 &&
+		    wpa_s->fetch_osu_waiting_scan &&
+		    wpa_s->num_osu_scans < 3) {
+			wpa_printf(MSG_DEBUG, "HS 2.0: No OSU providers seen - try to scan again");
+			hs20_start_osu_scan(wpa_s);
 			return;
 		}
-#endif /* CONFIG_HS20 */
-		wpa_msg(wpa_s, MSG_INFO, "ANQP fetch completed");
-		wpa_s->fetch_anqp_in_progress = 0;
-		if (wpa_s->network_select)
-			interworking_select_network(wpa_s);
+		wpa_printf(MSG_DEBUG, "Interworking: Next icon");
+		hs20_osu_icon_fetch(wpa_s);
+		return;
 	}
+#endif /* CONFIG_HS20 */
+	wpa_msg(wpa_s, MSG_INFO, "ANQP fetch completed");
+	wpa_s->fetch_anqp_in_progress = 0;
+	if (wpa_s->network_select)
+		interworking_select_network(wpa_s);
 }
 
 
@@ -2768,6 +2874,10 @@ void interworking_start_fetch_anqp(struct wpa_supplicant *wpa_s)
 	dl_list_for_each(bss, &wpa_s->bss, struct wpa_bss, list)
 		bss->flags &= ~WPA_BSS_ANQP_FETCH_TRIED;
 
+	os_memset(wpa_s->interworking_gas_bss, 0,
+		  sizeof(wpa_s->interworking_gas_bss));
+	wpa_s->interworking_gas_pending = 0;
+	wpa_s->interworking_gas_freq = 0;
 	wpa_s->fetch_anqp_in_progress = 1;
 
 	/*
@@ -3015,6 +3125,7 @@ static void interworking_parse_rx_anqp_resp(struct wpa_supplicant *wpa_s,
 			" NAI Realm list", MAC2STR(sa));
 		wpa_hexdump_ascii(MSG_DEBUG, "ANQP: NAI Realm", pos, slen);
 		if (anqp) {
+			interworking_nai_realm_flush(anqp);
 			wpabuf_free(anqp->nai_realm);
 			anqp->nai_realm = wpabuf_alloc_copy(pos, slen);
 		}
@@ -3160,7 +3271,7 @@ void anqp_resp_cb(void *ctx, const u8 *dst, u8 dialog_token,
 	 * may exist for the same AP.
 	 */
 	dl_list_for_each_reverse(tmp, &wpa_s->bss, struct wpa_bss, list) {
-		if (tmp == wpa_s->interworking_gas_bss &&
+		if (interworking_anqp_pending_idx(wpa_s, tmp) >= 0 &&
 		    ether_addr_equal(tmp->bssid, dst)) {
 			bss = tmp;
 			break;
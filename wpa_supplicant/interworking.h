@@ -33,5 +33,6 @@ int interworking_home_sp_cred(struct wpa_supplicant *wpa_s,
 			      struct wpabuf *domain_names);
 int domain_name_list_contains(struct wpabuf *domain_names,
 			      const char *domain, int exact_match);
+void interworking_nai_realm_flush(struct wpa_bss_anqp *anqp);
 
 #endif /* INTERWORKING_H */
@@ -41,6 +41,9 @@ static void usage(void)
 #ifdef CONFIG_DEBUG_FILE
 	       " [-f<debug file>]"
 #endif /* CONFIG_DEBUG_FILE */
+#ifdef CONFIG_DEBUG_RINGBUF
+	       " [-R<ring buffer kB> [-F]]"
+#endif /* CONFIG_DEBUG_RINGBUF */
 	       " \\\n"
 	       "        [-o<override driver>] [-O<override ctrl>] \\\n"
 	       "        [-N -i<ifname> -c<conf> [-C<ctrl>] "
@@ -72,6 +75,10 @@ static void usage(void)
 #ifdef CONFIG_DEBUG_FILE
 	       "  -f = log output to debug file instead of stdout\n"
 #endif /* CONFIG_DEBUG_FILE */
+#ifdef CONFIG_DEBUG_RINGBUF
+	       "  -F = keep ring buffer messages of all debug levels until\n"
+	       "       DEBUG_RING_DUMP (flight recorder mode)\n"
+#endif /* CONFIG_DEBUG_RINGBUF */
 	       "  -g = global ctrl_interface\n"
 	       "  -G = global ctrl_interface group\n"
 	       "  -h = show this help text\n"
@@ -91,6 +98,10 @@ static void usage(void)
 	       "  -p = driver parameters\n"
 	       "  -P = PID file\n"
 	       "  -q = decrease debugging verbosity (-qq even less)\n"
+#ifdef CONFIG_DEBUG_RINGBUF
+	       "  -R = buffer debug messages in an in-memory ring buffer of the\n"
+	       "       given size (kB) and write them out from the event loop\n"
+#endif /* CONFIG_DEBUG_RINGBUF */
 #ifdef CONFIG_DEBUG_SYSLOG
 	       "  -s = log output to syslog instead of stdout\n"
 #endif /* CONFIG_DEBUG_SYSLOG */
@@ -202,7 +213,7 @@ int main(int argc, char *argv[])
 
 	for (;;) {
 		c = getopt(argc, argv,
-			   "b:Bc:C:D:de:f:g:G:hi:I:KLMm:No:O:p:P:qsTtuvW");
+			   "b:Bc:C:D:de:f:Fg:G:hi:I:KLMm:No:O:p:P:qR:sTtuvW");
 		if (c < 0)
 			break;
 		switch (c) {
@@ -283,6 +294,18 @@ int main(int argc, char *argv[])
 		case 'q':
 			params.wpa_debug_level++;
 			break;
+#ifdef CONFIG_DEBUG_RINGBUF
+		case 'R':
+			if (atoi(optarg) <= 0) {
+				usage();
+				goto out;
+			}
+			params.wpa_debug_ring_size = atoi(optarg) * 1024;
+			break;
+		case 'F':
+			params.wpa_debug_ring_flight = 1;
+			break;
+#endif /* CONFIG_DEBUG_RINGBUF */
 #ifdef CONFIG_DEBUG_SYSLOG
 		case 's':
 			params.wpa_debug_syslog++;
@@ -405,6 +428,8 @@ out:
 	os_free(params.pid_file);
 
 	crypto_unload();
+	wpabuf_arena_deinit();
+	os_pool_flush();
 	os_program_deinit();
 
 	return exitcode;
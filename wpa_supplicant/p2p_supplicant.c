@@ -1240,6 +1240,7 @@ static int wpas_p2p_store_persistent_group(struct wpa_supplicant *wpa_s,
 		os_free(s->passphrase);
 		s->passphrase = os_strdup(ssid->passphrase);
 	}
+	wpa_config_ensure_psk(ssid);
 	if (ssid->psk_set) {
 		s->psk_set = 1;
 		os_memcpy(s->psk, ssid->psk, 32);
@@ -7130,6 +7131,7 @@ int wpas_p2p_group_add_persistent(struct wpa_supplicant *wpa_s,
 		return -1;
 
 	params.role_go = 1;
+	wpa_config_ensure_psk(ssid);
 	params.psk_set = ssid->psk_set;
 	if (params.psk_set)
 		os_memcpy(params.psk, ssid->psk, sizeof(params.psk));
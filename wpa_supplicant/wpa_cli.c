@@ -317,6 +317,27 @@ static int wpa_cli_cmd_relog(struct wpa_ctrl *ctrl, int argc, char *argv[])
 }
 
 
+static int wpa_cli_cmd_debug_ring_dump(struct wpa_ctrl *ctrl, int argc,
+				       char *argv[])
+{
+	return wpa_ctrl_command(ctrl, "DEBUG_RING_DUMP");
+}
+
+
+static int wpa_cli_cmd_debug_ring_status(struct wpa_ctrl *ctrl, int argc,
+					 char *argv[])
+{
+	return wpa_ctrl_command(ctrl, "DEBUG_RING_STATUS");
+}
+
+
+static int wpa_cli_cmd_mempool_stats(struct wpa_ctrl *ctrl, int argc,
+				     char *argv[])
+{
+	return wpa_ctrl_command(ctrl, "MEMPOOL_STATS");
+}
+
+
 static int wpa_cli_cmd_note(struct wpa_ctrl *ctrl, int argc, char *argv[])
 {
 	return wpa_cli_cmd(ctrl, "NOTE", 1, argc, argv);
@@ -3089,6 +3110,13 @@ static int wpa_cli_cmd_dpp_bootstrap_gen(struct wpa_ctrl *ctrl, int argc,
 }
 
 
+static int wpa_cli_cmd_dpp_bootstrap_import(struct wpa_ctrl *ctrl, int argc,
+					    char *argv[])
+{
+	return wpa_cli_cmd(ctrl, "DPP_BOOTSTRAP_IMPORT", 1, argc, argv);
+}
+
+
 static int wpa_cli_cmd_dpp_bootstrap_remove(struct wpa_ctrl *ctrl, int argc,
 					    char *argv[])
 {
@@ -3401,6 +3429,15 @@ static const struct wpa_cli_cmd wpa_cli_commands[] = {
 	{ "relog", wpa_cli_cmd_relog, NULL,
 	  cli_cmd_flag_none,
 	  "= re-open log-file (allow rolling logs)" },
+	{ "debug_ring_dump", wpa_cli_cmd_debug_ring_dump, NULL,
+	  cli_cmd_flag_none,
+	  "= write debug ring buffer contents to the log output" },
+	{ "debug_ring_status", wpa_cli_cmd_debug_ring_status, NULL,
+	  cli_cmd_flag_none,
+	  "= show debug ring buffer status" },
+	{ "mempool_stats", wpa_cli_cmd_mempool_stats, NULL,
+	  cli_cmd_flag_none,
+	  "= show memory pool statistics" },
 	{ "note", wpa_cli_cmd_note, NULL,
 	  cli_cmd_flag_none,
 	  "<text> = add a note to wpa_supplicant debug log" },
@@ -4043,6 +4080,9 @@ static const struct wpa_cli_cmd wpa_cli_commands[] = {
 	{ "dpp_bootstrap_gen", wpa_cli_cmd_dpp_bootstrap_gen, NULL,
 	  cli_cmd_flag_sensitive,
 	  "type=<qrcode> [chan=..] [mac=..] [info=..] [curve=..] [key=..] = generate DPP bootstrap information" },
+	{ "dpp_bootstrap_import", wpa_cli_cmd_dpp_bootstrap_import, NULL,
+	  cli_cmd_flag_none,
+	  "<file> = import DPP URIs (one per line) as peer bootstrap information" },
 	{ "dpp_bootstrap_remove", wpa_cli_cmd_dpp_bootstrap_remove, NULL,
 	  cli_cmd_flag_none,
 	  "*|<id> = remove DPP bootstrap information" },
@@ -174,6 +174,7 @@ int wpa_supplicant_set_wpa_none_key(struct wpa_supplicant *wpa_s,
 		return -1;
 	}
 
+	wpa_config_ensure_psk(ssid);
 	if (!ssid->psk_set) {
 		wpa_msg(wpa_s, MSG_INFO, "WPA: No PSK configured for "
 			"WPA-None");
@@ -522,6 +523,24 @@ void wpas_clear_driver_signal_override(struct wpa_supplicant *wpa_s)
 #endif /* CONFIG_TESTING_OPTIONS */
 
 
+static void wpas_derive_pending_psk(void *eloop_ctx, void *timeout_ctx)
+{
+	struct wpa_supplicant *wpa_s = eloop_ctx;
+	struct wpa_ssid *ssid;
+
+	for (ssid = wpa_s->conf->ssid; ssid; ssid = ssid->next) {
+		if (!ssid->psk_pending)
+			continue;
+		wpa_config_ensure_psk(ssid);
+		/* Derive one PSK at a time to allow other events to be
+		 * processed in between */
+		eloop_register_timeout(0, 0, wpas_derive_pending_psk, wpa_s,
+				       NULL);
+		return;
+	}
+}
+
+
 static void wpa_supplicant_cleanup(struct wpa_supplicant *wpa_s)
 {
 	int i;
@@ -609,6 +628,7 @@ static void wpa_supplicant_cleanup(struct wpa_supplicant *wpa_s)
 
 	eloop_cancel_timeout(wpas_network_reenabled, wpa_s, NULL);
 	eloop_cancel_timeout(wpas_clear_disabled_interface, wpa_s, NULL);
+	eloop_cancel_timeout(wpas_derive_pending_psk, wpa_s, NULL);
 
 	wpas_wps_deinit(wpa_s);
 
@@ -1230,6 +1250,8 @@ int wpa_supplicant_reload_configuration(struct wpa_supplicant *wpa_s)
 	wpa_s->conf = conf;
 	if (old_ap_scan != wpa_s->conf->ap_scan)
 		wpas_notify_ap_scan_changed(wpa_s);
+	eloop_cancel_timeout(wpas_derive_pending_psk, wpa_s, NULL);
+	eloop_register_timeout(0, 0, wpas_derive_pending_psk, wpa_s, NULL);
 
 	if (reconf_ctrl)
 		wpa_s->ctrl_iface = wpa_supplicant_ctrl_iface_init(wpa_s);
@@ -1379,6 +1401,7 @@ static int wpa_supplicant_get_psk(struct wpa_supplicant *wpa_s,
 				  struct wpa_bss *bss, struct wpa_ssid *ssid,
 				  u8 *psk)
 {
+	wpa_config_ensure_psk(ssid);
 	if (ssid->psk_set) {
 		wpa_hexdump_key(MSG_MSGDUMP, "PSK (set in config)",
 				ssid->psk, PMK_LEN);
@@ -7112,6 +7135,8 @@ static int wpa_supplicant_init_iface(struct wpa_supplicant *wpa_s,
 				   wpa_s->confanother);
 			return -1;
 		}
+		eloop_register_timeout(0, 0, wpas_derive_pending_psk, wpa_s,
+				       NULL);
 
 		/*
 		 * Override ctrl_interface and driver_param if set on command
@@ -7851,6 +7876,24 @@ static void wpas_periodic(void *eloop_ctx, void *timeout_ctx)
 }
 
 
+#ifdef CONFIG_DEBUG_RINGBUF
+
+#ifndef WPA_SUPPLICANT_DEBUG_RING_FLUSH_MS
+#define WPA_SUPPLICANT_DEBUG_RING_FLUSH_MS 1000
+#endif /* WPA_SUPPLICANT_DEBUG_RING_FLUSH_MS */
+
+static void wpas_debug_ring_flush(void *eloop_ctx, void *timeout_ctx)
+{
+	struct wpa_global *global = eloop_ctx;
+
+	eloop_register_timeout(0, WPA_SUPPLICANT_DEBUG_RING_FLUSH_MS * 1000,
+			       wpas_debug_ring_flush, global, NULL);
+	wpa_debug_ring_flush();
+}
+
+#endif /* CONFIG_DEBUG_RINGBUF */
+
+
 /**
  * wpa_supplicant_init - Initialize %wpa_supplicant
  * @params: Parameters for %wpa_supplicant
@@ -7893,6 +7936,14 @@ struct wpa_global * wpa_supplicant_init(struct wpa_params *params)
 			return NULL;
 		}
 	}
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (params->wpa_debug_ring_size &&
+	    wpa_debug_ring_init(params->wpa_debug_ring_size,
+				params->wpa_debug_ring_flight)) {
+		wpa_printf(MSG_ERROR, "Failed to enable debug ring buffer");
+		return NULL;
+	}
+#endif /* CONFIG_DEBUG_RINGBUF */
 
 	ret = eap_register_methods();
 	if (ret) {
@@ -8036,6 +8087,12 @@ struct wpa_global * wpa_supplicant_init(struct wpa_params *params)
 
 	eloop_register_timeout(WPA_SUPPLICANT_CLEANUP_INTERVAL, 0,
 			       wpas_periodic, global, NULL);
+#ifdef CONFIG_DEBUG_RINGBUF
+	if (params->wpa_debug_ring_size && !params->wpa_debug_ring_flight)
+		eloop_register_timeout(0,
+				       WPA_SUPPLICANT_DEBUG_RING_FLUSH_MS * 1000,
+				       wpas_debug_ring_flush, global, NULL);
+#endif /* CONFIG_DEBUG_RINGBUF */
 
 	return global;
 }
@@ -8095,6 +8152,9 @@ void wpa_supplicant_deinit(struct wpa_global *global)
 		return;
 
 	eloop_cancel_timeout(wpas_periodic, global, NULL);
+#ifdef CONFIG_DEBUG_RINGBUF
+	eloop_cancel_timeout(wpas_debug_ring_flush, global, NULL);
+#endif /* CONFIG_DEBUG_RINGBUF */
 
 #ifdef CONFIG_WIFI_DISPLAY
 	wifi_display_deinit(global);
@@ -8144,6 +8204,9 @@ void wpa_supplicant_deinit(struct wpa_global *global)
 	os_free(global->add_psk);
 
 	os_free(global);
+#ifdef CONFIG_DEBUG_RINGBUF
+	wpa_debug_ring_deinit();
+#endif /* CONFIG_DEBUG_RINGBUF */
 	wpa_debug_close_syslog();
 	wpa_debug_close_file();
 	wpa_debug_close_linux_tracing();
@@ -8586,6 +8649,7 @@ int wpas_network_disabled(struct wpa_supplicant *wpa_s, struct wpa_ssid *ssid)
 #endif /* CONFIG_WEP */
 
 	if (wpa_key_mgmt_wpa_psk(ssid->key_mgmt) && !ssid->psk_set &&
+	    !ssid->psk_pending &&
 	    (!ssid->passphrase || ssid->ssid_len != 0) && !ssid->ext_psk &&
 	    !(wpa_key_mgmt_sae(ssid->key_mgmt) && ssid->sae_password) &&
 	    !ssid->mem_only_psk)
@@ -210,6 +210,18 @@ struct wpa_params {
 	 */
 	int wpa_debug_tracing;
 
+	/**
+	 * wpa_debug_ring_size - Size of the debug ring buffer in octets
+	 *
+	 * 0 = write debug messages out directly (default)
+	 */
+	size_t wpa_debug_ring_size;
+
+	/**
+	 * wpa_debug_ring_flight - Keep debug ring buffer records until dumped
+	 */
+	int wpa_debug_ring_flight;
+
 	/**
 	 * override_driver - Optional driver parameter override
 	 *
@@ -1230,7 +1242,14 @@ struct wpa_supplicant {
 	unsigned int fetch_osu_info:1;
 	unsigned int fetch_osu_waiting_scan:1;
 	unsigned int fetch_osu_icon_in_progress:1;
-	struct wpa_bss *interworking_gas_bss;
+	/* ANQP queries of the ongoing ANQP fetch that are waiting for a
+	 * response; the BSS pointers are only used for comparison since the
+	 * entries may have been removed. */
+#define INTERWORKING_MAX_PENDING_ANQP 4
+	struct wpa_bss *interworking_gas_bss[INTERWORKING_MAX_PENDING_ANQP];
+	u8 interworking_gas_bssid[INTERWORKING_MAX_PENDING_ANQP][ETH_ALEN];
+	unsigned int interworking_gas_pending;
+	int interworking_gas_freq; /* channel of the last queued query */
 	unsigned int osu_icon_id;
 	struct dl_list icon_head; /* struct icon_entry */
 	struct osu_provider *osu_prov;
@@ -334,6 +334,7 @@ static void wpas_wps_remove_dup_network(struct wpa_supplicant *wpa_s,
 				continue;
 			}
 
+			wpa_config_ensure_psk(ssid);
 			if (new_ssid->psk_set &&
 			    (!ssid->psk_set ||
 			     os_memcmp(new_ssid->psk, ssid->psk, 32) != 0)) {